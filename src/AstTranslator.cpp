@@ -33,6 +33,7 @@
 #include "IODirectives.h"
 #include "LogStatement.h"
 #include "PrecedenceGraph.h"
+#include "ProfileUse.h"
 #include "RamCondition.h"
 #include "RamNode.h"
 #include "RamOperation.h"
@@ -48,6 +49,7 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <fstream>
 #include <functional>
@@ -93,9 +95,9 @@ void makeIODirective(IODirectives& ioDirective, const AstRelation* rel, const st
     }
 
     // load intermediate relations from correct files
-    if (ioDirective.getIOType() == "file") {
+    if (ioDirective.getIOType() == "file" || ioDirective.getIOType() == "binary") {
         // all intermediate relations are given the default delimiter and have no headers
-        if (isIntermediate) {
+        if (isIntermediate && ioDirective.getIOType() == "file") {
             ioDirective.set("intermediate", "true");
             ioDirective.set("delimiter", "\t");
             ioDirective.set("headers", "false");
@@ -103,11 +105,12 @@ void makeIODirective(IODirectives& ioDirective, const AstRelation* rel, const st
 
         // set filename by relation if not given, or if relation is intermediate
         if (!ioDirective.has("filename") || isIntermediate) {
-            ioDirective.setFileName(ioDirective.getRelationName() + fileExt);
+            const bool isBinary = ioDirective.getIOType() == "binary" && !isIntermediate;
+            ioDirective.setFileName(ioDirective.getRelationName() + (isBinary ? ".bin" : fileExt));
         }
 
         // if filename is not an absolute path, concat with cmd line facts directory
-        if (ioDirective.getIOType() == "file" && ioDirective.getFileName().front() != '/') {
+        if (ioDirective.getFileName().front() != '/') {
             ioDirective.setFileName(filePath + "/" + ioDirective.getFileName());
         }
     }
@@ -476,6 +479,97 @@ std::unique_ptr<RamValue> translateValue(const AstArgument* arg, const ValueInde
 std::unique_ptr<RamValue> translateValue(const AstArgument& arg, const ValueIndex& index = ValueIndex()) {
     return translateValue(&arg, index);
 }
+
+/**
+ * Computes an order of the atoms of a clause from the sizes of relations in a profile of a
+ * previous run. Atoms are picked greedily by their estimated number of matching tuples, which
+ * assumes the tuples of a relation to be spread uniformly, such that every bound argument
+ * reduces the matches by the same factor.
+ *
+ * @return the new order of atoms, or an empty order if the source order is kept
+ */
+std::vector<unsigned int> getProfileGuidedOrder(const AstClause& clause, const ProfileUse& profile) {
+    const auto& atoms = clause.getAtoms();
+    if (atoms.size() < 2) {
+        return {};
+    }
+
+    // get the profiled sizes of the atoms; delta relations hold the tuples of an iteration
+    static const std::string deltaPrefix = "@delta_";
+    std::vector<double> sizes;
+    for (const AstAtom* atom : atoms) {
+        std::string relName = getRelationName(atom->getName());
+        if (relName.compare(0, deltaPrefix.size(), deltaPrefix) == 0) {
+            relName = relName.substr(deltaPrefix.size());
+            if (!profile.hasRelationSize(relName)) {
+                return {};
+            }
+            sizes.push_back(profile.getDeltaSize(relName));
+        } else {
+            // other temporary relations are not profiled
+            if (!profile.hasRelationSize(relName)) {
+                return {};
+            }
+            sizes.push_back(profile.getRelationSize(relName));
+        }
+    }
+
+    // estimate the number of matching tuples of an atom given the bound variables
+    std::set<std::string> bound;
+    auto estimate = [&](size_t i) {
+        const AstAtom* atom = atoms[i];
+        size_t numFree = 0;
+        for (const AstArgument* arg : atom->getArguments()) {
+            if (dynamic_cast<const AstConstant*>(arg)) {
+                continue;
+            }
+            if (const auto* var = dynamic_cast<const AstVariable*>(arg)) {
+                if (bound.find(var->getName()) != bound.end()) {
+                    continue;
+                }
+            }
+            ++numFree;
+        }
+        if (atom->argSize() == 0) {
+            return std::min(sizes[i], 1.0);
+        }
+        return std::pow(sizes[i], static_cast<double>(numFree) / atom->argSize());
+    };
+
+    // pick the atom with the fewest matches, preferring the source order
+    std::vector<unsigned int> order;
+    std::vector<bool> placed(atoms.size(), false);
+    while (order.size() < atoms.size()) {
+        size_t best = atoms.size();
+        double bestEstimate = 0;
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            if (placed[i]) {
+                continue;
+            }
+            double cur = estimate(i);
+            if (best == atoms.size() || cur < bestEstimate) {
+                best = i;
+                bestEstimate = cur;
+            }
+        }
+        placed[best] = true;
+        order.push_back(best);
+        for (const AstArgument* arg : atoms[best]->getArguments()) {
+            // variables of aggregates are local to the aggregate
+            if (!dynamic_cast<const AstAggregator*>(arg)) {
+                visitDepthFirst(*arg, [&](const AstVariable& var) { bound.insert(var.getName()); });
+            }
+        }
+    }
+
+    // keep the source order if nothing changes
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (order[i] != i) {
+            return order;
+        }
+    }
+    return {};
+}
 }  // namespace
 
 /** generate RAM code for a clause */
@@ -506,6 +600,20 @@ std::unique_ptr<RamStatement> AstTranslator::translateClause(const AstClause& cl
         return translateClause(*copy, program, typeEnv, originalClause, version, false, hashset);
     }
 
+    // order the atoms by the sizes of relations in a previous run, unless the order is strict
+    if (!clause.hasFixedExecutionPlan()) {
+        if (const ProfileUse* profile = ProfileUse::getInstance()) {
+            std::vector<unsigned int> newOrder = getProfileGuidedOrder(clause, *profile);
+            if (!newOrder.empty()) {
+                std::unique_ptr<AstClause> copy(clause.clone());
+                copy->reorderAtoms(newOrder);
+                copy->clearExecutionPlan();
+                copy->setFixedExecutionPlan();
+                return translateClause(*copy, program, typeEnv, originalClause, version, ret, hashset);
+            }
+        }
+    }
+
     // get extract some details
     const AstAtom& head = *clause.getHead();
 
@@ -1033,10 +1141,47 @@ void nameUnnamedVariables(AstClause* clause) {
 }
 }  // namespace
 
+/** generate RAM code propagating tuples added outside of an SCC into a relation of the SCC */
+std::unique_ptr<RamStatement> AstTranslator::translateIncrementalClauses(const AstRelation& rel,
+        const std::set<const AstRelation*>& scc, const AstProgram* program, const TypeEnvironment& typeEnv) {
+    std::unique_ptr<RamStatement> res;
+
+    for (AstClause* cl : rel.getClauses()) {
+        // each atom of another SCC results in a version reading the tuples added to its relation
+        const auto& atoms = cl->getAtoms();
+        for (size_t j = 0; j < atoms.size(); ++j) {
+            const AstRelation* atomRelation = getAtomRelation(atoms[j], program);
+            if (scc.count(atomRelation) > 0) {
+                continue;
+            }
+
+            // modify the processed rule to read the added tuples and write to the incremental relation
+            std::unique_ptr<AstClause> r1(cl->clone());
+            r1->getHead()->setName("@inc_" + getRelationName(rel.getName()));
+            r1->getAtoms()[j]->setName("@inc_" + getRelationName(atomRelation->getName()));
+            r1->addToBody(std::make_unique<AstNegation>(std::unique_ptr<AstAtom>(cl->getHead()->clone())));
+            nameUnnamedVariables(r1.get());
+
+            std::unique_ptr<RamStatement> rule =
+                    translateClause(*r1, program, &typeEnv, *cl, 0, false, rel.isHashset());
+
+            // add debug info
+            std::ostringstream ds;
+            ds << toString(*cl) << "\nin file ";
+            ds << cl->getSrcLoc();
+            rule = std::make_unique<RamDebugInfo>(std::move(rule), ds.str());
+
+            appendStmt(res, std::move(rule));
+        }
+    }
+
+    return res;
+}
+
 /** generate RAM code for recursive relations in a strongly-connected component */
 std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
         const std::set<const AstRelation*>& scc, const AstProgram* program,
-        const RecursiveClauses* recursiveClauses, const TypeEnvironment& typeEnv) {
+        const RecursiveClauses* recursiveClauses, const TypeEnvironment& typeEnv, bool incremental) {
     // initialize sections
     std::unique_ptr<RamStatement> preamble;
     std::unique_ptr<RamSequence> updateTable(new RamSequence());
@@ -1048,6 +1193,7 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
     std::map<const AstRelation*, std::unique_ptr<RamRelation>> rrel;
     std::map<const AstRelation*, std::unique_ptr<RamRelation>> relDelta;
     std::map<const AstRelation*, std::unique_ptr<RamRelation>> relNew;
+    std::map<const AstRelation*, std::unique_ptr<RamRelation>> relInc;
 
     /* Compute non-recursive clauses for relations in scc and push
        the results in their delta tables. */
@@ -1066,14 +1212,26 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
         modifiedIdMap[relDelta[rel]->getName()] = relName;
         modifiedIdMap[relNew[rel]->getName()] = relName;
 
+        /* the incremental table holds the tuples added since the last evaluation */
+        if (incremental) {
+            relInc[rel] =
+                    getRamRelation(rel, &typeEnv, "inc_" + relName, rel->getArity(), true, rel->isHashset());
+            modifiedIdMap[relInc[rel]->getName()] = relName;
+        }
+
         /* create update statements for fixpoint (even iteration) */
-        appendStmt(updateRelTable,
-                std::make_unique<RamSequence>(
-                        std::make_unique<RamMerge>(std::unique_ptr<RamRelation>(rrel[rel]->clone()),
-                                std::unique_ptr<RamRelation>(relNew[rel]->clone())),
-                        std::make_unique<RamSwap>(std::unique_ptr<RamRelation>(relDelta[rel]->clone()),
-                                std::unique_ptr<RamRelation>(relNew[rel]->clone())),
-                        std::make_unique<RamClear>(std::unique_ptr<RamRelation>(relNew[rel]->clone()))));
+        std::unique_ptr<RamSequence> updateRel(
+                new RamSequence(std::make_unique<RamMerge>(std::unique_ptr<RamRelation>(rrel[rel]->clone()),
+                        std::unique_ptr<RamRelation>(relNew[rel]->clone()))));
+        if (incremental) {
+            /* record derived tuples as added since the last evaluation */
+            updateRel->add(std::make_unique<RamMerge>(std::unique_ptr<RamRelation>(relInc[rel]->clone()),
+                    std::unique_ptr<RamRelation>(relNew[rel]->clone())));
+        }
+        updateRel->add(std::make_unique<RamSwap>(std::unique_ptr<RamRelation>(relDelta[rel]->clone()),
+                std::unique_ptr<RamRelation>(relNew[rel]->clone())));
+        updateRel->add(std::make_unique<RamClear>(std::unique_ptr<RamRelation>(relNew[rel]->clone())));
+        appendStmt(updateRelTable, std::move(updateRel));
 
         /* measure update time for each relation */
         if (Global::config().has("profile")) {
@@ -1087,12 +1245,27 @@ std::unique_ptr<RamStatement> AstTranslator::translateRecursiveRelation(
                         std::make_unique<RamDrop>(std::unique_ptr<RamRelation>(relDelta[rel]->clone())),
                         std::make_unique<RamDrop>(std::unique_ptr<RamRelation>(relNew[rel]->clone()))));
 
-        /* Generate code for non-recursive part of relation */
-        appendStmt(preamble, translateNonRecursiveRelation(*rel, program, recursiveClauses, typeEnv));
+        if (incremental) {
+            /* Generate code for the tuples derived from tuples added to other SCCs */
+            appendStmt(preamble, translateIncrementalClauses(*rel, scc, program, typeEnv));
+
+            /* Seed the fixpoint with all tuples added to the relation */
+            appendStmt(preamble, std::make_unique<RamSequence>(
+                                         std::make_unique<RamMerge>(
+                                                 std::unique_ptr<RamRelation>(rrel[rel]->clone()),
+                                                 std::unique_ptr<RamRelation>(relInc[rel]->clone())),
+                                         std::make_unique<RamMerge>(
+                                                 std::unique_ptr<RamRelation>(relDelta[rel]->clone()),
+                                                 std::unique_ptr<RamRelation>(relInc[rel]->clone()))));
+        } else {
+            /* Generate code for non-recursive part of relation */
+            appendStmt(preamble, translateNonRecursiveRelation(*rel, program, recursiveClauses, typeEnv));
 
-        /* Generate merge operation for temp tables */
-        appendStmt(preamble, std::make_unique<RamMerge>(std::unique_ptr<RamRelation>(relDelta[rel]->clone()),
-                                     std::unique_ptr<RamRelation>(rrel[rel]->clone())));
+            /* Generate merge operation for temp tables */
+            appendStmt(preamble,
+                    std::make_unique<RamMerge>(std::unique_ptr<RamRelation>(relDelta[rel]->clone()),
+                            std::unique_ptr<RamRelation>(rrel[rel]->clone())));
+        }
 
         /* Add update operations of relations to parallel statements */
         updateTable->add(std::move(updateRelTable));
@@ -1284,7 +1457,7 @@ std::unique_ptr<RamStatement> AstTranslator::makeSubproofSubroutine(
 }
 
 /** translates the given datalog program into an equivalent RAM program  */
-std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslationUnit& translationUnit) {
+std::unique_ptr<RamProgram> AstTranslator::translateProgram(AstTranslationUnit& translationUnit) {
     // obtain type environment from analysis
     const TypeEnvironment& typeEnv =
             translationUnit.getAnalysis<TypeEnvironmentAnalysis>()->getTypeEnvironment();
@@ -1391,6 +1564,37 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
     };
 #endif
 
+    // incremental evaluation is restricted to monotone programs, in which added tuples never invalidate
+    // previously derived tuples; otherwise runIncremental() re-evaluates the whole program
+    bool incremental = Global::config().has("incremental");
+    const auto& disableIncremental = [&](const std::string& construct, const SrcLocation& loc) {
+        if (incremental) {
+            translationUnit.getErrorReport().addWarning("Incremental evaluation disabled by " + construct +
+                                                                "; tuples are re-evaluated on each run",
+                    loc);
+            incremental = false;
+        }
+    };
+    visitDepthFirst(*translationUnit.getProgram(),
+            [&](const AstNegation& neg) { disableIncremental("negation", neg.getSrcLoc()); });
+    visitDepthFirst(*translationUnit.getProgram(),
+            [&](const AstAggregator& agg) { disableIncremental("aggregate", agg.getSrcLoc()); });
+    for (const AstRelation* relation : translationUnit.getProgram()->getRelations()) {
+        if (relation->isEqRel()) {
+            disableIncremental("equivalence relation " + toString(relation->getName()), relation->getSrcLoc());
+        }
+    }
+
+    // a function to refer to the relation holding the tuples added since the last evaluation
+    const auto& makeRamIncRelation = [&](const AstRelation* relation) {
+        return getRamRelation(relation, &typeEnv, "inc_" + getRelationName(relation->getName()),
+                relation->getArity(), true, relation->isHashset());
+    };
+
+    // the statements propagating added tuples through all SCCs, and clearing the added tuples afterwards
+    std::unique_ptr<RamStatement> incrementalBody;
+    std::unique_ptr<RamStatement> incrementalClear;
+
     // maintain the index of the SCC within the topological order
     size_t indexOfScc = 0;
 
@@ -1425,6 +1629,12 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
                 makeRamCreate(current, relation, "delta_");
                 makeRamCreate(current, relation, "new_");
             }
+            // create the relation for tuples added between evaluations, discarding tuples added before
+            if (incremental) {
+                makeRamCreate(current, relation, "inc_");
+                appendStmt(current, std::make_unique<RamClear>(makeRamIncRelation(relation)));
+                appendStmt(incrementalClear, std::make_unique<RamClear>(makeRamIncRelation(relation)));
+            }
         }
 
 #ifdef USE_MPI
@@ -1466,6 +1676,23 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
                                          allInterns, translationUnit.getProgram(), recursiveClauses, typeEnv);
         appendStmt(current, std::move(bodyStatement));
 
+        // propagate the tuples added to preceding SCCs through the current SCC
+        if (incremental) {
+            if (isRecursive) {
+                appendStmt(incrementalBody, translateRecursiveRelation(allInterns, translationUnit.getProgram(),
+                                                    recursiveClauses, typeEnv, true));
+            } else {
+                const AstRelation* relation = *allInterns.begin();
+                appendStmt(incrementalBody, translateIncrementalClauses(*relation, allInterns,
+                                                    translationUnit.getProgram(), typeEnv));
+                appendStmt(incrementalBody,
+                        std::make_unique<RamMerge>(getRamRelation(relation, &typeEnv,
+                                                           getRelationName(relation->getName()),
+                                                           relation->getArity(), false, relation->isHashset()),
+                                makeRamIncRelation(relation)));
+            }
+        }
+
         // print the size of all printsize relations in the current SCC
         for (const auto& relation : allInterns) {
             if (relation->isPrintSize()) {
@@ -1504,8 +1731,9 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
             }
         }
 
-        // if provenance is not enabled...
-        if (!Global::config().has("provenance")) {
+        // if provenance is not enabled and relations need not be kept for incremental evaluation, which
+        // re-evaluates the program from its input relations if the program is not monotone...
+        if (!Global::config().has("provenance") && !Global::config().has("incremental")) {
             // if a communication engine is enabled...
             if (Global::config().has("engine")) {
                 // drop all internal relations
@@ -1599,6 +1827,12 @@ std::unique_ptr<RamProgram> AstTranslator::translateProgram(const AstTranslation
     // done for main prog
     std::unique_ptr<RamProgram> prog(new RamProgram(std::move(res)));
 
+    // add the incremental program
+    if (incremental) {
+        appendStmt(incrementalBody, std::move(incrementalClear));
+        prog->setIncremental(std::move(incrementalBody));
+    }
+
     // add subroutines for each clause
     if (Global::config().has("provenance")) {
         visitDepthFirst(translationUnit.getProgram()->getRelations(), [&](const AstClause& clause) {
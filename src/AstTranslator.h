@@ -60,17 +60,31 @@ public:
             const AstProgram* program, const RecursiveClauses* recursiveClauses,
             const TypeEnvironment& typeEnv);
 
-    /** generate RAM code for recursive relations in a strongly-connected component */
+    /**
+     * Generates RAM code deriving the tuples of the given relation which depend on at least one
+     * tuple added to a relation outside of the SCC since the last evaluation. The derived tuples
+     * not yet contained in the relation are stored in its incremental relation.
+     *
+     * @return a corresponding statement or null if no clause depends on another SCC.
+     */
+    std::unique_ptr<RamStatement> translateIncrementalClauses(const AstRelation& rel,
+            const std::set<const AstRelation*>& scc, const AstProgram* program,
+            const TypeEnvironment& typeEnv);
+
+    /**
+     * generate RAM code for recursive relations in a strongly-connected component; in incremental
+     * mode, the fixpoint is seeded with the tuples added to the SCC since the last evaluation
+     */
     std::unique_ptr<RamStatement> translateRecursiveRelation(const std::set<const AstRelation*>& scc,
             const AstProgram* program, const RecursiveClauses* recursiveClauses,
-            const TypeEnvironment& typeEnv);
+            const TypeEnvironment& typeEnv, bool incremental = false);
 
     /** generate RAM code for subroutine to get subproofs */
     std::unique_ptr<RamStatement> makeSubproofSubroutine(
             const AstClause& clause, const AstProgram* program, const TypeEnvironment& typeEnv);
 
     /** Translate AST to RamProgram */
-    std::unique_ptr<RamProgram> translateProgram(const AstTranslationUnit& translationUnit);
+    std::unique_ptr<RamProgram> translateProgram(AstTranslationUnit& translationUnit);
 
     /** translates AST to translation unit  */
     std::unique_ptr<RamTranslationUnit> translateUnit(AstTranslationUnit& tu);
@@ -20,12 +20,23 @@
 #include "ParallelUtils.h"
 #include "Util.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace souffle {
 
 namespace detail {
@@ -196,6 +207,157 @@ struct binary_search : public search_strategy {
     }
 };
 
+/**
+ * A trait providing the column by which tuples are ordered first by a comparator,
+ * or -1 if the comparator does not expose it as member first_column.
+ */
+template <typename Comp, typename = void>
+struct leading_column {
+    enum { value = -1 };
+};
+
+template <typename Comp>
+struct leading_column<Comp, decltype(void(Comp::first_column))> {
+    enum { value = Comp::first_column };
+};
+
+/**
+ * A trait determining whether keys are tuples of up to four 32-bit integers whose
+ * leading column according to the given comparator may be compared using SIMD instructions.
+ */
+template <typename Key, typename Comp, typename = void>
+struct is_simd_searchable : public std::false_type {};
+
+template <typename Key, typename Comp>
+struct is_simd_searchable<Key, Comp, decltype(void(Key::arity), void(sizeof(typename Key::value_type)))>
+        : public std::integral_constant<bool,
+                  std::is_same<typename Key::value_type, int32_t>::value && Key::arity >= 1 &&
+                          Key::arity <= 4 && sizeof(Key) == Key::arity * sizeof(int32_t) &&
+                          leading_column<Comp>::value >= 0 && leading_column<Comp>::value < Key::arity> {};
+
+/**
+ * Counts the tuples of the given array whose value in the given column is less than
+ * the given value. Tuples consist of Arity consecutive 32-bit integers. The array is
+ * processed in blocks of integers, masking those not belonging to the column.
+ *
+ * @param data .. the first component of the first tuple
+ * @param num  .. the number of tuples
+ */
+template <unsigned Arity, unsigned Column>
+inline std::size_t count_less(const int32_t* data, std::size_t num, int32_t value) {
+    const std::size_t length = num * Arity;
+    std::size_t res = 0;
+    std::size_t i = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    // the mask of block j is repeated every Arity blocks
+    auto inColumn = [](std::size_t lane) { return (lane % Arity == Column) ? -1 : 0; };
+#endif
+
+#if defined(__AVX2__)
+    __m256i masks[Arity];
+    for (unsigned j = 0; j < Arity; ++j) {
+        masks[j] = _mm256_setr_epi32(inColumn(8 * j), inColumn(8 * j + 1), inColumn(8 * j + 2),
+                inColumn(8 * j + 3), inColumn(8 * j + 4), inColumn(8 * j + 5), inColumn(8 * j + 6),
+                inColumn(8 * j + 7));
+    }
+    const __m256i key = _mm256_set1_epi32(value);
+    for (unsigned j = 0; i + 8 <= length; i += 8, j = (j + 1 == Arity) ? 0 : j + 1) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i less = _mm256_and_si256(_mm256_cmpgt_epi32(key, block), masks[j]);
+        res += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+    }
+#elif defined(__SSE2__)
+    __m128i masks[Arity];
+    for (unsigned j = 0; j < Arity; ++j) {
+        masks[j] = _mm_setr_epi32(
+                inColumn(4 * j), inColumn(4 * j + 1), inColumn(4 * j + 2), inColumn(4 * j + 3));
+    }
+    const __m128i key = _mm_set1_epi32(value);
+    for (unsigned j = 0; i + 4 <= length; i += 4, j = (j + 1 == Arity) ? 0 : j + 1) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i less = _mm_and_si128(_mm_cmpgt_epi32(key, block), masks[j]);
+        res += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(less)));
+    }
+#endif
+
+    // scalar processing of the remaining integers
+    for (; i < length; ++i) {
+        if (i % Arity == Column && data[i] < value) {
+            ++res;
+        }
+    }
+    return res;
+}
+
+/**
+ * A search strategy for b-trees of tuples of up to four 32-bit integers. The position
+ * of a key is narrowed down by comparing the leading column of all keys of a node at
+ * once, utilizing AVX2 or SSE2 instructions if available. Only keys sharing the leading
+ * value of the searched key are compared using the comparator, utilizing a binary search.
+ * For other keys and comparators, it falls back to a binary search.
+ */
+struct simd_search : public search_strategy {
+    /**
+     * Required user-defined default constructor.
+     */
+    simd_search() {}
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * is not less than the given key.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    inline Iter operator()(const Key& k, Iter a, Iter b, Comp& comp) const {
+        return lower_bound(k, a, b, comp);
+    }
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * is not less than the given key.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    inline Iter lower_bound(const Key& k, Iter a, Iter b, Comp& comp) const {
+        auto range = leading_equal_range(k, a, b, comp, is_simd_searchable<Key, Comp>());
+        return binary_search().lower_bound(k, range.first, range.second, comp);
+    }
+
+    /**
+     * Obtains a reference to the first element in the given range that
+     * such that the given key is less than the referenced element.
+     */
+    template <typename Key, typename Iter, typename Comp>
+    inline Iter upper_bound(const Key& k, Iter a, Iter b, Comp& comp) const {
+        auto range = leading_equal_range(k, a, b, comp, is_simd_searchable<Key, Comp>());
+        return binary_search().upper_bound(k, range.first, range.second, comp);
+    }
+
+private:
+    // narrows the given range down to the elements sharing the leading column of the given key
+    template <typename Key, typename Iter, typename Comp>
+    inline std::pair<Iter, Iter> leading_equal_range(
+            const Key& k, Iter a, Iter b, Comp&, std::true_type) const {
+        if (a == b) return std::make_pair(a, b);
+        const unsigned arity = Key::arity;
+        const unsigned column = leading_column<Comp>::value;
+        const int32_t value = k[column];
+        const int32_t* data = reinterpret_cast<const int32_t*>(&*a);
+        Iter first = a + count_less<arity, column>(data, b - a, value);
+        if (value == std::numeric_limits<int32_t>::max()) {
+            return std::make_pair(first, b);
+        }
+        data += (first - a) * arity;
+        return std::make_pair(first, first + count_less<arity, column>(data, b - first, value + 1));
+    }
+
+    // the fallback for keys or comparators not supporting SIMD comparisons
+    template <typename Key, typename Iter, typename Comp>
+    inline std::pair<Iter, Iter> leading_equal_range(
+            const Key&, Iter a, Iter b, Comp&, std::false_type) const {
+        return std::make_pair(a, b);
+    }
+};
+
 // ---------- search strategies selection --------------
 
 /**
@@ -209,6 +371,7 @@ struct strategy_selection {
 
 struct linear : public strategy_selection<linear_search> {};
 struct binary : public strategy_selection<binary_search> {};
+struct simd : public strategy_selection<simd_search> {};
 
 // by default every key utilizes binary search
 template <typename Key>
@@ -367,7 +530,12 @@ private:
             /**
              * The actual number of keys/node corrected by functional requirements.
              */
-            maxKeys = (desiredNumKeys > 3) ? desiredNumKeys : 3
+            maxKeys = (desiredNumKeys > 3) ? desiredNumKeys : 3,
+
+            /**
+             * The number of keys/node below which nodes are re-balanced after an erase.
+             */
+            minKeys = (maxKeys - 1) / 2
         };
 
         // the keys stored in this node
@@ -815,6 +983,130 @@ private:
         }
 
     public:
+        /**
+         * Evens out the number of keys of the children at positions pos and pos + 1
+         * by moving keys through the separating key of this inner node (for internal
+         * use only).
+         *
+         * @param pos .. the position of the left child
+         */
+        void balance_children(size_type pos) {
+            node* left = getChild(pos);
+            node* right = getChild(pos + 1);
+#ifdef IS_PARALLEL
+            assert(this->lock.is_write_locked());
+            assert(left->lock.is_write_locked() && right->lock.is_write_locked());
+#endif
+
+            if (left->numElements < right->numElements) {
+                // move keys from the right to the left node
+                size_type num = (right->numElements - left->numElements) / 2;
+                assert(num > 0);
+
+                left->keys[left->numElements] = keys[pos];
+                for (size_type i = 0; i + 1 < num; ++i) {
+                    left->keys[left->numElements + 1 + i] = right->keys[i];
+                }
+                keys[pos] = right->keys[num - 1];
+                for (size_type i = num; i < right->numElements; ++i) {
+                    right->keys[i - num] = right->keys[i];
+                }
+
+                // move child pointers
+                if (left->inner) {
+                    for (size_type i = 0; i < num; ++i) {
+                        node* child = right->getChildren()[i];
+                        left->getChildren()[left->numElements + 1 + i] = child;
+                        child->parent = left;
+                        child->position = left->numElements + 1 + i;
+                    }
+                    for (size_type i = num; i <= right->numElements; ++i) {
+                        node* child = right->getChildren()[i];
+                        right->getChildren()[i - num] = child;
+                        child->position = i - num;
+                    }
+                }
+
+                left->numElements += num;
+                right->numElements -= num;
+            } else {
+                // move keys from the left to the right node
+                size_type num = (left->numElements - right->numElements) / 2;
+                assert(num > 0);
+
+                for (size_type i = right->numElements; i > 0; --i) {
+                    right->keys[i - 1 + num] = right->keys[i - 1];
+                }
+                right->keys[num - 1] = keys[pos];
+                for (size_type i = 0; i + 1 < num; ++i) {
+                    right->keys[i] = left->keys[left->numElements - num + 1 + i];
+                }
+                keys[pos] = left->keys[left->numElements - num];
+
+                // move child pointers
+                if (left->inner) {
+                    for (size_type i = right->numElements + 1; i > 0; --i) {
+                        node* child = right->getChildren()[i - 1];
+                        right->getChildren()[i - 1 + num] = child;
+                        child->position = i - 1 + num;
+                    }
+                    for (size_type i = 0; i < num; ++i) {
+                        node* child = left->getChildren()[left->numElements - num + 1 + i];
+                        right->getChildren()[i] = child;
+                        child->parent = right;
+                        child->position = i;
+                    }
+                }
+
+                left->numElements -= num;
+                right->numElements += num;
+            }
+        }
+
+        /**
+         * Merges the child at position pos + 1 into the child at position pos, thereby
+         * removing the separating key from this inner node (for internal use only).
+         *
+         * @param pos .. the position of the left child
+         * @return the right child, which is no longer referenced by this node
+         */
+        node* merge_children(size_type pos) {
+            node* left = getChild(pos);
+            node* right = getChild(pos + 1);
+#ifdef IS_PARALLEL
+            assert(this->lock.is_write_locked());
+            assert(left->lock.is_write_locked() && right->lock.is_write_locked());
+#endif
+            assert(left->numElements + right->numElements + 1 <= maxKeys);
+
+            // move the separating key and the keys of the right node
+            left->keys[left->numElements] = keys[pos];
+            for (size_type i = 0; i < right->numElements; ++i) {
+                left->keys[left->numElements + 1 + i] = right->keys[i];
+            }
+
+            // move child pointers
+            if (left->inner) {
+                for (size_type i = 0; i <= right->numElements; ++i) {
+                    node* child = right->getChildren()[i];
+                    left->getChildren()[left->numElements + 1 + i] = child;
+                    child->parent = left;
+                    child->position = left->numElements + 1 + i;
+                }
+            }
+            left->numElements += right->numElements + 1;
+
+            // remove the separating key and the reference to the right node
+            for (size_type i = pos + 1; i < this->numElements; ++i) {
+                keys[i - 1] = keys[i];
+                getChildren()[i] = getChildren()[i + 1];
+                getChildren()[i]->position = i;
+            }
+            --this->numElements;
+
+            return right;
+        }
+
         /**
          * Prints a textual representation of this tree to the given output stream.
          * This feature is mainly intended for debugging and tuning purposes.
@@ -1153,6 +1445,9 @@ public:
         // the node where the last upper-bound operation terminated
         node_cache last_upper_bound_end;
 
+        // the leaf node where the last erase-operation terminated
+        node_cache last_erase;
+
         // default constructor
         btree_operation_hints() {}
 
@@ -1162,6 +1457,7 @@ public:
             last_find_end.clear(nullptr);
             last_lower_bound_end.clear(nullptr);
             last_upper_bound_end.clear(nullptr);
+            last_erase.clear(nullptr);
         }
     };
 
@@ -1185,6 +1481,12 @@ private:
     // a pointer to the left-most node of this tree (initial note for iteration)
     leaf_node* leftmost;
 
+    // nodes removed by erase operations, kept until no concurrent operation may access them
+    std::vector<node*> retired;
+
+    // a lock to synchronize the retirement of nodes
+    Lock retired_lock;
+
     /* -------------- operator hint statistics ----------------- */
 
     // an aggregation of statistical values of the hint utilization
@@ -1200,6 +1502,9 @@ private:
 
         // the counter for upper_bound operations
         CacheAccessCounter upper_bound;
+
+        // the counter for erase operations
+        CacheAccessCounter erases;
     };
 
     // the hint statistic of this b-tree instance
@@ -1208,7 +1513,10 @@ private:
 public:
     enum {
         // the maximum number of keys stored per node
-        max_keys_per_node = node::maxKeys
+        max_keys_per_node = node::maxKeys,
+
+        // the size ratio of tree and sorted range beyond which the range is inserted element-wise
+        merge_threshold = 8
     };
 
     // -- ctors / dtors --
@@ -1225,9 +1533,11 @@ public:
 
     // a move constructor
     btree(btree&& other)
-            : comp(other.comp), weak_comp(other.weak_comp), root(other.root), leftmost(other.leftmost) {
+            : comp(other.comp), weak_comp(other.weak_comp), root(other.root), leftmost(other.leftmost),
+              retired(std::move(other.retired)) {
         other.root = nullptr;
         other.leftmost = nullptr;
+        other.retired.clear();
     }
 
     // a copy constructor
@@ -1657,10 +1967,64 @@ public:
         }
     }
 
+    /**
+     * Inserts the given range of elements into this tree. The range has to be sorted
+     * according to the order of this tree. Unless the range is small compared to this
+     * tree, both are merged in a single pass and the tree is rebuilt bottom-up, filling
+     * nodes to the given load factor. Otherwise, elements are inserted utilizing hints.
+     *
+     * This operation must not be invoked concurrently with other operations on this tree.
+     */
+    template <typename Iter>
+    void insertSorted(const Iter& a, const Iter& b, double loadFactor = 1.0) {
+        // quick exit - empty range
+        if (a == b) {
+            return;
+        }
+
+        // updates of existing elements are only supported by the element-wise insertion
+        if (typeid(Comparator) != typeid(WeakComparator)) {
+            insert(a, b);
+            return;
+        }
+
+        // small ranges are cheaper to insert than rebuilding the tree
+        size_type num = std::distance(a, b);
+        size_type limit = num * merge_threshold;
+        size_type count = 0;
+        for (auto it = begin(); it != end() && count <= limit; ++it) {
+            ++count;
+        }
+        if (count > limit) {
+            insert(a, b);
+            return;
+        }
+
+        // count the elements of the merged sequence
+        count = 0;
+        merge(begin(), end(), a, b, [&](const Key&) { ++count; });
+
+        // assemble the new tree from the merged sequence
+        tree_builder builder(count, loadFactor);
+        merge(begin(), end(), a, b, [&](const Key& k) { builder.push(k); });
+
+        leaf_node* newLeftmost = nullptr;
+        node* newRoot = builder.build(newLeftmost);
+
+        // replace the content of this tree
+        clear();
+        root = newRoot;
+        leftmost = newLeftmost;
+    }
+
     /**
      * Inserts all elements of the given b-tree into this tree.
      * This can be a more effective alternative to the ordered insertion
      * of elements utilizing iterators.
+     *
+     * Elements are inserted utilizing hints, such that this operation may be invoked
+     * concurrently with insertions. Exclusive owners of this tree may merge the elements
+     * in a single pass by mergeAll() instead.
      */
     void insertAll(const btree& other) {
         // shortcut for non-sense operation
@@ -1681,6 +2045,171 @@ public:
         insert(other.begin(), other.end());
     }
 
+    /**
+     * Merges all elements of the given b-tree into this tree in a single pass, rebuilding
+     * this tree bottom-up unless the other tree is small compared to it.
+     *
+     * This operation must not be invoked concurrently with other operations on this tree.
+     */
+    void mergeAll(const btree& other) {
+        // shortcut for non-sense operation
+        if (this == &other) {
+            return;
+        }
+        insertSorted(other.begin(), other.end());
+    }
+
+    /**
+     * Removes the given key from this tree. In multisets, a single instance
+     * of the key is removed.
+     *
+     * @return true if an element has been removed, false if it was not present
+     */
+    bool erase(const Key& k) {
+        operation_hints hints;
+        return erase(k, hints);
+    }
+
+    /**
+     * Removes the given key from this tree. In multisets, a single instance
+     * of the key is removed.
+     *
+     * Keys stored in inner nodes are replaced by their predecessor. Nodes falling
+     * below the minimal fill state are re-balanced with or merged into a sibling.
+     * Nodes removed from the tree are freed by clear() or reclaim(), such that
+     * concurrent operations never access released memory.
+     *
+     * @return true if an element has been removed, false if it was not present
+     */
+    bool erase(const Key& k, operation_hints& hints) {
+#ifdef IS_PARALLEL
+        // attempts only succeed if all required locks are free => retry until done
+        bool erased = false;
+        while (!try_erase(k, hints, erased)) {
+        }
+        return erased;
+#else
+        if (empty()) {
+            return false;
+        }
+
+        node* cur = root;
+
+        auto checkHints = [&](node* last_erase) {
+            if (!last_erase) return false;
+            if (!covers(last_erase, k)) return false;
+            cur = last_erase;
+            return true;
+        };
+
+        // test last erase
+        if (hints.last_erase.any(checkHints)) {
+            hint_stats.erases.addHit();
+        } else {
+            hint_stats.erases.addMiss();
+        }
+
+        // locate the key
+        size_type idx = 0;
+        while (true) {
+            auto a = &(cur->keys[0]);
+            auto b = &(cur->keys[cur->numElements]);
+
+            auto pos = search.lower_bound(k, a, b, comp);
+            idx = pos - a;
+
+            if (pos != b && equal(*pos, k)) {
+                break;
+            }
+
+            if (!cur->inner) {
+                return false;
+            }
+
+            cur = cur->getChild(idx);
+        }
+
+        // remove the key, or replace it by its predecessor if it is located in an inner node
+        node* leaf = cur;
+        if (cur->inner) {
+            leaf = cur->getChild(idx);
+            while (leaf->inner) {
+                leaf = leaf->getChild(leaf->numElements);
+            }
+            cur->keys[idx] = leaf->keys[leaf->numElements - 1];
+        } else {
+            for (size_type i = idx + 1; i < leaf->numElements; ++i) {
+                leaf->keys[i - 1] = leaf->keys[i];
+            }
+        }
+        leaf->numElements--;
+
+        // remember last erase position
+        hints.last_erase.access(leaf);
+
+        // restore the fill state of the affected nodes
+        rebalance_after_erase(leaf);
+        return true;
+#endif
+    }
+
+    /**
+     * Removes all elements within the range [lower, upper) from this tree.
+     *
+     * @return the number of removed elements
+     */
+    size_type eraseRange(const Key& lower, const Key& upper) {
+        // collect elements in batches, since erasing invalidates iterators
+        const size_type batchSize = 1024;
+        std::vector<Key> batch;
+        size_type res = 0;
+        while (true) {
+            batch.clear();
+            for (auto it = lower_bound(lower); it != end() && less(*it, upper) && batch.size() < batchSize;
+                    ++it) {
+                batch.push_back(*it);
+            }
+            if (batch.empty()) {
+                return res;
+            }
+            res += eraseSorted(batch.begin(), batch.end());
+        }
+    }
+
+    /**
+     * Removes the elements of the given range from this tree. The range has to be
+     * sorted according to the order of this tree, such that consecutive elements are
+     * mostly located in the same leaf and found without a descent from the root.
+     *
+     * @return the number of removed elements
+     */
+    template <typename Iter>
+    size_type eraseSorted(const Iter& a, const Iter& b) {
+        operation_hints hints;
+        size_type res = 0;
+        for (auto it = a; it != b; ++it) {
+            if (erase(*it, hints)) {
+                ++res;
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Removes all elements of the given b-tree from this tree.
+     *
+     * @return the number of removed elements
+     */
+    size_type eraseAll(const btree& other) {
+        // shortcut for removing everything
+        if (this == &other) {
+            size_type res = size();
+            clear();
+            return res;
+        }
+        return eraseSorted(other.begin(), other.end());
+    }
+
     // Obtains an iterator referencing the first element of the tree.
     iterator begin() const {
         return iterator(leftmost, 0);
@@ -1906,6 +2435,23 @@ public:
         delete root;
         root = nullptr;
         leftmost = nullptr;
+        reclaim();
+    }
+
+    /**
+     * Frees the nodes removed from this tree by erase operations. This must not be
+     * invoked concurrently with any other operation on this tree and invalidates all
+     * operation hints referring to this tree.
+     */
+    void reclaim() {
+        for (node* cur : retired) {
+            if (cur->inner) {
+                // child nodes have been moved to other nodes
+                cur->getChildren()[0] = nullptr;
+            }
+            delete cur;
+        }
+        retired.clear();
     }
 
     /**
@@ -1917,6 +2463,7 @@ public:
         // swap the content
         std::swap(root, other.root);
         std::swap(leftmost, other.leftmost);
+        std::swap(retired, other.retired);
     }
 
     // Implementation of the assignment operation for trees.
@@ -2041,6 +2588,8 @@ public:
             out << "  lower_bound hint misses: " << hint_stats.lower_bound.getMisses() << "\n";
             out << "    upper_bound hint hits: " << hint_stats.upper_bound.getHits() << "\n";
             out << "  upper_bound hint misses: " << hint_stats.upper_bound.getMisses() << "\n";
+            out << "          erase hint hits: " << hint_stats.erases.getHits() << "\n";
+            out << "        erase hint misses: " << hint_stats.erases.getMisses() << "\n";
             out << "---------------------------------\n";
         }
     }
@@ -2060,34 +2609,278 @@ public:
      * A static member enabling the bulk-load of ordered data into an empty
      * tree. This function is much more efficient in creating a index over
      * an ordered set of elements than an iterative insertion of values.
+     * The tree is assembled bottom-up, filling nodes to the given load factor.
      *
      * @tparam Iter .. the type of iterator specifying the range
-     *                     it must be a random-access iterator
+     *                     it must be a forward iterator
      */
     template <typename R, typename Iter>
-    static typename std::enable_if<std::is_same<typename std::iterator_traits<Iter>::iterator_category,
-                                           std::random_access_iterator_tag>::value,
-            R>::type
-    load(const Iter& a, const Iter& b) {
+    static R load(const Iter& a, const Iter& b, double loadFactor = 1.0) {
         // quick exit - empty range
         if (a == b) {
             return R();
         }
 
-        // resolve tree recursively
-        auto root = buildSubTree(a, b - 1);
-
-        // find leftmost node
-        node* leftmost = root;
-        while (!leftmost->isLeaf()) {
-            leftmost = leftmost->getChild(0);
+        // assemble tree level by level
+        size_type num = std::distance(a, b);
+        tree_builder builder(num, loadFactor);
+        for (auto it = a; it != b; ++it) {
+            builder.push(*it);
         }
 
+        leaf_node* leftmost = nullptr;
+        node* root = builder.build(leftmost);
+
         // build result
-        return R(b - a, root, static_cast<leaf_node*>(leftmost));
+        return R(num, root, leftmost);
     }
 
 private:
+#ifdef IS_PARALLEL
+    /**
+     * Attempts to erase the given key. All locks are obtained without blocking. If
+     * any of them is not available, the attempt is abandoned before modifying the
+     * tree, such that erase operations can not deadlock with insertions locking
+     * nodes bottom-up.
+     *
+     * @param erased .. set to true if the key has been removed
+     * @return false if the attempt has to be repeated, true otherwise
+     */
+    bool try_erase(const Key& k, operation_hints& hints, bool& erased) {
+        erased = false;
+
+        node* cur = nullptr;
+        lock_type::Lease cur_lease;
+
+        auto checkHint = [&](node* last_erase) {
+            // ignore null pointer
+            if (!last_erase) return false;
+            // get a read lease on indicated node
+            auto hint_lease = last_erase->lock.start_read();
+            // check whether it covers the key
+            if (!covers(last_erase, k)) return false;
+            // and if there was no concurrent modification
+            if (!last_erase->lock.validate(hint_lease)) return false;
+            // use hinted location
+            cur = last_erase;
+            // and keep lease
+            cur_lease = hint_lease;
+            // we found a hit
+            return true;
+        };
+
+        if (hints.last_erase.any(checkHint)) {
+            hint_stats.erases.addHit();
+        } else {
+            hint_stats.erases.addMiss();
+        }
+
+        // if there is no valid hint ..
+        if (!cur) {
+            do {
+                // get root - access lock
+                auto root_lease = root_lock.start_read();
+
+                // start with root
+                cur = root;
+
+                // get lease of the next node to be accessed
+                if (cur) cur_lease = cur->lock.start_read();
+
+                // check validity of root pointer
+                if (root_lock.end_read(root_lease)) break;
+
+            } while (true);
+
+            // nothing to do for empty trees
+            if (!cur) return true;
+        }
+
+        // -- locate the key --
+
+        size_type idx = 0;
+        while (true) {
+            auto a = &(cur->keys[0]);
+            auto b = &(cur->keys[cur->numElements]);
+
+            auto pos = search.lower_bound(k, a, b, comp);
+            idx = pos - a;
+
+            if (pos != b && equal(*pos, k)) break;
+
+            if (!cur->inner) {
+                // the key is not present unless the leaf has been modified in the mean-while
+                return cur->lock.validate(cur_lease);
+            }
+
+            // get next pointer
+            auto next = cur->getChild(idx);
+
+            // get lease on next level
+            auto next_lease = next->lock.start_read();
+
+            // check whether there was a write
+            if (!cur->lock.end_read(cur_lease)) return false;
+
+            // go to next
+            cur = next;
+            cur_lease = next_lease;
+        }
+
+        // the path from the node holding the key to the leaf providing its replacement
+        std::vector<std::pair<node*, lock_type::Lease>> path;
+        path.push_back(std::make_pair(cur, cur_lease));
+        if (cur->inner) {
+            node* next = cur->getChild(idx);
+            while (true) {
+                auto next_lease = next->lock.start_read();
+                if (!path.back().first->lock.validate(path.back().second)) return false;
+                path.push_back(std::make_pair(next, next_lease));
+                if (!next->inner) break;
+                next = next->getChild(next->numElements);
+            }
+        }
+        node* leaf = path.back().first;
+
+        // -- lock all affected nodes --
+
+        std::vector<node*> locked;
+        bool root_locked = false;
+
+        auto abort = [&]() {
+            for (node* n : locked) {
+                n->lock.abort_write();
+            }
+            if (root_locked) root_lock.abort_write();
+            return false;
+        };
+
+        // the path has to be unchanged since it has been inspected
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            if (!it->first->lock.try_upgrade_to_write(it->second)) return abort();
+            locked.push_back(it->first);
+        }
+
+        // lock parents and siblings as long as merges propagate upwards ("sphere of influence")
+        node* priv = leaf;
+        size_type remaining = leaf->numElements - 1;
+        while (true) {
+            node* parent = priv->parent;
+            if (!parent) {
+                // the root is replaced if it runs empty
+                if (remaining == 0) {
+                    if (!root_lock.try_start_write()) return abort();
+                    root_locked = true;
+                }
+                break;
+            }
+
+            if (remaining >= node::minKeys) break;
+
+            if (std::find(locked.begin(), locked.end(), parent) == locked.end()) {
+                if (!parent->lock.try_start_write()) return abort();
+                locked.push_back(parent);
+                // check whether parent is correct
+                if (parent != priv->parent) return abort();
+            }
+
+            auto pos = priv->position;
+            node* sibling = parent->getChild((pos > 0) ? pos - 1 : pos + 1);
+            if (!sibling->lock.try_start_write()) return abort();
+            locked.push_back(sibling);
+
+            // keys are moved between the nodes if they can not be merged
+            if (sibling->numElements + remaining + 1 > node::maxKeys) break;
+
+            // merging removes a key from the parent
+            remaining = parent->numElements - 1;
+            priv = parent;
+        }
+
+        // -- remove the key --
+
+        if (cur->inner) {
+            cur->keys[idx] = leaf->keys[leaf->numElements - 1];
+        } else {
+            for (size_type i = idx + 1; i < leaf->numElements; ++i) {
+                leaf->keys[i - 1] = leaf->keys[i];
+            }
+        }
+        leaf->numElements--;
+
+        // remember last erase position
+        hints.last_erase.access(leaf);
+
+        // restore the fill state of the affected nodes
+        rebalance_after_erase(leaf);
+
+        // release all locks
+        for (node* n : locked) {
+            n->lock.end_write();
+        }
+        if (root_locked) root_lock.end_write();
+
+        erased = true;
+        return true;
+    }
+#endif
+
+    /**
+     * Restores the fill state of the given node after the removal of a key by moving
+     * keys from a sibling or merging it with a sibling, continuing towards the root as
+     * long as merges cause the parent to underflow. All affected nodes have to be locked.
+     */
+    void rebalance_after_erase(node* cur) {
+        while (true) {
+            node* parent = cur->parent;
+
+            // the root is only replaced once it is empty
+            if (!parent) {
+                if (!cur->isEmpty()) return;
+                if (cur->inner) {
+                    // the only child becomes the new root
+                    node* child = cur->getChild(0);
+                    child->parent = nullptr;
+                    child->position = 0;
+                    root = child;
+                } else {
+                    root = nullptr;
+                    leftmost = nullptr;
+                }
+                retire(cur);
+                return;
+            }
+
+            if (cur->numElements >= node::minKeys) return;
+
+            size_type pos = cur->position;
+            size_type left = (pos > 0) ? pos - 1 : pos;
+
+            // if both nodes do not fit into one, even out their keys
+            if (parent->getChild(left)->numElements + parent->getChild(left + 1)->numElements + 1 >
+                    node::maxKeys) {
+                parent->balance_children(left);
+                return;
+            }
+
+            // otherwise merge them and continue with the parent
+            retire(parent->merge_children(left));
+            cur = parent;
+        }
+    }
+
+    /**
+     * Retires a node removed from the tree. The node is emptied, such that hints
+     * referring to it are no longer covering any key, and freed by reclaim(). Its
+     * first child reference is kept for concurrent readers still visiting the node.
+     */
+    void retire(node* cur) {
+        cur->numElements = 0;
+        auto lease = retired_lock.acquire();
+        (void)lease;  // avoid warning
+        retired.push_back(cur);
+    }
+
     /**
      * Determines whether the range covered by the given node is also
      * covering the given key value.
@@ -2125,62 +2918,152 @@ private:
         return !node->isEmpty() && !less(k, node->keys[0]) && less(k, node->keys[node->numElements - 1]);
     }
 
-    // Utility function for the load operation above.
-    template <typename Iter>
-    static node* buildSubTree(const Iter& a, const Iter& b) {
-        const int N = node::maxKeys;
+    /**
+     * A utility assembling a tree bottom-up from a sorted sequence of a known number
+     * of keys. Leaves are filled in a single pass over the sequence, inner levels are
+     * built from the collected leaves and separating keys. The keys of each level are
+     * distributed evenly among its nodes, which are filled up to the load factor.
+     */
+    class tree_builder {
+        // the number of keys per node targeted by the load factor
+        size_type capacity;
 
-        // divide range in N+1 sub-ranges
-        int length = (b - a) + 1;
+        // the number of keys of the first leaves and the number of leaves holding one key more
+        size_type base;
+        size_type extra;
 
-        // terminal case: length is less then maxKeys
-        if (length <= N) {
-            // create a leaf node
-            node* res = new leaf_node();
-            res->numElements = length;
+        // the nodes of the level under construction and the keys separating them
+        std::vector<node*> nodes;
+        std::vector<Key> separators;
 
-            for (int i = 0; i < length; ++i) {
-                res->keys[i] = a[i];
-            }
+        // the leaf currently being filled
+        node* cur = nullptr;
 
-            return res;
+    public:
+        tree_builder(size_type numKeys, double loadFactor) {
+            // nodes hold at least two keys, such that no level contains empty nodes
+            capacity = static_cast<size_type>(loadFactor * node::maxKeys);
+            capacity = (capacity < 2) ? 2 : (capacity > node::maxKeys) ? size_type(node::maxKeys) : capacity;
+
+            // leaves and the keys separating them partition the sequence
+            size_type numLeaves = (numKeys + 1 + capacity) / (capacity + 1);
+            size_type numLeafKeys = numKeys - (numLeaves - 1);
+            base = numLeafKeys / numLeaves;
+            extra = numLeafKeys % numLeaves;
+            nodes.reserve(numLeaves);
+            separators.reserve(numLeaves);
         }
 
-        // recursive case - compute step size
-        int numKeys = N;
-        int step = ((length - numKeys) / (numKeys + 1));
+        /**
+         * Adds the next key of the sequence.
+         */
+        void push(const Key& k) {
+            // the key following a complete leaf separates it from the next one
+            if (cur && cur->numElements == base + ((nodes.size() <= extra) ? 1 : 0)) {
+                separators.push_back(k);
+                cur = nullptr;
+                return;
+            }
+
+            // start the next leaf
+            if (!cur) {
+                cur = new leaf_node();
+                nodes.push_back(cur);
+            }
 
-        while (numKeys > 1 && (step < N / 2)) {
-            numKeys--;
-            step = ((length - numKeys) / (numKeys + 1));
+            cur->keys[cur->numElements++] = k;
         }
 
-        // create inner node
-        node* res = new inner_node();
-        res->numElements = numKeys;
+        /**
+         * Builds the inner levels on top of the assembled leaves.
+         *
+         * @param leftmost .. set to the left-most leaf of the tree
+         * @return the root of the tree, null if no key has been added
+         */
+        node* build(leaf_node*& leftmost) {
+            if (nodes.empty()) {
+                leftmost = nullptr;
+                return nullptr;
+            }
+            leftmost = static_cast<leaf_node*>(nodes.front());
+
+            while (nodes.size() > 1) {
+                // distribute the children of this level evenly among their parents
+                size_type numChildren = nodes.size();
+                size_type numParents = (numChildren + capacity) / (capacity + 1);
+                size_type childrenBase = numChildren / numParents;
+                size_type childrenExtra = numChildren % numParents;
+
+                std::vector<node*> parents;
+                std::vector<Key> parentSeparators;
+                parents.reserve(numParents);
+                parentSeparators.reserve(numParents);
+
+                size_type pos = 0;
+                for (size_type i = 0; i < numParents; ++i) {
+                    size_type num = childrenBase + ((i < childrenExtra) ? 1 : 0);
+
+                    auto* parent = new inner_node();
+                    for (size_type j = 0; j < num; ++j) {
+                        node* child = nodes[pos + j];
+                        parent->children[j] = child;
+                        child->parent = parent;
+                        child->position = j;
+                        if (j + 1 < num) {
+                            parent->keys[j] = separators[pos + j];
+                        }
+                    }
+                    parent->numElements = num - 1;
+
+                    // the key following the last child separates this parent from the next one
+                    if (i + 1 < numParents) {
+                        parentSeparators.push_back(separators[pos + num - 1]);
+                    }
 
-        Iter c = a;
-        for (int i = 0; i < numKeys; i++) {
-            // get dividing key
-            res->keys[i] = c[step];
+                    parents.push_back(parent);
+                    pos += num;
+                }
 
-            // get sub-tree
-            auto child = buildSubTree(c, c + (step - 1));
-            child->parent = res;
-            child->position = i;
-            res->getChildren()[i] = child;
+                nodes.swap(parents);
+                separators.swap(parentSeparators);
+            }
 
-            c = c + (step + 1);
+            return nodes.front();
         }
+    };
 
-        // and the remaining part
-        auto child = buildSubTree(c, b);
-        child->parent = res;
-        child->position = numKeys;
-        res->getChildren()[numKeys] = child;
+    /**
+     * Merges the two given sorted ranges, passing each element of the result to the
+     * given operation. For sets, elements present in both ranges are only passed once.
+     */
+    template <typename IterA, typename IterB, typename Op>
+    void merge(IterA a, const IterA& aEnd, IterB b, const IterB& bEnd, const Op& op) const {
+        bool first = true;
+        Key last = Key();
+        auto emit = [&](const Key& k) {
+            if (isSet) {
+                if (!first && equal(last, k)) return;
+                first = false;
+                last = k;
+            }
+            op(k);
+        };
 
-        // done
-        return res;
+        while (a != aEnd && b != bEnd) {
+            if (less(*b, *a)) {
+                emit(*b);
+                ++b;
+            } else {
+                emit(*a);
+                ++a;
+            }
+        }
+        for (; a != aEnd; ++a) {
+            emit(*a);
+        }
+        for (; b != bEnd; ++b) {
+            emit(*b);
+        }
     }
 };
 
@@ -2248,8 +3131,8 @@ public:
 
     // Support for the bulk-load operator.
     template <typename Iter>
-    static btree_set load(const Iter& a, const Iter& b) {
-        return super::template load<btree_set>(a, b);
+    static btree_set load(const Iter& a, const Iter& b, double loadFactor = 1.0) {
+        return super::template load<btree_set>(a, b, loadFactor);
     }
 };
 
@@ -2309,8 +3192,8 @@ public:
 
     // Support for the bulk-load operator.
     template <typename Iter>
-    static btree_multiset load(const Iter& a, const Iter& b) {
-        return super::template load<btree_multiset>(a, b);
+    static btree_multiset load(const Iter& a, const Iter& b, double loadFactor = 1.0) {
+        return super::template load<btree_multiset>(a, b, loadFactor);
     }
 };
 
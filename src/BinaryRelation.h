@@ -16,10 +16,13 @@
 
 #pragma once
 
+#include "ParallelUtils.h"
 #include "Trie.h"
 #include "UnionFind.h"
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace souffle {
 template <typename TupleType>
@@ -39,6 +42,13 @@ class BinaryRelation {
     // the ordering of states per disjoint set (mapping from representative to trie)
     mutable std::unordered_map<DomainInt, std::shared_ptr<souffle::Trie<1>>> orderedStates;
 
+    // a slice of the ordering of a disjoint set, i.e. all pairs (x,_) s.t. x in [begin, end) of the trie
+    struct slice {
+        std::shared_ptr<souffle::Trie<1>> trie;
+        souffle::Trie<1>::iterator begin;
+        souffle::Trie<1>::iterator end;
+    };
+
 public:
     BinaryRelation& operator=(const BinaryRelation& old) {
         if (this == &old) return *this;
@@ -83,9 +93,7 @@ public:
         // and this is not normal souffle behaviour
         // statesLock.lock_shared();
 
-        orderedStates.erase(sds.readOnlyFindNode(x));
-        orderedStates.erase(sds.readOnlyFindNode(y));
-        sds.unionNodes(x, y);
+        unionPair(x, y);
 
         bool retval = contains(x, y);
 
@@ -99,16 +107,25 @@ public:
      * @param other the binary relation from which to add nodes from
      */
     void insertAll(const BinaryRelation<TupleType>& other) {
+        std::vector<std::pair<DomainInt, DomainInt>> pairs;
+
         // for each representative
         for (auto rep = other.sds.beginReps(); rep != other.sds.endReps(); ++rep) {
             // insert the pairing between the representative and its
             for (auto subrep = other.sds.begin(*rep); subrep != other.sds.end(*rep); ++subrep) {
-                this->insert(*rep, *subrep);
+                pairs.push_back(std::make_pair(*rep, *subrep));
             }
         }
+
+        unionBatch(pairs);
     }
 
     void extend(const BinaryRelation<TupleType>& other) {
+        // collect the disjoint sets to be unioned first, as the disjoint sets of this relation
+        // cannot be modified while iterating over them
+        std::vector<std::pair<DomainInt, DomainInt>> joins;
+        std::vector<std::pair<DomainInt, DomainInt>> pairs;
+
         // iterate over all elements for each dj set in this BinRel
         for (auto it = sds.beginReps(); it != sds.endReps(); ++it) {
             DomainInt rep = *it;
@@ -116,18 +133,22 @@ public:
             for (auto setIt = sds.begin(rep); setIt != sds.end(rep); ++setIt) {
                 DomainInt el = *setIt;
 
-                // TODO: union the two DJ sets
                 if (other.containsElement(el)) {
-                    DomainInt otherRep = other.sds.readOnlyFindNode(el);
-                    for (auto otherIt = other.sds.begin(otherRep); otherIt != other.sds.end(otherRep);
-                            ++otherIt) {
-                        this->insert(el, *otherIt);
-                    }
-
+                    joins.push_back(std::make_pair(el, other.sds.readOnlyFindNode(el)));
                     break;
                 }
             }
         }
+
+        // union the two DJ sets as one batch
+        for (const auto& join : joins) {
+            for (auto otherIt = other.sds.begin(join.second); otherIt != other.sds.end(join.second);
+                    ++otherIt) {
+                pairs.push_back(std::make_pair(join.first, *otherIt));
+            }
+        }
+
+        unionBatch(pairs);
     }
 
 protected:
@@ -175,6 +196,39 @@ public:
     }
 
 private:
+    /**
+     * Union the two values, discarding the orderings of their disjoint sets
+     * The lock on orderedStates must be held, unless no ordering has been built
+     * @param x node to be added/paired
+     * @param y node to be added/paired
+     */
+    void unionPair(DomainInt x, DomainInt y) {
+        if (!orderedStates.empty()) {
+            orderedStates.erase(sds.readOnlyFindNode(x));
+            orderedStates.erase(sds.readOnlyFindNode(y));
+        }
+        sds.unionNodes(x, y);
+    }
+
+    /**
+     * Union a batch of pairs, discarding the ordering of each affected disjoint set once - they are
+     * rebuilt by the next iteration over this relation
+     * @param pairs the pairs to be added
+     */
+    void unionBatch(const std::vector<std::pair<DomainInt, DomainInt>>& pairs) {
+        statesLock.lock();
+
+        if (!orderedStates.empty()) {
+            for (const auto& pair : pairs) {
+                orderedStates.erase(sds.readOnlyFindNode(pair.first));
+                orderedStates.erase(sds.readOnlyFindNode(pair.second));
+            }
+        }
+        sds.unionAll(pairs);
+
+        statesLock.unlock();
+    }
+
     /**
      * Create a trie which contains the disjoint set which contains this value
      * @param val the value whose disjoint set will be constructed into a trie
@@ -194,30 +248,42 @@ private:
         }
 
         statesLock.unlock_shared();
-        statesLock.lock();
-
-        // return if already created (other write thread may have been called simultaneously)
-        if (this->orderedStates.find(rep) != this->orderedStates.end()) {
-            auto retptr = this->orderedStates.at(rep);
-            statesLock.unlock();
-            return retptr;
-        }
-
-        this->orderedStates[rep] = std::shared_ptr<souffle::Trie<1>>(new souffle::Trie<1>);
 
-        // populate the trie
+        // populate the trie without holding the lock, such that tries can be generated in parallel
+        auto trie = std::make_shared<souffle::Trie<1>>();
         for (auto it = sds.begin(rep); it != sds.end(rep); ++it) {
             // add the current value of the iterator to the trie
-            this->orderedStates.at(rep)->insert(*it);
+            trie->insert(*it);
         }
 
-        auto retptr = this->orderedStates.at(rep);
+        statesLock.lock();
+
+        // keep the existing trie if another thread has generated one simultaneously
+        auto retptr = this->orderedStates.insert(std::make_pair(rep, trie)).first->second;
 
         statesLock.unlock();
 
         return retptr;
     }
 
+    /**
+     * Create the tries of all disjoint sets which have none, in parallel
+     */
+    void generateTries() const {
+        std::vector<DomainInt> reps;
+
+        statesLock.lock_shared();
+        for (auto rep = sds.beginReps(); rep != sds.endReps(); ++rep) {
+            if (orderedStates.find(*rep) == orderedStates.end()) reps.push_back(*rep);
+        }
+        statesLock.unlock_shared();
+
+#pragma omp parallel for schedule(dynamic) num_threads(getTaskThreads())
+        for (size_t i = 0; i < reps.size(); ++i) {
+            generateTrieIfNone(reps[i]);
+        }
+    }
+
 public:
     class iterator : public std::iterator<std::forward_iterator_tag, TupleType> {
         // special tombstone value to notify that this iter represents the end
@@ -226,8 +292,9 @@ public:
         TupleType value;
         const BinaryRelation* br = nullptr;
         // iterate over all pairs, iterate over all starting at, iterate over all starting at & ending at,
-        // iterate over all in dj set, iterate over all (x,_) s.t. x in djset
-        enum IterType { BASIC, STARTAT, BETWEEN, CLOSURE, FRONTPROD };
+        // iterate over all in dj set, iterate over all (x,_) s.t. x in djset,
+        // iterate over all (x,_) s.t. x in a list of slices of dj sets
+        enum IterType { BASIC, STARTAT, BETWEEN, CLOSURE, FRONTPROD, SLICES };
         IterType ityp;
 
         // the tries for each iterator to belong to
@@ -248,6 +315,11 @@ public:
         // for the front product iter
         std::list<DomainInt> fronts;
 
+        // for the slices iter, shared by all copies of the iterator
+        std::shared_ptr<const std::vector<slice>> slices;
+        size_t slicePos = 0;
+        souffle::Trie<1>::iterator frontEnd;
+
     public:
         // ctor for end()
         iterator(bool truthy, const BinaryRelation* br) : isEndVal(true), br(br){};
@@ -314,9 +386,21 @@ public:
             ityp = FRONTPROD;
             initIterator(trie);
             // fast forward iter to the first requirement
-            auto f = this->fronts.front();
+            seekFront(this->fronts.front());
             this->fronts.pop_front();
-            while ((*frontIter)[0] != f) ++frontIter;
+            setValue();
+        }
+
+        // ctor for the pairs of slices of dj sets, aka R(x, _) for all x in slices
+        iterator(const BinaryRelation* br, std::shared_ptr<const std::vector<slice>> slices)
+                : br(br), slices(std::move(slices)) {
+            ityp = SLICES;
+            if (this->slices->empty()) {
+                isEndVal = true;
+                return;
+            }
+
+            initSlice();
             setValue();
         }
 
@@ -397,6 +481,20 @@ public:
          * @return whether we've reached end() or not
          */
         bool advanceFrontIter() {
+            if (ityp == SLICES) {
+                // move on to the next slice once this one is exhausted
+                if (++frontIter == frontEnd) {
+                    if (++slicePos == slices->size()) {
+                        isEndVal = true;
+                        return true;
+                    }
+                    initSlice();
+                } else {
+                    backIter = cTrie->begin();
+                }
+                return false;
+            }
+
             // if we're at the end of this current Trie
             if (frontIter == cTrie->end() || ++souffle::Trie<1>::iterator(frontIter) == cTrie->end()) {
                 // reaching the end of this trie means that the closure has completed
@@ -441,12 +539,9 @@ public:
                         return true;
                     }
 
-                    // step frontIter until we hit the next valid fronts
-                    auto newFront = fronts.front();
+                    // jump frontIter to the next valid fronts
+                    seekFront(fronts.front());
                     fronts.pop_front();
-                    do {
-                        ++frontIter;
-                    } while ((*frontIter)[0] != newFront);
 
                 } else {
                     // we can just step frontIter along one, because it will not step past the end of a trie
@@ -516,6 +611,26 @@ public:
             cTrie = trie;
         }
 
+        /**
+         * Point the iterators to the beginning of the current slice
+         */
+        void initSlice() {
+            const slice& cur = (*slices)[slicePos];
+            initIterator(cur.trie);
+            frontIter = cur.begin;
+            frontEnd = cur.end;
+        }
+
+        /**
+         * Point frontIter to the given element of cTrie
+         * @param front the element, which must be contained in cTrie
+         */
+        void seekFront(DomainInt front) {
+            souffle::Trie<1>::entry_type entry;
+            entry[0] = front;
+            frontIter = cTrie->getBoundaries<1>(entry).begin();
+        }
+
         /**
          * Fast forward the iterators in iterList (and also frontIter and backIter)
          * s.t. they point to positions >= start
@@ -594,9 +709,7 @@ public:
      */
     iterator begin() const {
         // generate tries for all disjoint sets
-        for (auto rep = sds.beginReps(); rep != sds.endReps(); ++rep) {
-            generateTrieIfNone(*rep);
-        }
+        generateTries();
 
         return iterator(this);
     }
@@ -616,11 +729,7 @@ public:
      */
     iterator find(const TupleType& start) const {
         // generate tries for all disjoint sets
-        // std::for_each(sds.beginReps(), sds.endReps(), [&](DomainInt r) { generateTrieIfNone(r); });
-
-        for (auto rep = sds.beginReps(); rep != sds.endReps(); ++rep) {
-            generateTrieIfNone(*rep);
-        }
+        generateTries();
 
         return iterator(this, start);
     }
@@ -694,7 +803,7 @@ public:
      */
     iterator findBetween(const TupleType& start, const TupleType& end) const {
         // generate tries for all disjoint sets
-        std::for_each(sds.beginReps(), sds.endReps(), [&](DomainInt r) { generateTrieIfNone(r); });
+        generateTries();
 
         return iterator(this, start, end);
     }
@@ -747,8 +856,9 @@ public:
 
     /**
      * Generate an approximate number of iterators for parallel iteration
-     * The iterators returned are not necessarily equal in size, but in practise are approximately similarly
-     * sized
+     * Each iterator enumerates the pairs of a sequence of slices of disjoint sets: small disjoint sets are
+     * gathered into a single iterator, while the front elements of large disjoint sets are split across
+     * several iterators.
      * Depending on the structure of the data, there can be more or less partitions returned than requested.
      * @param chunks the number of requested partitions
      * @return a list of the iterators as ranges
@@ -756,9 +866,7 @@ public:
     std::vector<souffle::range<iterator>> partition(size_t chunks) const {
         std::vector<souffle::range<iterator>> ret;
 
-        for (auto rep = sds.beginReps(); rep != sds.endReps(); ++rep) {
-            generateTrieIfNone(*rep);
-        }
+        generateTries();
         // num pairs
         const size_t sz = this->size();
 
@@ -768,40 +876,38 @@ public:
         // how many pairs can we fit within each iterator? (integer ceil division)
         const size_t chunkSize = (sz + (chunks - 1)) / chunks;
 
-        for (auto djSet = sds.beginReps(); djSet != sds.endReps(); ++djSet) {
-            const DomainInt rep = *djSet;
-
-            const size_t djSetSize = sds.sizeOfRepresentativeSet(rep);
-            size_t cSize = 0;
-
-            // will the entire djSet's pairs fit within a single iterator?
-            if (djSetSize * djSetSize <= chunkSize) {
-                // fit all pairs within this disjoint set into a single iterator
-                ret.push_back(souffle::make_range(closure(rep), end()));
+        // the slices of the next iterator and their number of pairs
+        auto slices = std::make_shared<std::vector<slice>>();
+        size_t cSize = 0;
 
+        for (auto djSet = sds.beginReps(); djSet != sds.endReps(); ++djSet) {
+            const size_t djSetSize = sds.sizeOfRepresentativeSet(*djSet);
+            const size_t numPairs = djSetSize * djSetSize;
+            auto trie = generateTrieIfNone(*djSet);
+
+            // split the front elements s.t. each slice has about chunkSize pairs
+            std::vector<souffle::range<souffle::Trie<1>::iterator>> fronts;
+            if (numPairs <= chunkSize) {
+                fronts.push_back(souffle::make_range(trie->begin(), trie->end()));
             } else {
-                // add as many of this djSet closures into each iterator
-                std::list<DomainInt> fronts;
-
-                for (auto el = sds.begin(rep); el != sds.end(rep); ++el) {
-                    fronts.push_back(*el);
-                    cSize += djSetSize;
-
-                    // iterator is full now? push this iterator set onto the return val
-                    if (cSize >= chunkSize) {
-                        fronts.sort();
-
-                        ret.push_back(souffle::make_range(frontProduct(fronts), end()));
+                fronts = trie->partition((numPairs + (chunkSize - 1)) / chunkSize);
+            }
 
-                        fronts.clear();
+            for (const auto& cur : fronts) {
+                slices->push_back({trie, cur.begin(), cur.end()});
+                cSize += numPairs / fronts.size();
 
-                        cSize = 0;
-                    }
+                // iterator is full now? push this iterator onto the return val
+                if (cSize >= chunkSize) {
+                    ret.push_back(souffle::make_range(iterator(this, std::move(slices)), end()));
+                    slices = std::make_shared<std::vector<slice>>();
+                    cSize = 0;
                 }
-                // if there's any remainder still
-                if (cSize != 0) ret.push_back(souffle::make_range(frontProduct(fronts), end()));
             }
         }
+        // if there's any remainder still
+        if (!slices->empty()) ret.push_back(souffle::make_range(iterator(this, std::move(slices)), end()));
+
         return ret;
     }
 };
@@ -17,9 +17,11 @@
 #pragma once
 
 #include <atomic>
+#include <cstring>
 #include <exception>
 #include <iostream>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace souffle {
@@ -218,7 +220,7 @@ public:
         size_t othblocks = other.listData.size();
         for (size_t i = 0; i < othblocks; ++i) {
             listData.push_back(new T[BLOCKSIZE]);
-            memcpy(listData.at(i), other.listData.at(i), BLOCKSIZE);
+            memcpy(listData.at(i), other.listData.at(i), BLOCKSIZE * sizeof(T));
         }
         this->m_size = other.m_size;
     }
@@ -425,4 +427,92 @@ inline void BlockList<std::atomic<block_t>>::add(const std::atomic<block_t>& val
 
     ++m_size;
 }
+
+/**
+ * An arena of elements stored in blocks of doubling sizes, which are allocated on demand and never moved
+ * or freed while the arena exists. Hence elements can be accessed by their index without locking, while
+ * other threads create further elements.
+ * Clearing/destructing is undefined behaviour if accesses are in progress.
+ */
+template <class T>
+class BlockArena {
+    // number of elements of the first block; each further block doubles in size
+    static constexpr size_t FIRST_BLOCK_SIZE = BLOCKSIZE;
+    // maximal number of blocks
+    static constexpr size_t NUM_BLOCKS = 48;
+
+    std::atomic<T*> blocks[NUM_BLOCKS];
+
+    /**
+     * Compute the block holding the given index and the position within it
+     * @param index the index of the element
+     * @return the pair of block and position
+     */
+    static inline std::pair<size_t, size_t> getPosition(size_t index) {
+        const size_t scaled = index / FIRST_BLOCK_SIZE + 1;
+        const size_t block = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(scaled);
+        return std::make_pair(block, index - FIRST_BLOCK_SIZE * ((size_t(1) << block) - 1));
+    }
+
+public:
+    BlockArena() {
+        for (auto& block : blocks) {
+            block.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    BlockArena(const BlockArena&) = delete;
+    BlockArena& operator=(const BlockArena&) = delete;
+
+    ~BlockArena() {
+        clear();
+    }
+
+    /**
+     * Retrieve a reference to the element at index, allocating its block if necessary
+     * @param index position of the element
+     * @return the element at index
+     */
+    T& create(size_t index) {
+        const auto pos = getPosition(index);
+        T* block = blocks[pos.first].load(std::memory_order_acquire);
+        if (block == nullptr) {
+            T* fresh = new T[FIRST_BLOCK_SIZE << pos.first]();
+            if (blocks[pos.first].compare_exchange_strong(block, fresh, std::memory_order_acq_rel)) {
+                block = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        return block[pos.second];
+    }
+
+    /**
+     * Retrieve a reference to the element at index, which must have been created
+     * @param index position of the element
+     * @return the element at index
+     */
+    T& get(size_t index) const {
+        const auto pos = getPosition(index);
+        return blocks[pos.first].load(std::memory_order_acquire)[pos.second];
+    }
+
+    /**
+     * Check whether the block holding the element at index has been allocated
+     * @param index position of the element
+     * @return whether the element may be retrieved
+     */
+    bool isAllocated(size_t index) const {
+        return blocks[getPosition(index).first].load(std::memory_order_acquire) != nullptr;
+    }
+
+    /**
+     * Free all blocks of the arena
+     */
+    void clear() {
+        for (auto& block : blocks) {
+            delete[] block.exchange(nullptr);
+        }
+    }
+};
 }  // namespace souffle
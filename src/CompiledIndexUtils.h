@@ -33,6 +33,15 @@
 
 namespace souffle {
 
+namespace detail {
+
+// b-trees of tuples of up to four 32-bit integers locate keys within nodes using SIMD comparisons
+template <std::size_t arity>
+struct default_strategy<ram::Tuple<int32_t, arity>>
+        : public std::conditional<(arity >= 1 && arity <= 4), simd, binary>::type {};
+
+}  // end namespace detail
+
 namespace ram {
 
 /**
@@ -85,6 +94,9 @@ struct comparator;
 
 template <unsigned First, unsigned... Rest>
 struct comparator<First, Rest...> {
+    // the column compared first, enabling SIMD searches on it
+    enum { first_column = First };
+
     template <typename T>
     int operator()(const T& a, const T& b) const {
         return (a[First] < b[First]) ? -1 : ((a[First] > b[First]) ? 1 : comparator<Rest...>()(a, b));
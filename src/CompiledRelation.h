@@ -23,8 +23,12 @@
 #include "RamTypes.h"
 #include "Table.h"
 #include "Util.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
@@ -1391,5 +1395,370 @@ struct std_unordered_config {
 
 }  // end of namespace detail
 
+// ------------------------------------------------------------------------------------------
+//                                  Concurrent Hash Sets
+// ------------------------------------------------------------------------------------------
+
+namespace detail {
+
+/**
+ * A hash table of tuples based on open addressing, grouping tuples by a key covering
+ * a subset of their columns as determined by the given hash and equality functions.
+ * Each slot references the list of tuples sharing one key, such that the tuples
+ * matching a key are enumerated without inspecting tuples of other keys.
+ *
+ * Insertions may be conducted concurrently and are lock-free unless the table has
+ * to grow. All other operations must not be conducted concurrently with insertions.
+ *
+ * @tparam Tuple .. the type of the stored tuples
+ * @tparam Hash .. the hash function on the key columns
+ * @tparam Equal .. the equality on the key columns
+ * @tparam unique .. true if at most one tuple per key is stored, false otherwise
+ */
+template <typename Tuple, typename Hash, typename Equal, bool unique>
+class hash_table {
+    // an element of the list of tuples sharing a key
+    struct entry {
+        Tuple tuple;
+        entry* next;
+    };
+
+    using slot = std::atomic<entry*>;
+
+    // the number of slots of an empty table
+    static const std::size_t initialCapacity = 64;
+
+    Hash hash;
+    Equal equal;
+
+    // the slots, each either empty or referencing the list of one key
+    std::unique_ptr<slot[]> slots;
+
+    // the number of slots, a power of two
+    std::size_t capacity;
+
+    // the number of occupied slots, including those reserved by ongoing insertions, and stored tuples
+    std::atomic<std::size_t> numKeys;
+    std::atomic<std::size_t> numTuples;
+
+    // synchronizes insertions (readers) with the growth of the table (writer)
+    ReadWriteLock lock;
+
+public:
+    /**
+     * An iterator over all tuples of the table.
+     */
+    class iterator : public std::iterator<std::forward_iterator_tag, Tuple> {
+        const slot* slots = nullptr;
+        std::size_t capacity = 0;
+        std::size_t pos = 0;
+        const entry* cur = nullptr;
+
+    public:
+        iterator() = default;
+
+        // creates an iterator pointing to the first tuple stored at or after the given slot
+        iterator(const slot* slots, std::size_t capacity, std::size_t pos)
+                : slots(slots), capacity(capacity), pos(pos) {
+            skipEmpty();
+        }
+
+        bool operator==(const iterator& other) const {
+            return cur == other.cur && pos == other.pos;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+        const Tuple& operator*() const {
+            return cur->tuple;
+        }
+
+        const Tuple* operator->() const {
+            return &cur->tuple;
+        }
+
+        iterator& operator++() {
+            cur = cur->next;
+            if (!cur) {
+                ++pos;
+                skipEmpty();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto res = *this;
+            ++(*this);
+            return res;
+        }
+
+    private:
+        void skipEmpty() {
+            for (; pos < capacity; ++pos) {
+                cur = slots[pos].load(std::memory_order_relaxed);
+                if (cur) return;
+            }
+            cur = nullptr;
+        }
+    };
+
+    /**
+     * An iterator over the tuples sharing a single key.
+     */
+    class local_iterator : public std::iterator<std::forward_iterator_tag, Tuple> {
+        const entry* cur = nullptr;
+
+    public:
+        local_iterator() = default;
+
+        explicit local_iterator(const entry* cur) : cur(cur) {}
+
+        bool operator==(const local_iterator& other) const {
+            return cur == other.cur;
+        }
+
+        bool operator!=(const local_iterator& other) const {
+            return cur != other.cur;
+        }
+
+        const Tuple& operator*() const {
+            return cur->tuple;
+        }
+
+        const Tuple* operator->() const {
+            return &cur->tuple;
+        }
+
+        local_iterator& operator++() {
+            cur = cur->next;
+            return *this;
+        }
+
+        local_iterator operator++(int) {
+            auto res = *this;
+            cur = cur->next;
+            return res;
+        }
+    };
+
+    using const_iterator = iterator;
+
+    hash_table() : slots(newSlots(initialCapacity)), capacity(initialCapacity), numKeys(0), numTuples(0) {}
+
+    hash_table(const hash_table&) = delete;
+    hash_table& operator=(const hash_table&) = delete;
+
+    ~hash_table() {
+        freeEntries();
+    }
+
+    /**
+     * Inserts the given tuple. For tables storing a single tuple per key, the
+     * tuple is not inserted if a tuple of the same key is present.
+     *
+     * @return true if the tuple has been inserted, false otherwise
+     */
+    bool insert(const Tuple& tuple) {
+        entry* fresh = nullptr;
+
+        lock.start_read();
+
+        // reserve a slot for the key before probing, keeping at least half of the slots empty
+        // such that the probe terminates even if other threads insert concurrently
+        while (2 * (numKeys.fetch_add(1, std::memory_order_relaxed) + 1) > capacity) {
+            numKeys.fetch_sub(1, std::memory_order_relaxed);
+            std::size_t full = capacity;
+            lock.end_read();
+            grow(full);
+            lock.start_read();
+        }
+
+        std::size_t pos = getHome(tuple);
+        while (true) {
+            entry* head = slots[pos].load(std::memory_order_acquire);
+
+            // claim an empty slot for the key of the tuple
+            if (!head) {
+                if (!fresh) fresh = new entry{tuple, nullptr};
+                if (slots[pos].compare_exchange_strong(head, fresh, std::memory_order_acq_rel)) {
+                    break;
+                }
+                // the slot has been claimed concurrently, head is now referencing its list
+            }
+
+            // skip slots of other keys
+            if (!equal(head->tuple, tuple)) {
+                pos = (pos + 1) & (capacity - 1);
+                continue;
+            }
+
+            // the key is present, its slot has not been needed
+            numKeys.fetch_sub(1, std::memory_order_relaxed);
+            if (unique) {
+                lock.end_read();
+                delete fresh;
+                return false;
+            }
+
+            // prepend the tuple to the list of its key
+            if (!fresh) fresh = new entry{tuple, nullptr};
+            fresh->next = head;
+            while (!slots[pos].compare_exchange_weak(fresh->next, fresh, std::memory_order_acq_rel)) {
+                // the list has been extended concurrently, fresh->next has been updated
+            }
+            break;
+        }
+
+        numTuples.fetch_add(1, std::memory_order_relaxed);
+        lock.end_read();
+        return true;
+    }
+
+    /**
+     * Determines whether a tuple of the key of the given tuple is present.
+     */
+    bool contains(const Tuple& tuple) const {
+        return findSlot(tuple) != capacity;
+    }
+
+    /**
+     * Obtains an iterator pointing to the first tuple of the key of the given
+     * tuple, or end() if there is none.
+     */
+    iterator find(const Tuple& tuple) const {
+        return iterator(slots.get(), capacity, findSlot(tuple));
+    }
+
+    /**
+     * Obtains the range of tuples sharing the key of the given tuple.
+     */
+    range<local_iterator> equal_range(const Tuple& tuple) const {
+        std::size_t pos = findSlot(tuple);
+        if (pos == capacity) return make_range(local_iterator(), local_iterator());
+        return make_range(local_iterator(slots[pos].load(std::memory_order_acquire)), local_iterator());
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    std::size_t size() const {
+        return numTuples.load(std::memory_order_relaxed);
+    }
+
+    iterator begin() const {
+        return iterator(slots.get(), capacity, 0);
+    }
+
+    iterator end() const {
+        return iterator(slots.get(), capacity, capacity);
+    }
+
+    /**
+     * Splits the stored tuples into up to the given number of ranges covering
+     * disjoint sets of slots, e.g. for processing them in parallel.
+     */
+    std::vector<range<iterator>> partition(std::size_t num) const {
+        std::vector<range<iterator>> res;
+        num = std::max<std::size_t>(1, std::min(num, capacity));
+        iterator a = begin();
+        for (std::size_t i = 1; i <= num; ++i) {
+            iterator b(slots.get(), capacity, i * capacity / num);
+            if (a != b) res.push_back(make_range(a, b));
+            a = b;
+        }
+        return res;
+    }
+
+    /**
+     * Removes all tuples from this table.
+     */
+    void clear() {
+        freeEntries();
+        slots = newSlots(initialCapacity);
+        capacity = initialCapacity;
+        numKeys = 0;
+        numTuples = 0;
+    }
+
+private:
+    static std::unique_ptr<slot[]> newSlots(std::size_t num) {
+        std::unique_ptr<slot[]> res(new slot[num]);
+        for (std::size_t i = 0; i < num; ++i) {
+            res[i].store(nullptr, std::memory_order_relaxed);
+        }
+        return res;
+    }
+
+    // computes the first slot to be probed for the key of the given tuple
+    std::size_t getHome(const Tuple& tuple) const {
+        // spread the hash value over the upper bits by a Fibonacci hash
+        uint64_t h = static_cast<uint64_t>(hash(tuple)) * 0x9e3779b97f4a7c15ull;
+        return static_cast<std::size_t>(h >> 32) & (capacity - 1);
+    }
+
+    // locates the slot of the key of the given tuple, or capacity if the key is not present
+    std::size_t findSlot(const Tuple& tuple) const {
+        for (std::size_t pos = getHome(tuple);; pos = (pos + 1) & (capacity - 1)) {
+            const entry* head = slots[pos].load(std::memory_order_acquire);
+            if (!head) return capacity;
+            if (equal(head->tuple, tuple)) return pos;
+        }
+    }
+
+    // doubles the number of slots unless another thread did so since it has been observed to be full
+    void grow(std::size_t full) {
+        lock.start_write();
+        if (capacity == full) {
+            std::size_t num = capacity * 2;
+            auto fresh = newSlots(num);
+            std::swap(slots, fresh);
+            std::swap(capacity, num);
+
+            // move the lists to their new slots
+            for (std::size_t i = 0; i < num; ++i) {
+                entry* head = fresh[i].load(std::memory_order_relaxed);
+                if (!head) continue;
+                std::size_t pos = getHome(head->tuple);
+                while (slots[pos].load(std::memory_order_relaxed)) {
+                    pos = (pos + 1) & (capacity - 1);
+                }
+                slots[pos].store(head, std::memory_order_relaxed);
+            }
+        }
+        lock.end_write();
+    }
+
+    void freeEntries() {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            entry* cur = slots[i].load(std::memory_order_relaxed);
+            while (cur) {
+                entry* next = cur->next;
+                delete cur;
+                cur = next;
+            }
+        }
+    }
+};
+
+}  // end of namespace detail
+
+/**
+ * A concurrent hash set of tuples, considering two tuples equal if they agree on
+ * the columns covered by the given hash and equality functions.
+ */
+template <typename Tuple, typename Hash, typename Equal>
+class hash_set : public detail::hash_table<Tuple, Hash, Equal, true> {};
+
+/**
+ * A concurrent hash multiset of tuples, grouping tuples by the columns covered
+ * by the given hash and equality functions. Tuples of equal key are enumerated
+ * by equal_range().
+ */
+template <typename Tuple, typename Hash, typename Equal>
+class hash_multiset : public detail::hash_table<Tuple, Hash, Equal, false> {};
+
 }  // end of namespace ram
 }  // end of namespace souffle
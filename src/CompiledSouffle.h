@@ -28,6 +28,7 @@
 #include "souffle/ParallelUtils.h"
 #include "souffle/ProfileEvent.h"
 #include "souffle/RamTypes.h"
+#include "souffle/ResourceLimits.h"
 #include "souffle/SignalHandler.h"
 #include "souffle/SouffleInterface.h"
 #include "souffle/SymbolMask.h"
@@ -39,6 +40,7 @@
 #include "souffle/Mpi.h"
 #endif
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cassert>
@@ -68,15 +70,20 @@ inline souffle::SouffleProgram* getInstance(const char* p) {
 /**
  * Relation wrapper used internally in the generated Datalog program
  */
-template <uint32_t id, class RelType, class TupleType, size_t Arity, bool IsInputRel, bool IsOutputRel>
+template <uint32_t id, class RelType, class TupleType, size_t Arity, bool IsInputRel, bool IsOutputRel,
+        class DeltaType = RelType>
 class RelationWrapper : public Relation {
 private:
     RelType& relation;
+    DeltaType* delta = nullptr;
     SymbolTable& symTable;
     std::string name;
     std::array<const char*, Arity> tupleType;
     std::array<const char*, Arity> tupleName;
 
+    /** Number of tuples transposed at once when inserting columns in bulk */
+    static constexpr size_t COLUMN_BATCH_SIZE = 1 << 16;
+
     class iterator_wrapper : public iterator_base {
         typename RelType::iterator it;
         const Relation* relation;
@@ -106,10 +113,77 @@ private:
         }
     };
 
+    using chunk_type = typename decltype(std::declval<RelType&>().partition())::value_type;
+
+    /** A part of the relation given by a sequence of its chunks, which are consumed while reading */
+    class partition_wrapper : public partition {
+        std::vector<chunk_type> chunks;
+        size_t chunk = 0;
+
+    public:
+        partition_wrapper(std::vector<chunk_type> c) : chunks(std::move(c)) {}
+        size_t readRows(RamDomain* rows, size_t count) override {
+            size_t n = 0;
+            while (n < count && chunk < chunks.size()) {
+                auto& cur = chunks[chunk];
+                if (cur.empty()) {
+                    chunk++;
+                    continue;
+                }
+                for (size_t i = 0; i < Arity; i++) {
+                    rows[n * Arity + i] = (*cur.begin())[i];
+                }
+                ++cur.begin();
+                n++;
+            }
+            return n;
+        }
+    };
+
+    /** Insert tuples stored row by row, recording new tuples in the given delta relation if any */
+    void insertRows(const RamDomain* rows, size_t count, DeltaType* added) {
+        if (added == nullptr) {
+            bulkInsertRows(rows, count, 0);
+            return;
+        }
+        insertTuples(rows, count, added);
+    }
+
+    /** Insert tuples stored row by row through the bulk insertion of the relation */
+    template <typename R = RelType>
+    auto bulkInsertRows(const RamDomain* rows, size_t count, int)
+            -> decltype(std::declval<R&>().insertRows(rows, count), void()) {
+        relation.insertRows(rows, count);
+    }
+
+    /** Insert tuples stored row by row into a relation without bulk insertion, one at a time */
+    void bulkInsertRows(const RamDomain* rows, size_t count, long) {
+        insertTuples(rows, count, nullptr);
+    }
+
+    /** Insert tuples stored row by row one at a time, recording new tuples in the given delta relation */
+    void insertTuples(const RamDomain* rows, size_t count, DeltaType* added) {
+        // a context keeps the hints of the relation across the inserted tuples
+        auto ctxt = relation.createContext();
+        TupleType t;
+        for (size_t n = 0; n < count; n++) {
+            for (size_t i = 0; i < Arity; i++) {
+                t[i] = rows[n * Arity + i];
+            }
+            if (relation.insert(t, ctxt) && added != nullptr) {
+                added->insert(t);
+            }
+        }
+    }
+
 public:
     RelationWrapper(RelType& r, SymbolTable& s, std::string name, const std::array<const char*, Arity>& t,
             const std::array<const char*, Arity>& n)
             : relation(r), symTable(s), name(std::move(name)), tupleType(t), tupleName(n) {}
+    /** Record tuples newly inserted through this wrapper in the given relation as well */
+    void setDeltaRelation(DeltaType* d) {
+        delta = d;
+    }
     iterator begin() const override {
         return iterator(new iterator_wrapper(id, this, relation.begin()));
     }
@@ -122,7 +196,9 @@ public:
         for (size_t i = 0; i < Arity; i++) {
             t[i] = arg[i];
         }
-        relation.insert(t);
+        if (relation.insert(t) && delta != nullptr) {
+            delta->insert(t);
+        }
     }
     bool contains(const tuple& arg) const override {
         TupleType t;
@@ -132,6 +208,71 @@ public:
         }
         return relation.contains(t);
     }
+    void insertRows(const RamDomain* rows, size_t count) override {
+        insertRows(rows, count, delta);
+    }
+    void restoreRows(const RamDomain* rows, size_t count) override {
+        insertRows(rows, count, nullptr);
+    }
+    void insertColumns(const RamDomain* const* columns, size_t count) override {
+        if (delta == nullptr) {
+            // transpose bounded batches of tuples into rows for the bulk insertion
+            std::vector<RamDomain> rows;
+            for (size_t first = 0; first < count; first += COLUMN_BATCH_SIZE) {
+                const size_t num = (count - first < COLUMN_BATCH_SIZE) ? count - first : COLUMN_BATCH_SIZE;
+                rows.resize(num * Arity);
+                for (size_t n = 0; n < num; n++) {
+                    for (size_t i = 0; i < Arity; i++) {
+                        rows[n * Arity + i] = columns[i][first + n];
+                    }
+                }
+                bulkInsertRows(rows.data(), num, 0);
+            }
+            return;
+        }
+        auto ctxt = relation.createContext();
+        TupleType t;
+        for (size_t n = 0; n < count; n++) {
+            for (size_t i = 0; i < Arity; i++) {
+                t[i] = columns[i][n];
+            }
+            if (relation.insert(t, ctxt) && delta != nullptr) {
+                delta->insert(t);
+            }
+        }
+    }
+    size_t exportRows(RamDomain* rows) const override {
+        size_t n = 0;
+        for (const auto& cur : relation) {
+            for (size_t i = 0; i < Arity; i++) {
+                rows[n * Arity + i] = cur[i];
+            }
+            n++;
+        }
+        return n;
+    }
+    size_t exportColumns(RamDomain* const* columns) const override {
+        size_t n = 0;
+        for (const auto& cur : relation) {
+            for (size_t i = 0; i < Arity; i++) {
+                columns[i][n] = cur[i];
+            }
+            n++;
+        }
+        return n;
+    }
+    std::vector<std::unique_ptr<partition>> getPartitions(size_t num) const override {
+        // distribute the chunks of the relation evenly among the parts
+        auto chunks = relation.partition();
+        std::vector<std::unique_ptr<partition>> res;
+        num = std::max<size_t>(1, std::min(num, chunks.size()));
+        for (size_t k = 0; k < num; k++) {
+            auto first = chunks.begin() + chunks.size() * k / num;
+            auto last = chunks.begin() + chunks.size() * (k + 1) / num;
+            res.push_back(std::make_unique<partition_wrapper>(std::vector<chunk_type>(first, last)));
+        }
+        return res;
+    }
     bool isInput() const override {
         return IsInputRel;
     }
@@ -203,14 +344,14 @@ public:
     iterator end() const {
         return iterator();
     }
-    void insert(const t_tuple& t) {
-        data = true;
+    bool insert(const t_tuple& t) {
+        return insert();
     }
-    void insert(const t_tuple& t, context& /* ctxt */) {
-        data = true;
+    bool insert(const t_tuple& t, context& /* ctxt */) {
+        return insert();
     }
-    void insert(const RamDomain* ramDomain) {
-        data = true;
+    bool insert(const RamDomain* ramDomain) {
+        return insert();
     }
     template <typename T>
     void insertAll(T& other) {
@@ -235,6 +376,13 @@ public:
     bool empty() const {
         return !data;
     }
+    std::vector<range<iterator>> partition() const {
+        std::vector<range<iterator>> res;
+        if (data) {
+            res.push_back(make_range(begin(), end()));
+        }
+        return res;
+    }
     void purge() {
         data = false;
     }
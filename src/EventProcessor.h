@@ -23,6 +23,7 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "ProfileDatabase.h"
@@ -511,6 +512,45 @@ public:
     }
 } frequencyAtomProcessor;
 
+/**
+ * Selectivity Atom Processor
+ */
+const class SelectivityAtomProcessor : public EventProcessor {
+public:
+    SelectivityAtomProcessor() {
+        EventProcessorSingleton::instance().registerEventProcessor("@selectivity-atom", this);
+    }
+    /** process event input */
+    void process(ProfileDatabase& db, const std::vector<std::string>& signature, va_list& args) override {
+        const std::string& relation = signature[1];
+        const std::string& version = signature[2];
+        const std::string& rule = signature[3];
+        const std::string& atom = signature[4];
+        const std::string& originalRule = signature[5];
+        size_t searches = va_arg(args, size_t);
+        size_t hits = va_arg(args, size_t);
+        size_t visited = va_arg(args, size_t);
+        size_t passed = va_arg(args, size_t);
+        size_t iteration = va_arg(args, size_t);
+        std::vector<std::string> path;
+        // non-recursive rule
+        if (rule == originalRule) {
+            path = {"program", "relation", relation, "non-recursive-rule", rule, "atom-frequency", rule,
+                    atom};
+        } else {
+            path = {"program", "relation", relation, "iteration", std::to_string(iteration), "recursive-rule",
+                    originalRule, version, "atom-frequency", rule, atom};
+        }
+        const std::vector<std::pair<std::string, size_t>> counters = {
+                {"searches", searches}, {"hits", hits}, {"visited", visited}, {"passed", passed}};
+        for (const auto& counter : counters) {
+            path.push_back(counter.first);
+            db.addSizeEntry(path, counter.second);
+            path.pop_back();
+        }
+    }
+} selectivityAtomProcessor;
+
 /**
  * Config entry processor
  */
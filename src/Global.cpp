@@ -109,15 +109,13 @@ void MainConfig::processArgs(int argc, char** argv, const std::string& header, c
         option longNames[mainOptions.size()];
         // string of short names for classic getopt processing
         std::string shortNames = "";
-        // table to map the short name to its option
-        std::map<const char, const MainOption*> optionTable;
+        // table to map the short name, or the value standing in for a missing one, to its option
+        std::map<int, const MainOption*> optionTable;
         // counter to be incremented at each loop
         int i = 0;
         // iterate over the options provided
         for (const MainOption& opt : mainOptions) {
             assert(opt.shortName != '?' && "short name for option cannot be '?'");
-            // put the option in the table, referenced by its short name
-            optionTable[opt.shortName] = &opt;
             // set the default value for the option, if it exists
             if (!opt.byDefault.empty()) {
                 set(opt.longName, opt.byDefault);
@@ -126,13 +124,19 @@ void MainConfig::processArgs(int argc, char** argv, const std::string& header, c
             if (opt.longName.empty()) {
                 continue;
             }
+            // options without a short name are identified by a value beyond those of characters
+            int value = (opt.shortName != '\0') ? opt.shortName : 256 + i;
+            // put the option in the table, referenced by its short name
+            optionTable[value] = &opt;
             // convert the main option to a plain old getopt option and put it in the array
-            longNames[i] = (option){opt.longName.c_str(), (!opt.argument.empty()), nullptr, opt.shortName};
+            longNames[i] = (option){opt.longName.c_str(), (!opt.argument.empty()), nullptr, value};
             // append the short name of the option to the string of short names
-            shortNames += opt.shortName;
-            // indicating with a ':' if it takes an argument
-            if (!opt.argument.empty()) {
-                shortNames += ":";
+            if (opt.shortName != '\0') {
+                shortNames += opt.shortName;
+                // indicating with a ':' if it takes an argument
+                if (!opt.argument.empty()) {
+                    shortNames += ":";
+                }
             }
             // increment counter
             ++i;
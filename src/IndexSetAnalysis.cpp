@@ -16,6 +16,7 @@
 
 #include "IndexSetAnalysis.h"
 #include "Global.h"
+#include "ProfileUse.h"
 #include "RamCondition.h"
 #include "RamNode.h"
 #include "RamOperation.h"
@@ -145,11 +146,16 @@ void IndexSet::solve() {
             return false;
         }
 
-        if (rrel.isHashset() || Global::config().get("data-structure") == "hashset") {
+        if (rrel.isHashset()) {
             return true;
         }
 
-        return false;
+        // a data structure chosen from a profile overrides the data structure command line flag
+        if (!representation.empty()) {
+            return representation == "hashset";
+        }
+
+        return Global::config().get("data-structure") == "hashset";
     }(relation);
 
     // check whether one of the naive indexers should be used
@@ -312,6 +318,13 @@ void IndexSetAnalysis::run(const RamTranslationUnit& translationUnit) {
         }
     });
 
+    // choose data structures from the profile of a previous run; they determine the indexes
+    if (const ProfileUse* profile = ProfileUse::getInstance()) {
+        if (!Global::config().has("provenance")) {
+            chooseRepresentations(*profile);
+        }
+    }
+
     // find optimal indexes for relations
     for (auto& cur : data) {
         IndexSet& indexes = cur.second;
@@ -319,6 +332,61 @@ void IndexSetAnalysis::run(const RamTranslationUnit& translationUnit) {
     }
 }
 
+void IndexSetAnalysis::chooseRepresentations(const ProfileUse& profile) {
+    // temporary relations, such as @delta_R and @new_R, are profiled as their relation R
+    auto getBaseName = [](const std::string& name) {
+        if (name.empty() || name[0] != '@') {
+            return name;
+        }
+        return name.substr(name.find('_') + 1);
+    };
+
+    // a relation and its temporary relations share their data structure, hence their searches
+    std::map<std::string, std::set<SearchColumns>> searches;
+    for (const auto& cur : data) {
+        const auto& relSearches = cur.second.getSearches();
+        searches[getBaseName(cur.first)].insert(relSearches.begin(), relSearches.end());
+    }
+
+    for (auto& cur : data) {
+        IndexSet& indexes = cur.second;
+        const RamRelation& rel = indexes.getRelation();
+
+        // data structures given by qualifiers are kept
+        if (rel.getArity() == 0 || rel.isBTree() || rel.isBrie() || rel.isEqRel() || rel.isRbtset() ||
+                rel.isHashset()) {
+            continue;
+        }
+
+        // small relations perform well with any data structure
+        const std::string baseName = getBaseName(cur.first);
+        if (profile.getRelationSize(baseName) < MIN_PROFILED_SIZE) {
+            continue;
+        }
+
+        // searches sharing a prefix are answered by a single ordered index, whereas
+        // a hash index answers exactly one search
+        const std::set<SearchColumns>& relSearches = searches[baseName];
+        bool sharedPrefix = false;
+        for (auto a : relSearches) {
+            for (auto b : relSearches) {
+                sharedPrefix = sharedPrefix || IndexSet::isStrictSubset(a, b);
+            }
+        }
+
+        if (!sharedPrefix) {
+            // equality lookups only
+            indexes.setRepresentation("hashset");
+        } else if (rel.getArity() <= 2) {
+            // tries store shared prefixes only once
+            indexes.setRepresentation("brie");
+        } else if (rel.getArity() <= 6) {
+            // range searches on prefixes of an order
+            indexes.setRepresentation("btree");
+        }
+    }
+}
+
 /** Print indexes */
 void IndexSetAnalysis::print(std::ostream& os) const {
     os << "------ Auto-Index-Generation Report -------\n";
@@ -342,6 +410,10 @@ void IndexSetAnalysis::print(std::ostream& os) const {
             os << "\n";
         }
 
+        if (!indexes.getRepresentation().empty()) {
+            os << "\tData Structure: " << indexes.getRepresentation() << "\n";
+        }
+
         os << "\tNumber of Indexes: " << indexes.getAllOrders().size() << "\n";
         for (auto& order : indexes.getAllOrders()) {
             os << "\t\t";
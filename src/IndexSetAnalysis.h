@@ -39,6 +39,7 @@
 
 namespace souffle {
 
+class ProfileUse;
 class RamTranslationUnit;
 
 /**
@@ -112,6 +113,7 @@ protected:
     ChainOrderMap chainToOrder;   // maps order index to set of searches covered by chain
     MaxMatching matching;         // matching problem for finding minimal number of orders
     const RamRelation& relation;  // relation
+    std::string representation;   // data structure chosen from a profile, empty if none was chosen
 
 public:
     IndexSet(const RamRelation& rel) : relation(rel) {}
@@ -132,6 +134,16 @@ public:
         return searches;
     }
 
+    /** Get the data structure chosen from a profile, or the empty string if none was chosen */
+    const std::string& getRepresentation() const {
+        return representation;
+    }
+
+    /** Set the data structure of the relation */
+    void setRepresentation(const std::string& rep) {
+        representation = rep;
+    }
+
     /** Get index for a search */
     const LexicographicalOrder getLexOrder(SearchColumns cols) const {
         int idx = map(cols);
@@ -157,6 +169,12 @@ public:
     /** map the keys in the key set to lexicographical order */
     void solve();
 
+    /** determine if key a is a strict subset of key b*/
+    static bool isStrictSubset(SearchColumns a, SearchColumns b) {
+        auto tt = static_cast<SearchColumns>(std::numeric_limits<SearchColumns>::max());
+        return (~(a) | (b)) == tt && a != b;
+    }
+
     /** convert from a representation of A verticies to B verticies */
     static SearchColumns toB(SearchColumns a) {
         SearchColumns msb = 1;
@@ -198,12 +216,6 @@ protected:
         abort();
     }
 
-    /** determine if key a is a strict subset of key b*/
-    static bool isStrictSubset(SearchColumns a, SearchColumns b) {
-        auto tt = static_cast<SearchColumns>(std::numeric_limits<SearchColumns>::max());
-        return (~(a) | (b)) == tt && a != b;
-    }
-
     /** insert an index based on the delta*/
     void insertIndex(std::vector<int>& ids, SearchColumns delta) {
         int pos = 0;
@@ -248,6 +260,12 @@ class IndexSetAnalysis : public RamAnalysis {
 private:
     std::map<std::string, IndexSet> data;
 
+    /** Relations with fewer tuples in a profile keep their default data structure */
+    static const size_t MIN_PROFILED_SIZE = 1000;
+
+    /** Choose the data structures of relations from the profile of a previous run */
+    void chooseRepresentations(const ProfileUse& profile);
+
 public:
     static constexpr const char* name = "index-analysis";
 
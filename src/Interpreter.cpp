@@ -20,6 +20,7 @@
 #include "Global.h"
 #include "IODirectives.h"
 #include "IOSystem.h"
+#include "IndexSetAnalysis.h"
 #include "InterpreterIndex.h"
 #include "InterpreterRecords.h"
 #include "LogStatement.h"
@@ -44,6 +45,7 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <regex>
 #include <stdexcept>
 #include <typeinfo>
@@ -51,572 +53,796 @@
 
 namespace souffle {
 
-/** Evaluate RAM Value */
-RamDomain Interpreter::evalVal(const RamValue& value, const InterpreterContext& ctxt) {
-    class ValueEvaluator : public RamVisitor<RamDomain> {
+/** Number of chunks the outermost scan of a loop nest is split into for parallel evaluation */
+static const size_t NUM_PARTITIONS = 400;
+
+/** Maximal number of scans of a loop nest whose orders are chosen adaptively */
+static const size_t MAX_ADAPTIVE_SCANS = 4;
+
+/** Determines whether the caller already is a member of a team of parallel threads */
+static bool isInParallelRegion() {
+#ifdef _OPENMP
+    return omp_in_parallel();
+#else
+    return false;
+#endif
+}
+
+/** Process the search for the tuples of each partition of a scan in parallel */
+template <typename Search, typename Partitions>
+static void visitPartitions(
+        const Search& search, size_t level, const InterpreterContext& ctxt, Partitions& partitions) {
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < partitions.size(); i++) {
+        try {
+            // each worker operates on its own copy of the environment
+            InterpreterContext local(ctxt);
+            for (const RamDomain* cur : partitions[i]) {
+                local[level] = cur;
+                search(local);
+            }
+        } catch (std::exception& e) {
+            SignalHandler::instance()->error(e.what());
+        }
+    }
+}
+
+/** Lower RAM Value */
+Interpreter::ValueClosure Interpreter::lowerVal(const RamValue& value) {
+    class ValueLowering : public RamVisitor<ValueClosure> {
         Interpreter& interpreter;
-        const InterpreterContext& ctxt;
 
     public:
-        ValueEvaluator(Interpreter& interp, const InterpreterContext& ctxt)
-                : interpreter(interp), ctxt(ctxt) {}
+        ValueLowering(Interpreter& interp) : interpreter(interp) {}
 
-        RamDomain visitNumber(const RamNumber& num) override {
-            return num.getConstant();
+        ValueClosure visitNumber(const RamNumber& num) override {
+            RamDomain constant = num.getConstant();
+            return [constant](const InterpreterContext&) { return constant; };
         }
 
-        RamDomain visitElementAccess(const RamElementAccess& access) override {
-            return ctxt[access.getLevel()][access.getElement()];
+        ValueClosure visitElementAccess(const RamElementAccess& access) override {
+            size_t level = access.getLevel();
+            size_t element = access.getElement();
+            return [level, element](const InterpreterContext& ctxt) { return ctxt[level][element]; };
         }
 
-        RamDomain visitAutoIncrement(const RamAutoIncrement&) override {
-            return interpreter.incCounter();
+        ValueClosure visitAutoIncrement(const RamAutoIncrement&) override {
+            Interpreter& interp = interpreter;
+            return [&interp](const InterpreterContext&) { return interp.incCounter(); };
         }
 
         // unary operators
-        RamDomain visitUnaryOperator(const RamUnaryOperator& op) override {
-            RamDomain arg = visit(op.getValue());
+        ValueClosure visitUnaryOperator(const RamUnaryOperator& op) override {
+            ValueClosure arg = visit(*op.getValue());
+            SymbolTable& symTable = interpreter.getSymbolTable();
             switch (op.getOperator()) {
                 case UnaryOp::NEG:
-                    return -arg;
+                    return [arg](const InterpreterContext& ctxt) { return -arg(ctxt); };
                 case UnaryOp::BNOT:
-                    return ~arg;
+                    return [arg](const InterpreterContext& ctxt) { return ~arg(ctxt); };
                 case UnaryOp::LNOT:
-                    return !arg;
+                    return [arg](const InterpreterContext& ctxt) { return RamDomain(!arg(ctxt)); };
                 case UnaryOp::ORD:
                     return arg;
                 case UnaryOp::STRLEN:
-                    return interpreter.getSymbolTable().resolve(arg).size();
-                case UnaryOp::TONUMBER: {
-                    RamDomain result = 0;
-                    try {
-                        result = stord(interpreter.getSymbolTable().resolve(arg));
-                    } catch (...) {
-                        std::cerr << "error: wrong string provided by to_number(\"";
-                        std::cerr << interpreter.getSymbolTable().resolve(arg);
-                        std::cerr << "\") functor.\n";
-                        raise(SIGFPE);
-                    }
-                    return result;
-                }
+                    return [arg, &symTable](const InterpreterContext& ctxt) {
+                        return RamDomain(symTable.resolve(arg(ctxt)).size());
+                    };
+                case UnaryOp::TONUMBER:
+                    return [arg, &symTable](const InterpreterContext& ctxt) {
+                        RamDomain symbol = arg(ctxt);
+                        RamDomain result = 0;
+                        try {
+                            result = stord(symTable.resolve(symbol));
+                        } catch (...) {
+                            std::cerr << "error: wrong string provided by to_number(\"";
+                            std::cerr << symTable.resolve(symbol);
+                            std::cerr << "\") functor.\n";
+                            raise(SIGFPE);
+                        }
+                        return result;
+                    };
                 case UnaryOp::TOSTRING:
-                    return interpreter.getSymbolTable().lookup(std::to_string(arg));
+                    return [arg, &symTable](const InterpreterContext& ctxt) {
+                        return symTable.lookup(std::to_string(arg(ctxt)));
+                    };
                 default:
                     assert(false && "unsupported operator");
-                    return 0;
+                    return [](const InterpreterContext&) { return RamDomain(0); };
             }
         }
 
         // binary functors
-        RamDomain visitBinaryOperator(const RamBinaryOperator& op) override {
-            RamDomain lhs = visit(op.getLHS());
-            RamDomain rhs = visit(op.getRHS());
+        ValueClosure visitBinaryOperator(const RamBinaryOperator& op) override {
+            ValueClosure lhs = visit(*op.getLHS());
+            ValueClosure rhs = visit(*op.getRHS());
+            SymbolTable& symTable = interpreter.getSymbolTable();
             switch (op.getOperator()) {
-                case BinaryOp::ADD: {
-                    return lhs + rhs;
-                }
-                case BinaryOp::SUB: {
-                    return lhs - rhs;
-                }
-                case BinaryOp::MUL: {
-                    return lhs * rhs;
-                }
-                case BinaryOp::DIV: {
-                    return lhs / rhs;
-                }
-                case BinaryOp::EXP: {
-                    return std::pow(lhs, rhs);
-                }
-                case BinaryOp::MOD: {
-                    return lhs % rhs;
-                }
-                case BinaryOp::BAND: {
-                    return lhs & rhs;
-                }
-                case BinaryOp::BOR: {
-                    return lhs | rhs;
-                }
-                case BinaryOp::BXOR: {
-                    return lhs ^ rhs;
-                }
-                case BinaryOp::LAND: {
-                    return lhs && rhs;
-                }
-                case BinaryOp::LOR: {
-                    return lhs || rhs;
-                }
-                case BinaryOp::MAX: {
-                    return std::max(lhs, rhs);
-                }
-                case BinaryOp::MIN: {
-                    return std::min(lhs, rhs);
-                }
-                case BinaryOp::CAT: {
-                    return interpreter.getSymbolTable().lookup(interpreter.getSymbolTable().resolve(lhs) +
-                                                               interpreter.getSymbolTable().resolve(rhs));
-                }
+                case BinaryOp::ADD:
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) + rhs(ctxt); };
+                case BinaryOp::SUB:
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) - rhs(ctxt); };
+                case BinaryOp::MUL:
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) * rhs(ctxt); };
+                case BinaryOp::DIV:
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) / rhs(ctxt); };
+                case BinaryOp::EXP:
+                    return [lhs, rhs](const InterpreterContext& ctxt) {
+                        return RamDomain(std::pow(lhs(ctxt), rhs(ctxt)));
+                    };
+                case BinaryOp::MOD:
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) % rhs(ctxt); };
+                case BinaryOp::BAND:
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) & rhs(ctxt); };
+                case BinaryOp::BOR:
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) | rhs(ctxt); };
+                case BinaryOp::BXOR:
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) ^ rhs(ctxt); };
+                case BinaryOp::LAND:
+                    return [lhs, rhs](const InterpreterContext& ctxt) {
+                        return RamDomain(lhs(ctxt) && rhs(ctxt));
+                    };
+                case BinaryOp::LOR:
+                    return [lhs, rhs](const InterpreterContext& ctxt) {
+                        return RamDomain(lhs(ctxt) || rhs(ctxt));
+                    };
+                case BinaryOp::MAX:
+                    return [lhs, rhs](
+                                   const InterpreterContext& ctxt) { return std::max(lhs(ctxt), rhs(ctxt)); };
+                case BinaryOp::MIN:
+                    return [lhs, rhs](
+                                   const InterpreterContext& ctxt) { return std::min(lhs(ctxt), rhs(ctxt)); };
+                case BinaryOp::CAT:
+                    return [lhs, rhs, &symTable](const InterpreterContext& ctxt) {
+                        return symTable.lookup(symTable.resolve(lhs(ctxt)) + symTable.resolve(rhs(ctxt)));
+                    };
                 default:
                     assert(false && "unsupported operator");
-                    return 0;
+                    return [](const InterpreterContext&) { return RamDomain(0); };
             }
         }
 
         // ternary operators
-        RamDomain visitTernaryOperator(const RamTernaryOperator& op) override {
+        ValueClosure visitTernaryOperator(const RamTernaryOperator& op) override {
+            SymbolTable& symTable = interpreter.getSymbolTable();
             switch (op.getOperator()) {
                 case TernaryOp::SUBSTR: {
-                    auto symbol = visit(op.getArg(0));
-                    const std::string& str = interpreter.getSymbolTable().resolve(symbol);
-                    auto idx = visit(op.getArg(1));
-                    auto len = visit(op.getArg(2));
-                    std::string sub_str;
-                    try {
-                        sub_str = str.substr(idx, len);
-                    } catch (...) {
-                        std::cerr << "warning: wrong index position provided by substr(\"";
-                        std::cerr << str << "\"," << (int32_t)idx << "," << (int32_t)len << ") functor.\n";
-                    }
-                    return interpreter.getSymbolTable().lookup(sub_str);
+                    ValueClosure symbol = visit(*op.getArg(0));
+                    ValueClosure index = visit(*op.getArg(1));
+                    ValueClosure length = visit(*op.getArg(2));
+                    return [symbol, index, length, &symTable](const InterpreterContext& ctxt) {
+                        const std::string& str = symTable.resolve(symbol(ctxt));
+                        auto idx = index(ctxt);
+                        auto len = length(ctxt);
+                        std::string sub_str;
+                        try {
+                            sub_str = str.substr(idx, len);
+                        } catch (...) {
+                            std::cerr << "warning: wrong index position provided by substr(\"";
+                            std::cerr << str << "\"," << (int32_t)idx << "," << (int32_t)len
+                                      << ") functor.\n";
+                        }
+                        return symTable.lookup(sub_str);
+                    };
                 }
                 default:
                     assert(false && "unsupported operator");
-                    return 0;
+                    return [](const InterpreterContext&) { return RamDomain(0); };
             }
         }
 
         // -- records --
-        RamDomain visitPack(const RamPack& op) override {
-            auto values = op.getValues();
-            auto arity = values.size();
-            RamDomain data[arity];
-            for (size_t i = 0; i < arity; ++i) {
-                data[i] = visit(values[i]);
+        ValueClosure visitPack(const RamPack& op) override {
+            std::vector<ValueClosure> values;
+            for (const RamValue* cur : op.getValues()) {
+                values.push_back(visit(*cur));
             }
-            return pack(data, arity);
+            RecordMap* records = &getRecordMap(values.size());
+            return [values, records](const InterpreterContext& ctxt) {
+                auto arity = values.size();
+                RamDomain data[arity];
+                for (size_t i = 0; i < arity; ++i) {
+                    data[i] = values[i](ctxt);
+                }
+                return records->pack(data);
+            };
         }
 
         // -- subroutine argument
-        RamDomain visitArgument(const RamArgument& arg) override {
-            return ctxt.getArgument(arg.getArgNumber());
+        ValueClosure visitArgument(const RamArgument& arg) override {
+            size_t number = arg.getArgNumber();
+            return [number](const InterpreterContext& ctxt) { return ctxt.getArgument(number); };
         }
 
         // -- safety net --
 
-        RamDomain visitNode(const RamNode& node) override {
+        ValueClosure visitNode(const RamNode& node) override {
             std::cerr << "Unsupported node type: " << typeid(node).name() << "\n";
             assert(false && "Unsupported Node Type!");
-            return 0;
+            return [](const InterpreterContext&) { return RamDomain(0); };
         }
     };
 
-    // create and run evaluator
-    return ValueEvaluator(*this, ctxt)(value);
+    // lower value once
+    return ValueLowering(*this)(value);
 }
 
-/** Evaluate RAM Condition */
-bool Interpreter::evalCond(const RamCondition& cond, const InterpreterContext& ctxt) {
-    class ConditionEvaluator : public RamVisitor<bool> {
+/** Lower RAM Condition */
+Interpreter::ConditionClosure Interpreter::lowerCond(const RamCondition& cond) {
+    class ConditionLowering : public RamVisitor<ConditionClosure> {
         Interpreter& interpreter;
-        const InterpreterContext& ctxt;
 
     public:
-        ConditionEvaluator(Interpreter& interp, const InterpreterContext& ctxt)
-                : interpreter(interp), ctxt(ctxt) {}
+        ConditionLowering(Interpreter& interp) : interpreter(interp) {}
+
+        /** Lower the values of a pattern, leaving unbound columns empty */
+        std::vector<ValueClosure> lowerPattern(const std::vector<RamValue*>& values) {
+            std::vector<ValueClosure> res;
+            for (const RamValue* cur : values) {
+                res.push_back(cur ? interpreter.lowerVal(*cur) : ValueClosure());
+            }
+            return res;
+        }
 
         // -- connectors operators --
 
-        bool visitAnd(const RamAnd& a) override {
-            return visit(a.getLHS()) && visit(a.getRHS());
+        ConditionClosure visitAnd(const RamAnd& a) override {
+            ConditionClosure lhs = visit(a.getLHS());
+            ConditionClosure rhs = visit(a.getRHS());
+            return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) && rhs(ctxt); };
         }
 
         // -- relation operations --
 
-        bool visitEmpty(const RamEmpty& empty) override {
-            const InterpreterRelation& rel = interpreter.getRelation(empty.getRelation());
-            return rel.empty();
+        ConditionClosure visitEmpty(const RamEmpty& empty) override {
+            auto rel = interpreter.getRelationHandle(empty.getRelation());
+            return [rel](const InterpreterContext&) { return (*rel)->empty(); };
         }
 
-        bool visitNotExists(const RamNotExists& ne) override {
-            const InterpreterRelation& rel = interpreter.getRelation(ne.getRelation());
-
-            // construct the pattern tuple
-            auto arity = rel.getArity();
-            auto values = ne.getValues();
+        ConditionClosure visitNotExists(const RamNotExists& ne) override {
+            auto rel = interpreter.getRelationHandle(ne.getRelation());
+            auto arity = ne.getRelation().getArity();
+            auto values = lowerPattern(ne.getValues());
 
             // for total we use the exists test
             if (ne.isTotal()) {
-                RamDomain tuple[arity];
-                for (size_t i = 0; i < arity; i++) {
-                    tuple[i] = (values[i]) ? interpreter.evalVal(*values[i], ctxt) : MIN_RAM_DOMAIN;
-                }
-
-                return !rel.exists(tuple);
+                return [rel, arity, values](const InterpreterContext& ctxt) {
+                    RamDomain tuple[arity];
+                    for (size_t i = 0; i < arity; i++) {
+                        tuple[i] = (values[i]) ? values[i](ctxt) : MIN_RAM_DOMAIN;
+                    }
+                    return !(*rel)->exists(tuple);
+                };
             }
 
             // for partial we search for lower and upper boundaries
-            RamDomain low[arity];
-            RamDomain high[arity];
-            for (size_t i = 0; i < arity; i++) {
-                low[i] = (values[i]) ? interpreter.evalVal(*values[i], ctxt) : MIN_RAM_DOMAIN;
-                high[i] = (values[i]) ? low[i] : MAX_RAM_DOMAIN;
-            }
+            auto indexHandle = std::make_shared<InterpreterIndexHandle>(rel, ne.getKey());
+            return [indexHandle, arity, values](const InterpreterContext& ctxt) {
+                RamDomain low[arity];
+                RamDomain high[arity];
+                for (size_t i = 0; i < arity; i++) {
+                    low[i] = (values[i]) ? values[i](ctxt) : MIN_RAM_DOMAIN;
+                    high[i] = (values[i]) ? low[i] : MAX_RAM_DOMAIN;
+                }
 
-            // obtain index
-            auto idx = rel.getIndex(ne.getKey());
-            auto range = idx->lowerUpperBound(low, high);
-            return range.first == range.second;  // if there are none => done
+                // obtain index
+                auto idx = indexHandle->get();
+                auto range = idx->lowerUpperBound(low, high);
+                return range.first == range.second;  // if there are none => done
+            };
         }
 
-        bool visitProvenanceNotExists(const RamProvenanceNotExists& ne) override {
-            const InterpreterRelation& rel = interpreter.getRelation(ne.getRelation());
-
-            // construct the pattern tuple
-            auto arity = rel.getArity();
-            auto values = ne.getValues();
+        ConditionClosure visitProvenanceNotExists(const RamProvenanceNotExists& ne) override {
+            auto rel = interpreter.getRelationHandle(ne.getRelation());
+            auto arity = ne.getRelation().getArity();
+            auto values = lowerPattern(ne.getValues());
+            auto indexHandle = std::make_shared<InterpreterIndexHandle>(rel, ne.getKey());
 
             // for partial we search for lower and upper boundaries
-            RamDomain low[arity];
-            RamDomain high[arity];
-            for (size_t i = 0; i < arity - 2; i++) {
-                low[i] = (values[i]) ? interpreter.evalVal(*values[i], ctxt) : MIN_RAM_DOMAIN;
-                high[i] = (values[i]) ? low[i] : MAX_RAM_DOMAIN;
-            }
+            return [indexHandle, arity, values](const InterpreterContext& ctxt) {
+                RamDomain low[arity];
+                RamDomain high[arity];
+                for (size_t i = 0; i < arity - 2; i++) {
+                    low[i] = (values[i]) ? values[i](ctxt) : MIN_RAM_DOMAIN;
+                    high[i] = (values[i]) ? low[i] : MAX_RAM_DOMAIN;
+                }
 
-            low[arity - 2] = MIN_RAM_DOMAIN;
-            low[arity - 1] = MIN_RAM_DOMAIN;
-            high[arity - 2] = MAX_RAM_DOMAIN;
-            high[arity - 1] = MAX_RAM_DOMAIN;
+                low[arity - 2] = MIN_RAM_DOMAIN;
+                low[arity - 1] = MIN_RAM_DOMAIN;
+                high[arity - 2] = MAX_RAM_DOMAIN;
+                high[arity - 1] = MAX_RAM_DOMAIN;
 
-            // obtain index
-            auto idx = rel.getIndex(ne.getKey());
-            auto range = idx->lowerUpperBound(low, high);
-            return range.first == range.second;  // if there are none => done
+                // obtain index
+                auto idx = indexHandle->get();
+                auto range = idx->lowerUpperBound(low, high);
+                return range.first == range.second;  // if there are none => done
+            };
         }
 
         // -- comparison operators --
-        bool visitBinaryRelation(const RamBinaryRelation& relOp) override {
-            RamDomain lhs = interpreter.evalVal(*relOp.getLHS(), ctxt);
-            RamDomain rhs = interpreter.evalVal(*relOp.getRHS(), ctxt);
+        ConditionClosure visitBinaryRelation(const RamBinaryRelation& relOp) override {
+            ValueClosure lhs = interpreter.lowerVal(*relOp.getLHS());
+            ValueClosure rhs = interpreter.lowerVal(*relOp.getRHS());
+            SymbolTable& symTable = interpreter.getSymbolTable();
             switch (relOp.getOperator()) {
                 case BinaryConstraintOp::EQ:
-                    return lhs == rhs;
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) == rhs(ctxt); };
                 case BinaryConstraintOp::NE:
-                    return lhs != rhs;
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) != rhs(ctxt); };
                 case BinaryConstraintOp::LT:
-                    return lhs < rhs;
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) < rhs(ctxt); };
                 case BinaryConstraintOp::LE:
-                    return lhs <= rhs;
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) <= rhs(ctxt); };
                 case BinaryConstraintOp::GT:
-                    return lhs > rhs;
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) > rhs(ctxt); };
                 case BinaryConstraintOp::GE:
-                    return lhs >= rhs;
-                case BinaryConstraintOp::MATCH: {
-                    RamDomain l = interpreter.evalVal(*relOp.getLHS(), ctxt);
-                    RamDomain r = interpreter.evalVal(*relOp.getRHS(), ctxt);
-                    const std::string& pattern = interpreter.getSymbolTable().resolve(l);
-                    const std::string& text = interpreter.getSymbolTable().resolve(r);
-                    bool result = false;
-                    try {
-                        result = std::regex_match(text, std::regex(pattern));
-                    } catch (...) {
-                        std::cerr << "warning: wrong pattern provided for match(\"" << pattern << "\",\""
-                                  << text << "\").\n";
-                    }
-                    return result;
-                }
-                case BinaryConstraintOp::NOT_MATCH: {
-                    RamDomain l = interpreter.evalVal(*relOp.getLHS(), ctxt);
-                    RamDomain r = interpreter.evalVal(*relOp.getRHS(), ctxt);
-                    const std::string& pattern = interpreter.getSymbolTable().resolve(l);
-                    const std::string& text = interpreter.getSymbolTable().resolve(r);
-                    bool result = false;
-                    try {
-                        result = !std::regex_match(text, std::regex(pattern));
-                    } catch (...) {
-                        std::cerr << "warning: wrong pattern provided for !match(\"" << pattern << "\",\""
-                                  << text << "\").\n";
-                    }
-                    return result;
-                }
-                case BinaryConstraintOp::CONTAINS: {
-                    RamDomain l = interpreter.evalVal(*relOp.getLHS(), ctxt);
-                    RamDomain r = interpreter.evalVal(*relOp.getRHS(), ctxt);
-                    const std::string& pattern = interpreter.getSymbolTable().resolve(l);
-                    const std::string& text = interpreter.getSymbolTable().resolve(r);
-                    return text.find(pattern) != std::string::npos;
-                }
-                case BinaryConstraintOp::NOT_CONTAINS: {
-                    RamDomain l = interpreter.evalVal(*relOp.getLHS(), ctxt);
-                    RamDomain r = interpreter.evalVal(*relOp.getRHS(), ctxt);
-                    const std::string& pattern = interpreter.getSymbolTable().resolve(l);
-                    const std::string& text = interpreter.getSymbolTable().resolve(r);
-                    return text.find(pattern) == std::string::npos;
-                }
+                    return [lhs, rhs](const InterpreterContext& ctxt) { return lhs(ctxt) >= rhs(ctxt); };
+                case BinaryConstraintOp::MATCH:
+                    return [lhs, rhs, &symTable](const InterpreterContext& ctxt) {
+                        const std::string& pattern = symTable.resolve(lhs(ctxt));
+                        const std::string& text = symTable.resolve(rhs(ctxt));
+                        bool result = false;
+                        try {
+                            result = std::regex_match(text, std::regex(pattern));
+                        } catch (...) {
+                            std::cerr << "warning: wrong pattern provided for match(\"" << pattern << "\",\""
+                                      << text << "\").\n";
+                        }
+                        return result;
+                    };
+                case BinaryConstraintOp::NOT_MATCH:
+                    return [lhs, rhs, &symTable](const InterpreterContext& ctxt) {
+                        const std::string& pattern = symTable.resolve(lhs(ctxt));
+                        const std::string& text = symTable.resolve(rhs(ctxt));
+                        bool result = false;
+                        try {
+                            result = !std::regex_match(text, std::regex(pattern));
+                        } catch (...) {
+                            std::cerr << "warning: wrong pattern provided for !match(\"" << pattern
+                                      << "\",\"" << text << "\").\n";
+                        }
+                        return result;
+                    };
+                case BinaryConstraintOp::CONTAINS:
+                    return [lhs, rhs, &symTable](const InterpreterContext& ctxt) {
+                        const std::string& pattern = symTable.resolve(lhs(ctxt));
+                        const std::string& text = symTable.resolve(rhs(ctxt));
+                        return text.find(pattern) != std::string::npos;
+                    };
+                case BinaryConstraintOp::NOT_CONTAINS:
+                    return [lhs, rhs, &symTable](const InterpreterContext& ctxt) {
+                        const std::string& pattern = symTable.resolve(lhs(ctxt));
+                        const std::string& text = symTable.resolve(rhs(ctxt));
+                        return text.find(pattern) == std::string::npos;
+                    };
                 default:
                     assert(false && "unsupported operator");
-                    return false;
+                    return [](const InterpreterContext&) { return false; };
             }
         }
-        bool visitNode(const RamNode& node) override {
+
+        ConditionClosure visitNode(const RamNode& node) override {
             std::cerr << "Unsupported node type: " << typeid(node).name() << "\n";
             assert(false && "Unsupported Node Type!");
-            return false;
+            return [](const InterpreterContext&) { return false; };
         }
     };
 
-    // run evaluator
-    return ConditionEvaluator(*this, ctxt)(cond);
+    // lower condition once
+    return ConditionLowering(*this)(cond);
 }
 
-/** Evaluate RAM operation */
-void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args) {
-    class OperationEvaluator : public RamVisitor<void> {
+/** Lower RAM operation */
+Interpreter::OperationClosure Interpreter::lowerOp(const RamOperation& op) {
+    class OperationLowering : public RamVisitor<OperationClosure> {
         Interpreter& interpreter;
-        InterpreterContext& ctxt;
+
+        /** whether the outermost scan may be split up among threads */
+        bool parallel;
+
+        /** whether atom frequencies are recorded */
+        bool profile;
 
     public:
-        OperationEvaluator(Interpreter& interp, InterpreterContext& ctxt) : interpreter(interp), ctxt(ctxt) {}
+        OperationLowering(Interpreter& interp, bool parallel)
+                : interpreter(interp), parallel(parallel), profile(Global::config().has("profile")) {}
+
+        /** Lower the values of a range pattern, leaving unbound columns empty */
+        std::vector<ValueClosure> lowerPattern(const std::vector<RamValue*>& values) {
+            std::vector<ValueClosure> res;
+            for (const RamValue* cur : values) {
+                res.push_back(cur ? interpreter.lowerVal(*cur) : ValueClosure());
+            }
+            return res;
+        }
 
         // -- Operations -----------------------------
 
-        void visitSearch(const RamSearch& search) override {
-            // check condition
-            auto condition = search.getCondition();
-            if (!condition || interpreter.evalCond(*condition, ctxt)) {
-                // process nested
-                visit(*search.getNestedOperation());
+        OperationClosure visitSearch(const RamSearch& search) override {
+            OperationClosure nested = visit(*search.getNestedOperation());
+            ConditionClosure condition;
+            if (search.getCondition()) {
+                condition = interpreter.lowerCond(*search.getCondition());
+            }
+
+            // only record frequencies of searches carrying a profile text
+            if (!profile || search.getProfileText().empty()) {
+                if (!condition) {
+                    return nested;
+                }
+                return [nested, condition](InterpreterContext& ctxt) {
+                    if (condition(ctxt)) {
+                        nested(ctxt);
+                    }
+                };
+            }
+
+            const std::string& profileText = search.getProfileText();
+            std::atomic<size_t>* frequency = &interpreter.getFrequencyCounter(profileText);
+            SelectivityCounters* counters = interpreter.selectivity.get();
+            if (counters == nullptr) {
+                return [nested, condition, frequency](InterpreterContext& ctxt) {
+                    // check condition and process nested
+                    if (!condition || condition(ctxt)) {
+                        nested(ctxt);
+                    }
+                    frequency->fetch_add(1, std::memory_order_relaxed);
+                };
             }
 
-            if (Global::config().has("profile") && !search.getProfileText().empty()) {
-                interpreter.frequencies[search.getProfileText()][interpreter.getIterationNumber()]++;
+            // also count the tuples visited and those passing the condition
+            size_t index = interpreter.selectivityIndex.at(profileText);
+            return [nested, condition, frequency, counters, index](InterpreterContext& ctxt) {
+                counters->count(index, SelectivityCounters::VISITED);
+                if (!condition || condition(ctxt)) {
+                    counters->count(index, SelectivityCounters::PASSED);
+                    nested(ctxt);
+                }
+                frequency->fetch_add(1, std::memory_order_relaxed);
+            };
+        }
+
+        /** Get the selectivity counters of a scan, or null if its selectivity is not counted */
+        SelectivityCounters* getSelectivityCounters(const RamScan& scan) {
+            if (!profile || scan.getProfileText().empty()) {
+                return nullptr;
             }
+            return interpreter.selectivity.get();
         }
 
-        void visitScan(const RamScan& scan) override {
+        OperationClosure visitScan(const RamScan& scan) override {
             // get the targeted relation
-            const InterpreterRelation& rel = interpreter.getRelation(scan.getRelation());
+            auto rel = interpreter.getRelationHandle(scan.getRelation());
+            auto level = scan.getLevel();
+            OperationClosure search = visitSearch(scan);
+
+            // the outermost scan binding new values is split up among threads
+            bool partitioned = parallel && level == 0 && !scan.isPureExistenceCheck();
+
+            // count the searches and those finding tuples if the selectivity is profiled
+            SelectivityCounters* counters = getSelectivityCounters(scan);
+            size_t index = counters ? interpreter.selectivityIndex.at(scan.getProfileText()) : 0;
+            auto countSearch = [counters, index](bool hit) {
+                if (counters != nullptr) {
+                    counters->count(index, SelectivityCounters::SEARCHES);
+                    if (hit) {
+                        counters->count(index, SelectivityCounters::HITS);
+                    }
+                }
+            };
 
             // process full scan if no index is given
             if (scan.getRangeQueryColumns() == 0) {
                 // if scan is not binding anything => check for emptiness
-                if (scan.isPureExistenceCheck() && !rel.empty()) {
-                    visitSearch(scan);
-                    return;
+                if (scan.isPureExistenceCheck()) {
+                    return [rel, search, countSearch](InterpreterContext& ctxt) {
+                        countSearch(!(*rel)->empty());
+                        if (!(*rel)->empty()) {
+                            search(ctxt);
+                        }
+                    };
                 }
 
                 // if scan is unrestricted => use simple iterator
-                for (const RamDomain* cur : rel) {
-                    ctxt[scan.getLevel()] = cur;
-                    visitSearch(scan);
-                }
-                return;
+                return [rel, search, level, partitioned, countSearch](
+                               InterpreterContext& ctxt) {
+                    countSearch(!(*rel)->empty());
+
+                    // if this is the outermost scan => split it up among threads
+                    if (partitioned && !isInParallelRegion()) {
+                        auto partitions = (*rel)->partition(NUM_PARTITIONS);
+                        visitPartitions(search, level, ctxt, partitions);
+                        return;
+                    }
+
+                    for (const RamDomain* cur : **rel) {
+                        ctxt[level] = cur;
+                        search(ctxt);
+                    }
+                };
             }
 
             // create pattern tuple for range query
-            auto arity = rel.getArity();
-            RamDomain low[arity];
-            RamDomain hig[arity];
-            auto pattern = scan.getRangePattern();
-            for (size_t i = 0; i < arity; i++) {
-                if (pattern[i] != nullptr) {
-                    low[i] = interpreter.evalVal(*pattern[i], ctxt);
-                    hig[i] = low[i];
-                } else {
-                    low[i] = MIN_RAM_DOMAIN;
-                    hig[i] = MAX_RAM_DOMAIN;
-                }
+            auto arity = scan.getRelation().getArity();
+            auto pattern = lowerPattern(scan.getRangePattern());
+            auto indexHandle = std::make_shared<InterpreterIndexHandle>(rel, scan.getRangeQueryColumns());
+            bool existenceCheck = scan.isPureExistenceCheck();
+            std::atomic<size_t>* frequency = nullptr;
+            if (profile && !scan.getProfileText().empty()) {
+                frequency = &interpreter.getFrequencyCounter(scan.getProfileText());
             }
 
-            // obtain index
-            auto idx = rel.getIndex(scan.getRangeQueryColumns(), nullptr);
+            return [=](InterpreterContext& ctxt) {
+                RamDomain low[arity];
+                RamDomain hig[arity];
+                for (size_t i = 0; i < arity; i++) {
+                    if (pattern[i]) {
+                        low[i] = pattern[i](ctxt);
+                        hig[i] = low[i];
+                    } else {
+                        low[i] = MIN_RAM_DOMAIN;
+                        hig[i] = MAX_RAM_DOMAIN;
+                    }
+                }
+
+                // obtain index
+                auto idx = indexHandle->get();
 
-            // get iterator range
-            auto range = idx->lowerUpperBound(low, hig);
+                // get iterator range
+                auto range = idx->lowerUpperBound(low, hig);
+                countSearch(range.first != range.second);
 
-            // if this scan is not binding anything ...
-            if (scan.isPureExistenceCheck()) {
-                if (range.first != range.second) {
-                    visitSearch(scan);
+                // if this scan is not binding anything ...
+                if (existenceCheck) {
+                    if (range.first != range.second) {
+                        search(ctxt);
+                    }
+                    if (frequency) {
+                        frequency->fetch_add(1, std::memory_order_relaxed);
+                    }
+                    return;
                 }
-                if (Global::config().has("profile") && !scan.getProfileText().empty()) {
-                    interpreter.frequencies[scan.getProfileText()][interpreter.getIterationNumber()]++;
+
+                // if this is the outermost scan => split up the range among threads
+                if (partitioned && !isInParallelRegion()) {
+                    auto partitions = souffle::range<InterpreterIndex::iterator>(range.first, range.second)
+                                              .partition(NUM_PARTITIONS);
+                    visitPartitions(search, level, ctxt, partitions);
+                    return;
                 }
-                return;
-            }
 
-            // conduct range query
-            for (auto ip = range.first; ip != range.second; ++ip) {
-                const RamDomain* data = *(ip);
-                ctxt[scan.getLevel()] = data;
-                visitSearch(scan);
-            }
+                // conduct range query
+                for (auto ip = range.first; ip != range.second; ++ip) {
+                    ctxt[level] = *(ip);
+                    search(ctxt);
+                }
+            };
         }
 
-        void visitLookup(const RamLookup& lookup) override {
-            // get reference
-            RamDomain ref = ctxt[lookup.getReferenceLevel()][lookup.getReferencePosition()];
-
-            // check for null
-            if (isNull(ref)) {
-                return;
-            }
-
-            // update environment variable
+        OperationClosure visitLookup(const RamLookup& lookup) override {
+            auto referenceLevel = lookup.getReferenceLevel();
+            auto referencePosition = lookup.getReferencePosition();
             auto arity = lookup.getArity();
-            const RamDomain* tuple = unpack(ref, arity);
-
-            // save reference to temporary value
-            ctxt[lookup.getLevel()] = tuple;
+            auto level = lookup.getLevel();
+            OperationClosure search = visitSearch(lookup);
+            const RecordMap* records = &getRecordMap(arity);
 
-            // run nested part - using base class visitor
-            visitSearch(lookup);
-        }
+            return [=](InterpreterContext& ctxt) {
+                // get reference
+                RamDomain ref = ctxt[referenceLevel][referencePosition];
 
-        void visitAggregate(const RamAggregate& aggregate) override {
-            // get the targeted relation
-            const InterpreterRelation& rel = interpreter.getRelation(aggregate.getRelation());
-
-            // initialize result
-            RamDomain res = 0;
-            switch (aggregate.getFunction()) {
-                case RamAggregate::MIN:
-                    res = MAX_RAM_DOMAIN;
-                    break;
-                case RamAggregate::MAX:
-                    res = MIN_RAM_DOMAIN;
-                    break;
-                case RamAggregate::COUNT:
-                    res = 0;
-                    break;
-                case RamAggregate::SUM:
-                    res = 0;
-                    break;
-            }
-
-            // init temporary tuple for this level
-            auto arity = rel.getArity();
-
-            // get lower and upper boundaries for iteration
-            const auto& pattern = aggregate.getPattern();
-            RamDomain low[arity];
-            RamDomain hig[arity];
-
-            for (size_t i = 0; i < arity; i++) {
-                if (pattern[i] != nullptr) {
-                    low[i] = interpreter.evalVal(*pattern[i], ctxt);
-                    hig[i] = low[i];
-                } else {
-                    low[i] = MIN_RAM_DOMAIN;
-                    hig[i] = MAX_RAM_DOMAIN;
+                // check for null
+                if (isNull(ref)) {
+                    return;
                 }
-            }
 
-            // obtain index
-            auto idx = rel.getIndex(aggregate.getRangeQueryColumns());
+                // update environment variable and save reference to temporary value
+                ctxt[level] = records->unpack(ref);
 
-            // get iterator range
-            auto range = idx->lowerUpperBound(low, hig);
+                // run nested part
+                search(ctxt);
+            };
+        }
 
-            // check for emptiness
-            if (aggregate.getFunction() != RamAggregate::COUNT) {
-                if (range.first == range.second) {
-                    return;  // no elements => no min/max
-                }
+        OperationClosure visitAggregate(const RamAggregate& aggregate) override {
+            // get the targeted relation
+            auto rel = interpreter.getRelationHandle(aggregate.getRelation());
+            auto arity = aggregate.getRelation().getArity();
+            auto level = aggregate.getLevel();
+            auto function = aggregate.getFunction();
+            auto indexHandle =
+                    std::make_shared<InterpreterIndexHandle>(rel, aggregate.getRangeQueryColumns());
+            auto pattern = lowerPattern(aggregate.getPattern());
+            ValueClosure target;
+            if (function != RamAggregate::COUNT) {
+                target = interpreter.lowerVal(*aggregate.getTargetExpression());
             }
+            OperationClosure search = visitSearch(aggregate);
 
-            // iterate through values
-            for (auto ip = range.first; ip != range.second; ++ip) {
-                // link tuple
-                const RamDomain* data = *(ip);
-                ctxt[aggregate.getLevel()] = data;
-
-                // count is easy
-                if (aggregate.getFunction() == RamAggregate::COUNT) {
-                    res++;
-                    continue;
-                }
-
-                // aggregation is a bit more difficult
-
-                // eval target expression
-                RamDomain cur = interpreter.evalVal(*aggregate.getTargetExpression(), ctxt);
-
-                switch (aggregate.getFunction()) {
+            return [=](InterpreterContext& ctxt) {
+                // initialize result
+                RamDomain res = 0;
+                switch (function) {
                     case RamAggregate::MIN:
-                        res = std::min(res, cur);
+                        res = MAX_RAM_DOMAIN;
                         break;
                     case RamAggregate::MAX:
-                        res = std::max(res, cur);
+                        res = MIN_RAM_DOMAIN;
                         break;
                     case RamAggregate::COUNT:
                         res = 0;
                         break;
                     case RamAggregate::SUM:
-                        res += cur;
+                        res = 0;
                         break;
                 }
-            }
 
-            // write result to environment
-            RamDomain tuple[1];
-            tuple[0] = res;
-            ctxt[aggregate.getLevel()] = tuple;
+                // get lower and upper boundaries for iteration
+                RamDomain low[arity];
+                RamDomain hig[arity];
+                for (size_t i = 0; i < arity; i++) {
+                    if (pattern[i]) {
+                        low[i] = pattern[i](ctxt);
+                        hig[i] = low[i];
+                    } else {
+                        low[i] = MIN_RAM_DOMAIN;
+                        hig[i] = MAX_RAM_DOMAIN;
+                    }
+                }
+
+                // obtain index
+                auto idx = indexHandle->get();
 
-            // check whether result is used in a condition
-            auto condition = aggregate.getCondition();
-            if (condition && !interpreter.evalCond(*condition, ctxt)) {
-                return;  // condition not valid => skip nested
-            }
+                // get iterator range
+                auto range = idx->lowerUpperBound(low, hig);
+
+                // check for emptiness
+                if (function != RamAggregate::COUNT) {
+                    if (range.first == range.second) {
+                        return;  // no elements => no min/max
+                    }
+                }
+
+                // iterate through values
+                for (auto ip = range.first; ip != range.second; ++ip) {
+                    // link tuple
+                    ctxt[level] = *(ip);
+
+                    // count is easy
+                    if (function == RamAggregate::COUNT) {
+                        res++;
+                        continue;
+                    }
+
+                    // aggregation is a bit more difficult
+
+                    // eval target expression
+                    RamDomain cur = target(ctxt);
+
+                    switch (function) {
+                        case RamAggregate::MIN:
+                            res = std::min(res, cur);
+                            break;
+                        case RamAggregate::MAX:
+                            res = std::max(res, cur);
+                            break;
+                        case RamAggregate::COUNT:
+                            res = 0;
+                            break;
+                        case RamAggregate::SUM:
+                            res += cur;
+                            break;
+                    }
+                }
+
+                // write result to environment
+                RamDomain tuple[1];
+                tuple[0] = res;
+                ctxt[level] = tuple;
 
-            // run nested part - using base class visitor
-            visitSearch(aggregate);
+                // run nested part, which checks whether the result is used in a condition
+                search(ctxt);
+            };
         }
 
-        void visitProject(const RamProject& project) override {
+        OperationClosure visitProject(const RamProject& project) override {
             // check constraints
-            RamCondition* condition = project.getCondition();
-            if (condition && !interpreter.evalCond(*condition, ctxt)) {
-                return;  // condition violated => skip insert
+            ConditionClosure condition;
+            if (project.getCondition()) {
+                condition = interpreter.lowerCond(*project.getCondition());
             }
 
             // create a tuple of the proper arity (also supports arity 0)
             auto arity = project.getRelation().getArity();
-            const auto& values = project.getValues();
-            RamDomain tuple[arity];
-            for (size_t i = 0; i < arity; i++) {
-                assert(values[i]);
-                tuple[i] = interpreter.evalVal(*values[i], ctxt);
+            std::vector<ValueClosure> values;
+            for (const RamValue* cur : project.getValues()) {
+                assert(cur);
+                values.push_back(interpreter.lowerVal(*cur));
             }
 
             // insert in target relation
-            InterpreterRelation& rel = interpreter.getRelation(project.getRelation());
-            rel.insert(tuple);
+            auto rel = interpreter.getRelationHandle(project.getRelation());
+            return [condition, arity, values, rel](InterpreterContext& ctxt) {
+                if (condition && !condition(ctxt)) {
+                    return;  // condition violated => skip insert
+                }
+
+                RamDomain tuple[arity];
+                for (size_t i = 0; i < arity; i++) {
+                    tuple[i] = values[i](ctxt);
+                }
+                (*rel)->insert(tuple);
+            };
         }
 
         // -- return from subroutine --
-        void visitReturn(const RamReturn& ret) override {
-            for (auto val : ret.getValues()) {
-                if (val == nullptr) {
-                    ctxt.addReturnValue(0, true);
-                } else {
-                    ctxt.addReturnValue(interpreter.evalVal(*val, ctxt));
-                }
+        OperationClosure visitReturn(const RamReturn& ret) override {
+            std::vector<ValueClosure> values;
+            for (const RamValue* cur : ret.getValues()) {
+                values.push_back(cur ? interpreter.lowerVal(*cur) : ValueClosure());
             }
+            return [values](InterpreterContext& ctxt) {
+                for (const auto& val : values) {
+                    if (!val) {
+                        ctxt.addReturnValue(0, true);
+                    } else {
+                        ctxt.addReturnValue(val(ctxt));
+                    }
+                }
+            };
         }
 
         // -- safety net --
-        void visitNode(const RamNode& node) override {
+        OperationClosure visitNode(const RamNode& node) override {
             std::cerr << "Unsupported node type: " << typeid(node).name() << "\n";
             assert(false && "Unsupported Node Type!");
+            return [](InterpreterContext&) {};
         }
     };
 
-    // create and run interpreter for operations
+    // the outermost scan is evaluated in parallel if there are multiple threads and
+    // the operation does not collect the return values of a subroutine
+    bool parallel = false;
+#ifdef _OPENMP
+    if (omp_get_max_threads() > 1) {
+        parallel = true;
+        visitDepthFirst(op, [&](const RamReturn&) { parallel = false; });
+    }
+#endif
+
+    // lower operation once
+    return OperationLowering(*this, parallel)(op);
+}
+
+/** Evaluate RAM Value */
+RamDomain Interpreter::evalVal(const RamValue& value, const InterpreterContext& ctxt) {
+    return lowerVal(value)(ctxt);
+}
+
+/** Evaluate RAM Condition */
+bool Interpreter::evalCond(const RamCondition& cond, const InterpreterContext& ctxt) {
+    // conditions of the main program are lowered before its execution
+    auto pos = conditions.find(&cond);
+    if (pos == conditions.end()) {
+        pos = conditions.emplace(&cond, lowerCond(cond)).first;
+    }
+    return pos->second(ctxt);
+}
+
+/** Evaluate RAM operation */
+void Interpreter::evalOp(const RamOperation& op, const InterpreterContext& args) {
+    // operations of the main program are lowered before its execution
+    auto pos = operations.find(&op);
+    if (pos == operations.end()) {
+        pos = operations.emplace(&op, lowerOp(op)).first;
+    }
+
+    // create context and run lowered operation
     InterpreterContext ctxt(op.getDepth());
     ctxt.setReturnValues(args.getReturnValues());
     ctxt.setReturnErrors(args.getReturnErrors());
     ctxt.setArguments(args.getArguments());
-    OperationEvaluator(*this, ctxt).visit(op);
+    pos->second(ctxt);
 }
 
 /** Evaluate RAM statement */
@@ -666,8 +892,11 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
 
         bool visitLoop(const RamLoop& loop) override {
             interpreter.resetIterationNumber();
+            interpreter.chooseLoopNests(loop);
             while (visit(loop.getBody())) {
+                interpreter.limits.checkTime();
                 interpreter.incIterationNumber();
+                interpreter.chooseLoopNests(loop);
             }
             interpreter.resetIterationNumber();
             return true;
@@ -705,6 +934,17 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
                             stratum.getIndex(), "relation", cur.first, "arity", std::to_string(cur.second));
                 }
             }
+
+            // start the time limit of the stratum, and name its rules for reporting exceeded limits
+            if (interpreter.limits.isEnabled()) {
+                std::vector<ResourceLimits::Rule> rules;
+                visitDepthFirst(stratum, [&](const RamDebugInfo& dbg) {
+                    visitDepthFirst(dbg, [&](const RamProject& project) {
+                        rules.emplace_back(project.getRelation().getName(), dbg.getMessage());
+                    });
+                });
+                interpreter.limits.startStratum(stratum.getIndex(), std::move(rules));
+            }
             return visit(stratum.getBody());
         }
 
@@ -784,6 +1024,20 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
         bool visitInsert(const RamInsert& insert) override {
             // run generic query executor
             interpreter.evalOp(insert.getOperation());
+
+            // check the limit of the computed relation, and the time of rules outside of fixpoint loops,
+            // which compute temporary relations and are checked at each iteration
+            if (interpreter.limits.isEnabled()) {
+                visitDepthFirst(insert, [&](const RamProject& project) {
+                    const std::string& relName = project.getRelation().getName();
+                    if (interpreter.limits.getTupleLimit(relName) > 0) {
+                        interpreter.limits.checkSize(relName, interpreter.getRelation(relName).size());
+                    }
+                    if (relName[0] != '@') {
+                        interpreter.limits.checkTime();
+                    }
+                });
+            }
             return true;
         }
 
@@ -798,6 +1052,8 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
             }
             // merge in all elements
             trg.insert(src);
+            interpreter.limits.checkSize(merge.getTargetRelation().getName(), trg.size());
+            interpreter.limits.checkTime();
 
             // done
             return true;
@@ -823,24 +1079,294 @@ void Interpreter::evalStmt(const RamStatement& stmt) {
     StatementEvaluator(*this).visit(stmt);
 }
 
+/** Lower all operations and conditions of a statement */
+void Interpreter::lowerStmt(const RamStatement& stmt) {
+    visitDepthFirst(stmt, [&](const RamInsert& insert) {
+        const RamOperation& op = insert.getOperation();
+        operations.emplace(&op, lowerOp(op));
+    });
+    visitDepthFirst(stmt, [&](const RamExit& exit) {
+        const RamCondition& cond = exit.getCondition();
+        conditions.emplace(&cond, lowerCond(cond));
+    });
+    if (Global::config().has("adaptive-joins")) {
+        visitDepthFirst(stmt, [&](const RamLoop& loop) { prepareLoopNests(loop); });
+    }
+}
+
+/** Rebuild a loop nest of scans in another order */
+std::unique_ptr<RamOperation> Interpreter::reorderLoopNest(
+        const RamOperation& op, const std::vector<size_t>& order) {
+    // collect the scans of the loop nest, which has to end in a projection
+    std::vector<const RamScan*> scans;
+    const RamOperation* cur = &op;
+    while (const auto* scan = dynamic_cast<const RamScan*>(cur)) {
+        if (scan->getLevel() != scans.size()) {
+            return nullptr;
+        }
+        scans.push_back(scan);
+        cur = scan->getNestedOperation();
+    }
+    const auto* project = dynamic_cast<const RamProject*>(cur);
+    const size_t depth = scans.size();
+    if (project == nullptr || project->getLevel() != depth || order.size() != depth) {
+        return nullptr;
+    }
+
+    // map the levels of the loop nest to their new positions
+    std::vector<size_t> levels(depth);
+    for (size_t i = 0; i < depth; ++i) {
+        levels[order[i]] = i;
+    }
+    class LevelMapper : public RamNodeMapper {
+        const std::vector<size_t>& levels;
+
+    public:
+        LevelMapper(const std::vector<size_t>& levels) : levels(levels) {}
+        using RamNodeMapper::operator();
+        std::unique_ptr<RamNode> operator()(std::unique_ptr<RamNode> node) const override {
+            if (const auto* access = dynamic_cast<const RamElementAccess*>(node.get())) {
+                return std::make_unique<RamElementAccess>(
+                        levels[access->getLevel()], access->getElement(), access->getName());
+            }
+            node->apply(*this);
+            return node;
+        }
+    };
+    LevelMapper relevel(levels);
+
+    // collect all conditions, including those turned into range queries, over the new levels
+    std::vector<std::unique_ptr<RamCondition>> conds;
+    std::function<void(const RamCondition&)> addConjuncts = [&](const RamCondition& cond) {
+        if (const auto* conj = dynamic_cast<const RamAnd*>(&cond)) {
+            addConjuncts(conj->getLHS());
+            addConjuncts(conj->getRHS());
+        } else {
+            conds.push_back(relevel(std::unique_ptr<RamCondition>(cond.clone())));
+        }
+    };
+    for (const RamScan* scan : scans) {
+        if (scan->getCondition()) {
+            addConjuncts(*scan->getCondition());
+        }
+        const auto pattern = scan->getRangePattern();
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (pattern[i]) {
+                conds.push_back(std::make_unique<RamBinaryRelation>(BinaryConstraintOp::EQ,
+                        std::make_unique<RamElementAccess>(
+                                levels[scan->getLevel()], i, scan->getRelation().getArg(i)),
+                        relevel(std::unique_ptr<RamValue>(pattern[i]->clone()))));
+            }
+        }
+    }
+    if (project->getCondition()) {
+        addConjuncts(*project->getCondition());
+    }
+
+    // a condition on a single column compared to values of outer levels narrows the range of a scan
+    std::set<std::pair<size_t, size_t>> rangeColumns;
+    auto isRangeCondition = [&](RamCondition& cond, size_t level) {
+        auto* binRel = dynamic_cast<RamBinaryRelation*>(&cond);
+        if (binRel == nullptr || binRel->getOperator() != BinaryConstraintOp::EQ) {
+            return false;
+        }
+        auto isColumn = [&](RamValue* val, RamValue* other) {
+            const auto* access = dynamic_cast<RamElementAccess*>(val);
+            return access != nullptr && access->getLevel() == level &&
+                   (other->isConstant() || other->getLevel() < level) &&
+                   rangeColumns.insert(std::make_pair(level, access->getElement())).second;
+        };
+        return isColumn(binRel->getLHS(), binRel->getRHS()) || isColumn(binRel->getRHS(), binRel->getLHS());
+    };
+
+    // a scan merely checks for existence if none of its values is accessed apart from its range query
+    std::vector<bool> binding(depth, false);
+    for (auto& cond : conds) {
+        size_t level = cond->getLevel();
+        bool isRange = isRangeCondition(*cond, level);
+        visitDepthFirst(*cond, [&](const RamElementAccess& access) {
+            if (access.getLevel() < level || !isRange) {
+                binding[access.getLevel()] = true;
+            }
+        });
+    }
+
+    // build the loop nest from the inside out
+    std::unique_ptr<RamProject> newProject;
+    if (project->hasFilter()) {
+        newProject = std::make_unique<RamProject>(
+                std::unique_ptr<RamRelation>(project->getRelation().clone()), project->getFilter(), depth);
+    } else {
+        newProject = std::make_unique<RamProject>(
+                std::unique_ptr<RamRelation>(project->getRelation().clone()), depth);
+    }
+    for (const RamValue* value : project->getValues()) {
+        visitDepthFirst(
+                *value, [&](const RamElementAccess& access) { binding[levels[access.getLevel()]] = true; });
+        newProject->addArg(relevel(std::unique_ptr<RamValue>(value->clone())));
+    }
+    std::unique_ptr<RamOperation> res = std::move(newProject);
+    for (size_t i = depth; i-- > 0;) {
+        const RamScan* scan = scans[order[i]];
+        res = std::make_unique<RamScan>(std::unique_ptr<RamRelation>(scan->getRelation().clone()),
+                std::move(res), !binding[i], scan->getProfileText());
+    }
+    for (auto& cond : conds) {
+        res->addCondition(std::move(cond));
+    }
+    return res;
+}
+
+/** Lower the alternative orders of the loop nests of a fixpoint loop */
+void Interpreter::prepareLoopNests(const RamLoop& loop) {
+    auto* indexAnalysis = translationUnit.getAnalysis<IndexSetAnalysis>();
+
+    // a scan is answered without a new index if its columns form a prefix of an index of the relation;
+    // relations create their indexes lazily, so the first search of such a nest may still build it
+    auto isIndexed = [&](const RamScan& scan) {
+        const SearchColumns keys = scan.getRangeQueryColumns();
+        const SearchColumns total = (1 << scan.getRelation().getArity()) - 1;
+        if (keys == 0 || keys == total) {
+            return true;
+        }
+        for (const auto& order : indexAnalysis->getIndexes(scan.getRelation()).getAllOrders()) {
+            SearchColumns prefix = 0;
+            for (int col : order) {
+                prefix |= (1 << col);
+                if (prefix == keys) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    visitDepthFirst(loop, [&](const RamInsert& insert) {
+        const RamOperation& op = insert.getOperation();
+        size_t numScans = 0;
+        for (const RamOperation* cur = &op; dynamic_cast<const RamScan*>(cur);
+                cur = static_cast<const RamScan*>(cur)->getNestedOperation()) {
+            ++numScans;
+        }
+        if (numScans < 2 || numScans > MAX_ADAPTIVE_SCANS) {
+            return;
+        }
+
+        LoopNestChoice choice;
+        choice.operation = &op;
+        choice.nests.push_back(&op);
+        choice.closures.push_back(operations[&op]);
+
+        // enumerate all other orders of the scans
+        std::vector<size_t> order(numScans);
+        std::iota(order.begin(), order.end(), 0);
+        while (std::next_permutation(order.begin(), order.end())) {
+            std::unique_ptr<RamOperation> nest = reorderLoopNest(op, order);
+            if (!nest) {
+                return;
+            }
+            bool indexed = true;
+            visitDepthFirst(*nest, [&](const RamScan& scan) { indexed = indexed && isIndexed(scan); });
+            if (!indexed) {
+                continue;
+            }
+            choice.closures.push_back(lowerOp(*nest));
+            choice.nests.push_back(nest.get());
+            choice.alternatives.push_back(std::move(nest));
+        }
+        if (choice.nests.size() > 1) {
+            loopNestChoices[&loop].push_back(std::move(choice));
+        }
+    });
+}
+
+/** Choose the loop nests of a fixpoint loop */
+void Interpreter::chooseLoopNests(const RamLoop& loop) {
+    auto pos = loopNestChoices.find(&loop);
+    if (pos == loopNestChoices.end()) {
+        return;
+    }
+    for (auto& choice : pos->second) {
+        size_t best = choice.chosen;
+        double bestCost = estimateCost(*choice.nests[best]);
+        for (size_t i = 0; i < choice.nests.size(); ++i) {
+            double cost = estimateCost(*choice.nests[i]);
+            if (cost < bestCost) {
+                best = i;
+                bestCost = cost;
+            }
+        }
+        if (best != choice.chosen) {
+            choice.chosen = best;
+            operations[choice.operation] = choice.closures[best];
+        }
+    }
+}
+
+/** Estimate the number of tuples visited by a loop nest */
+double Interpreter::estimateCost(const RamOperation& nest) {
+    double cost = 0;
+    double matches = 1;
+    const RamOperation* cur = &nest;
+    while (const auto* scan = dynamic_cast<const RamScan*>(cur)) {
+        // assume the tuples to be spread uniformly, such that every bound column reduces the
+        // matches by the same factor
+        const InterpreterRelation& rel = getRelation(scan->getRelation());
+        const double size = rel.size();
+        const size_t arity = rel.getArity();
+        const size_t numBound = __builtin_popcountll(scan->getRangeQueryColumns());
+        double estimate = (arity == 0) ? std::min(size, 1.0)
+                                       : std::pow(size, static_cast<double>(arity - numBound) / arity);
+        if (scan->isPureExistenceCheck()) {
+            estimate = std::min(estimate, 1.0);
+        }
+
+        // each tuple of the enclosing scans searches the relation once and visits the matches
+        cost += matches;
+        matches *= estimate;
+        cost += matches;
+        cur = scan->getNestedOperation();
+    }
+    return cost;
+}
+
 /** Execute main program of a translation unit */
 void Interpreter::executeMain() {
+#ifdef _OPENMP
+    if (std::stoi(Global::config().get("jobs")) > 0) {
+        omp_set_num_threads(std::stoi(Global::config().get("jobs")));
+    }
+#endif
     SignalHandler::instance()->set();
     if (Global::config().has("verbose")) {
         SignalHandler::instance()->enableLogging();
     }
     const RamStatement& main = *translationUnit.getP().getMain();
 
-    if (!Global::config().has("profile")) {
-        evalStmt(main);
-    } else {
-        ProfileEventSingleton::instance().setOutputFile(Global::config().get("profile"));
-        // Prepare the frequency table for threaded use
+    // number the profiled searches for counting their selectivity
+    if (Global::config().has("profile") && Global::config().has("profile-selectivity")) {
         visitDepthFirst(main, [&](const RamSearch& node) {
             if (!node.getProfileText().empty()) {
-                frequencies.emplace(node.getProfileText(), std::map<size_t, size_t>());
+                selectivityIndex.emplace(node.getProfileText(), selectivityIndex.size());
             }
         });
+        selectivity = std::make_unique<SelectivityCounters>(selectivityIndex.size());
+    }
+
+    // lower the program once, so evaluation does not re-dispatch on RAM nodes
+    lowerStmt(main);
+
+    if (Global::config().has("tuple-limit")) {
+        limits.setTupleLimits(Global::config().get("tuple-limit"));
+    }
+    if (Global::config().has("stratum-timeout")) {
+        limits.setStratumTimeout(Global::config().get("stratum-timeout"));
+    }
+
+    if (!Global::config().has("profile")) {
+        evalMain(main);
+    } else {
+        ProfileEventSingleton::instance().setOutputFile(Global::config().get("profile"));
         // Enable profiling for execution of main
         ProfileEventSingleton::instance().startTimer();
         ProfileEventSingleton::instance().makeTimeEvent("@time;starttime");
@@ -860,17 +1386,49 @@ void Interpreter::executeMain() {
         visitDepthFirst(main, [&](const RamInsert& rule) { ++ruleCount; });
         ProfileEventSingleton::instance().makeConfigRecord("ruleCount", std::to_string(ruleCount));
 
-        evalStmt(main);
+        evalMain(main);
         ProfileEventSingleton::instance().stopTimer();
+        flushFrequencies();
         for (auto const& cur : frequencies) {
             for (auto const& iter : cur.second) {
                 ProfileEventSingleton::instance().makeQuantityEvent(cur.first, iter.second, iter.first);
             }
         }
+        if (selectivity) {
+            for (const auto& cur : selectivityIndex) {
+                selectivity->dump(cur.second, cur.first);
+            }
+        }
     }
     SignalHandler::instance()->reset();
 }
 
+/** Evaluate the main program */
+void Interpreter::evalMain(const RamStatement& main) {
+    try {
+        evalStmt(main);
+    } catch (const ResourceLimitExceeded& e) {
+        std::map<std::string, size_t> sizes;
+        for (const auto& cur : environment) {
+            if (cur.second != nullptr && cur.first[0] != '@') {
+                sizes[cur.first] = cur.second->size();
+            }
+        }
+        ResourceLimits::report(e, sizes, std::cerr);
+
+        // store the outputs of the aborted stratum; those of earlier strata are stored already
+        if (Global::config().has("partial-output")) {
+            visitDepthFirst(main, [&](const RamStratum& stratum) {
+                if (static_cast<size_t>(stratum.getIndex()) == limits.getStratumIndex()) {
+                    visitDepthFirst(stratum, [&](const RamStore& store) { evalStmt(store); });
+                }
+            });
+        }
+        SignalHandler::instance()->reset();
+        throw;
+    }
+}
+
 /** Execute subroutine */
 void Interpreter::executeSubroutine(const RamStatement& stmt, const std::vector<RamDomain>& arguments,
         std::vector<RamDomain>& returnValues, std::vector<bool>& returnErrors) {
@@ -16,23 +16,30 @@
 
 #pragma once
 
+#include "Global.h"
 #include "InterpreterContext.h"
 #include "InterpreterRelation.h"
+#include "ParallelUtils.h"
+#include "ProfileEvent.h"
 #include "RamCondition.h"
+#include "RamOperation.h"
 #include "RamRelation.h"
 #include "RamStatement.h"
 #include "RamTranslationUnit.h"
 #include "RamTypes.h"
+#include "ResourceLimits.h"
 
+#include <atomic>
 #include <cassert>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace souffle {
 
 class InterpreterProgInterface;
-class RamOperation;
 class RamValue;
 class SymbolTable;
 
@@ -50,19 +57,93 @@ private:
     /** relation environment type */
     using relation_map = std::map<std::string, InterpreterRelation*>;
 
-    /** relation environment */
+    /** relation environment; slots remain in place once created so lowered operations can refer to them */
     relation_map environment;
 
+    /** closures of lowered RAM nodes, with relations, index keys and operators resolved */
+    using ValueClosure = std::function<RamDomain(const InterpreterContext&)>;
+    using ConditionClosure = std::function<bool(const InterpreterContext&)>;
+    using OperationClosure = std::function<void(InterpreterContext&)>;
+
+    /** lowered operations, keyed by the RAM operation they have been lowered from */
+    std::map<const RamOperation*, OperationClosure> operations;
+
+    /** lowered conditions, keyed by the RAM condition they have been lowered from */
+    std::map<const RamCondition*, ConditionClosure> conditions;
+
+    /** alternative loop nests of an operation in a fixpoint loop, one of which is evaluated per iteration */
+    struct LoopNestChoice {
+        /** the operation as generated by the translator */
+        const RamOperation* operation;
+
+        /** the loop nests in other orders of their scans */
+        std::vector<std::unique_ptr<RamOperation>> alternatives;
+
+        /** all loop nests, starting with the generated operation */
+        std::vector<const RamOperation*> nests;
+
+        /** the lowered loop nests */
+        std::vector<OperationClosure> closures;
+
+        /** the loop nest currently evaluated */
+        size_t chosen = 0;
+    };
+
+    /** alternative loop nests of the operations of each fixpoint loop, for adaptive join ordering */
+    std::map<const RamLoop*, std::vector<LoopNestChoice>> loopNestChoices;
+
     /** counters for atom profiling */
     std::map<std::string, std::map<size_t, size_t>> frequencies;
 
+    /** counters for atom profiling in the current iteration, added to the frequencies once it ends */
+    std::map<std::string, std::atomic<size_t>> iterationFrequencies;
+
+    /** lock for adding the counters of an iteration to the frequencies */
+    Lock frequencyLock;
+
+    /** counters for the selectivity of profiled searches, if enabled by the profile-selectivity option */
+    std::unique_ptr<SelectivityCounters> selectivity;
+
+    /** the index of each profiled search, given by its profile text, in the selectivity counters */
+    std::map<std::string, size_t> selectivityIndex;
+
+    /** limits of tuples and time of the evaluation */
+    ResourceLimits limits;
+
     /** counter for $ operator */
-    int counter;
+    std::atomic<int> counter;
 
     /** iteration number (in a fix-point calculation) */
     size_t iteration;
 
 protected:
+    /** Lower value to a closure */
+    ValueClosure lowerVal(const RamValue& value);
+
+    /** Lower condition to a closure */
+    ConditionClosure lowerCond(const RamCondition& cond);
+
+    /** Lower operation to a closure */
+    OperationClosure lowerOp(const RamOperation& op);
+
+    /** Lower all operations and conditions of a statement ahead of its execution */
+    void lowerStmt(const RamStatement& stmt);
+
+    /**
+     * Rebuild a loop nest of scans with its scans in the given order, where order[i] is the
+     * level of the scan placed at level i; returns null if the operation is no such loop nest
+     */
+    std::unique_ptr<RamOperation> reorderLoopNest(const RamOperation& op, const std::vector<size_t>& order);
+
+    /** Lower the alternative orders of the loop nests of a fixpoint loop which use existing indexes */
+    void prepareLoopNests(const RamLoop& loop);
+
+    /** Choose the loop nests of a fixpoint loop by the current sizes of relations */
+    void chooseLoopNests(const RamLoop& loop);
+
+    /** Estimate the number of tuples visited by a loop nest given the current sizes of relations */
+    double estimateCost(const RamOperation& nest);
+
     /** Evaluate value */
     RamDomain evalVal(const RamValue& value, const InterpreterContext& ctxt = InterpreterContext());
 
@@ -75,6 +156,9 @@ protected:
     /** Evaluate statement */
     void evalStmt(const RamStatement& stmt);
 
+    /** Evaluate the main program; an exceeded resource limit is reported before it is rethrown */
+    void evalMain(const RamStatement& main);
+
     /** Get symbol table */
     SymbolTable& getSymbolTable() {
         return translationUnit.getSymbolTable();
@@ -95,22 +179,46 @@ protected:
         return counter++;
     }
 
+    /**
+     * Get the frequency counter of a profiled search in the current iteration; counters
+     * must be obtained before the evaluation, e.g., while lowering the search
+     */
+    std::atomic<size_t>& getFrequencyCounter(const std::string& profileText) {
+        return iterationFrequencies[profileText];
+    }
+
+    /** Add the frequency counters of the current iteration to the frequencies and reset them */
+    void flushFrequencies() {
+        auto lease = frequencyLock.acquire();
+        (void)lease;
+        for (auto& cur : iterationFrequencies) {
+            size_t count = cur.second.exchange(0);
+            if (count != 0) {
+                frequencies[cur.first][iteration] += count;
+            }
+        }
+    }
+
     /** Increment iteration number */
     void incIterationNumber() {
+        flushFrequencies();
         iteration++;
     }
 
     /** Reset iteration number */
     void resetIterationNumber() {
+        flushFrequencies();
         iteration = 0;
     }
 
     /** Create relation */
     void createRelation(const RamRelation& id) {
         InterpreterRelation* res = nullptr;
-        assert(environment.find(id.getName()) == environment.end());
+        assert(environment[id.getName()] == nullptr);
         if (!id.isEqRel()) {
-            res = new InterpreterRelation(id.getArity());
+            // hashset relations check for duplicates through a hash index
+            bool hashed = id.isHashset() || Global::config().has("data-structure", "hashset");
+            res = new InterpreterRelation(id.getArity(), hashed);
         } else {
             res = new InterpreterEqRelation(id.getArity());
         }
@@ -121,10 +229,15 @@ protected:
     InterpreterRelation& getRelation(const std::string& name) {
         // look up relation
         auto pos = environment.find(name);
-        assert(pos != environment.end());
+        assert(pos != environment.end() && pos->second != nullptr);
         return *pos->second;
     }
 
+    /** Get the slot of a relation, which is valid across creation, swaps and drops of the relation */
+    InterpreterRelation* const* getRelationHandle(const RamRelation& id) {
+        return &environment[id.getName()];
+    }
+
     /** Get relation */
     inline InterpreterRelation& getRelation(const RamRelation& id) {
         return getRelation(id.getName());
@@ -138,7 +251,7 @@ protected:
     /** Drop relation */
     void dropRelation(const RamRelation& id) {
         InterpreterRelation& rel = getRelation(id);
-        environment.erase(id.getName());
+        environment[id.getName()] = nullptr;
         delete &rel;
     }
 
@@ -163,7 +276,7 @@ public:
         return translationUnit;
     }
 
-    /** Execute main program */
+    /** Execute main program; throws ResourceLimitExceeded if it exceeds a resource limit */
     void executeMain();
 
     /* Execute subroutine */
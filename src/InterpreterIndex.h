@@ -10,15 +10,18 @@
  *
  * @file InterpreterIndex.h
  *
- * An index is implemented either as a hash-index, a double-hash, as a
- * red-black tree or as a b-tree. The choice of the implementation is
- * set by preprocessor defines.
+ * Indexes for range queries are implemented as b-trees. Existence checks
+ * on complete tuples may alternatively be served by a hash index.
  *
  ***********************************************************************/
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "BTree.h"
 #include "RamTypes.h"
@@ -132,18 +135,86 @@ public:
     }
 };
 
+/**
+ * The tuples of a relation, stored in blocks of doubling sizes that are allocated on demand
+ * and never moved, such that tuples handed out remain valid while further tuples are added.
+ * Tuples are addressed by their ordinal; storing tuples must not run concurrently.
+ */
+class InterpreterTupleArena {
+    // number of tuples of the first block; each further block doubles in size
+    static constexpr size_t FIRST_BLOCK_SIZE = 64;
+    // maximal number of blocks
+    static constexpr size_t NUM_BLOCKS = 48;
+
+    const size_t arity;
+    std::unique_ptr<RamDomain[]> blocks[NUM_BLOCKS];
+
+    /* compute the block holding the tuple of the given ordinal and the position of the tuple within it */
+    static inline std::pair<size_t, size_t> getPosition(size_t ordinal) {
+        const size_t scaled = ordinal / FIRST_BLOCK_SIZE + 1;
+        const size_t block = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(scaled);
+        return std::make_pair(block, ordinal - FIRST_BLOCK_SIZE * ((size_t(1) << block) - 1));
+    }
+
+public:
+    explicit InterpreterTupleArena(size_t arity) : arity(arity) {}
+
+    InterpreterTupleArena(const InterpreterTupleArena&) = delete;
+    InterpreterTupleArena& operator=(const InterpreterTupleArena&) = delete;
+
+    size_t getArity() const {
+        return arity;
+    }
+
+    /** obtain the tuple of the given ordinal, which must have been stored */
+    const RamDomain* get(size_t ordinal) const {
+        const auto pos = getPosition(ordinal);
+        return blocks[pos.first].get() + pos.second * arity;
+    }
+
+    /** store a tuple under the given ordinal, allocating its block if necessary */
+    void store(size_t ordinal, const RamDomain* tuple) {
+        const auto pos = getPosition(ordinal);
+        std::unique_ptr<RamDomain[]>& block = blocks[pos.first];
+        if (!block) {
+            block.reset(new RamDomain[(FIRST_BLOCK_SIZE << pos.first) * arity]);
+        }
+        std::copy(tuple, tuple + arity, block.get() + pos.second * arity);
+    }
+};
+
 /* B-Tree indexes as default implementation for indexes */
 class InterpreterIndex {
+public:
+    /**
+     * A reference to a tuple within an index. Tuples stored in a relation are referenced by
+     * their ordinal within the relation's arena, tagged by the lowest bit. Search keys are
+     * referenced by their (untagged) address.
+     */
+    using TupleRef = uintptr_t;
+
 protected:
-    /* lexicographical comparison operation on two tuple pointers */
+    /* lexicographical comparison operation on two tuple references */
     struct comparator {
         const InterpreterIndexOrder& order;
+        const InterpreterTupleArena& arena;
 
         /* constructor to initialize state */
-        comparator(const InterpreterIndexOrder& order) : order(order) {}
+        comparator(const InterpreterIndexOrder& order, const InterpreterTupleArena& arena)
+                : order(order), arena(arena) {}
+
+        /* obtain the tuple a reference is referring to */
+        const RamDomain* resolve(TupleRef ref) const {
+            if (ref & 1) {
+                return arena.get(ref >> 1);
+            }
+            return reinterpret_cast<const RamDomain*>(ref);
+        }
 
         /* comparison function */
-        int operator()(const RamDomain* x, const RamDomain* y) const {
+        int operator()(TupleRef a, TupleRef b) const {
+            const RamDomain* x = resolve(a);
+            const RamDomain* y = resolve(b);
             for (size_t i = 0; i < order.size(); i++) {
                 if (x[order[i]] < y[order[i]]) {
                     return -1;
@@ -156,12 +227,14 @@ protected:
         }
 
         /* less comparison */
-        bool less(const RamDomain* x, const RamDomain* y) const {
-            return operator()(x, y) < 0;
+        bool less(TupleRef a, TupleRef b) const {
+            return operator()(a, b) < 0;
         }
 
         /* equal comparison */
-        bool equal(const RamDomain* x, const RamDomain* y) const {
+        bool equal(TupleRef a, TupleRef b) const {
+            const RamDomain* x = resolve(a);
+            const RamDomain* y = resolve(b);
             for (size_t i = 0; i < order.size(); i++) {
                 if (x[order[i]] != y[order[i]]) {
                     return false;
@@ -171,46 +244,116 @@ protected:
         }
     };
 
-    /* btree for storing tuple pointers with a given lexicographical order */
-    using index_set = btree_multiset<const RamDomain*, comparator, std::allocator<const RamDomain*>, 512>;
+    /* btree for storing tuple references with a given lexicographical order */
+    using index_set = btree_multiset<TupleRef, comparator, std::allocator<TupleRef>, 512>;
 
 public:
-    using iterator = index_set::iterator;
+    /* iterator over the tuples of an index, resolving tuple references */
+    class iterator : public std::iterator<std::forward_iterator_tag, const RamDomain*> {
+        index_set::iterator cur;
+        const comparator* comp = nullptr;
+
+    public:
+        iterator() = default;
+
+        iterator(index_set::iterator cur, const comparator* comp) : cur(std::move(cur)), comp(comp) {}
+
+        const RamDomain* operator*() const {
+            return comp->resolve(*cur);
+        }
+
+        bool operator==(const iterator& other) const {
+            return cur == other.cur;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return cur != other.cur;
+        }
+
+        iterator& operator++() {
+            ++cur;
+            return *this;
+        }
+    };
 
 private:
     const InterpreterIndexOrder theOrder;  // retain the index order used to construct an object of this class
-    index_set set;                         // set storing tuple pointers of table
+    const comparator comp;                 // comparator resolving tuple references within the arena
+    index_set set;                         // set storing tuple references of table
+
+    /* obtain the reference of a search key */
+    static TupleRef toKey(const RamDomain* tuple) {
+        return reinterpret_cast<TupleRef>(tuple);
+    }
 
 public:
-    InterpreterIndex(InterpreterIndexOrder order)
-            : theOrder(std::move(order)), set(comparator(theOrder), comparator(theOrder)) {}
+    InterpreterIndex(InterpreterIndexOrder order, const InterpreterTupleArena& arena)
+            : theOrder(std::move(order)), comp(theOrder, arena), set(comp, comp) {}
 
     const InterpreterIndexOrder& order() const {
         return theOrder;
     }
 
     /**
-     * add tuple to the index
+     * add the tuple with the given ordinal in the arena to the index
      *
      * precondition: tuple does not exist in the index
      */
-    void insert(const RamDomain* tuple) {
-        set.insert(tuple);
+    void insert(size_t ordinal) {
+        set.insert((ordinal << 1) | 1);
     }
 
     /**
-     * add tuples to the index via an iterator
+     * add the tuples with ordinals in the range [from, to) to the index
      *
-     * precondition: the tuples do not exist in the index
+     * precondition: the tuples do not exist in the index, and no other operation
+     * accesses the index concurrently
      */
-    template <class Iter>
-    void insert(const Iter& a, const Iter& b) {
-        set.insert(a, b);
-    };
+    void insert(size_t from, size_t to) {
+        // sort the references, such that they can be merged into the index in a single pass
+        std::vector<TupleRef> refs;
+        refs.reserve(to - from);
+        for (size_t ordinal = from; ordinal < to; ++ordinal) {
+            refs.push_back((ordinal << 1) | 1);
+        }
+        std::sort(refs.begin(), refs.end(), [&](TupleRef a, TupleRef b) { return comp.less(a, b); });
+        set.insertSorted(refs.begin(), refs.end());
+    }
+
+    /**
+     * remove the tuple with the given ordinal in the arena from the index; nodes removed
+     * from the underlying b-tree are released by purge() or reclaim()
+     *
+     * @return true if the tuple has been removed, false if it was not present
+     */
+    bool erase(size_t ordinal) {
+        const TupleRef ref = (ordinal << 1) | 1;
+
+        // erasing a key removes any of the references equal to it in the indexed columns,
+        // so all of these are removed and the others inserted again
+        std::vector<TupleRef> equal(set.lower_bound(ref), set.upper_bound(ref));
+        if (std::find(equal.begin(), equal.end(), ref) == equal.end()) {
+            return false;
+        }
+        for (size_t i = 0; i < equal.size(); i++) {
+            set.erase(ref);
+        }
+        for (TupleRef cur : equal) {
+            if (cur != ref) {
+                set.insert(cur);
+            }
+        }
+        return true;
+    }
+
+    /** release the nodes removed by erase operations; must not run concurrently with other operations */
+    void reclaim() {
+        set.reclaim();
+    }
 
     /** check whether tuple exists in index */
     bool exists(const RamDomain* value) {
-        return set.find(value) != set.end();
+        return set.find(toKey(value)) != set.end();
     }
 
     /** purge all hashes of index */
@@ -232,12 +375,109 @@ public:
 
     /** return start and end iterator of a range */
     inline std::pair<iterator, iterator> lowerUpperBound(const RamDomain* low, const RamDomain* high) const {
-        return std::pair<iterator, iterator>(set.lower_bound(low), set.upper_bound(high));
+        return std::pair<iterator, iterator>(
+                iterator(set.lower_bound(toKey(low)), &comp), iterator(set.upper_bound(toKey(high)), &comp));
     }
 
     // TODO: remove this temporary method
     iterator indexEnd() const {
-        return set.end();
+        return iterator(set.end(), &comp);
+    }
+};
+
+/**
+ * A hash index over complete tuples for existence checks, based on open
+ * addressing with linear probing. Like the b-tree indexes, it refers to the
+ * tuples of a relation by their ordinal within the relation's arena. Each slot
+ * carries a tag of the tuple's hash value such that most mismatching slots are
+ * skipped without accessing the arena.
+ */
+class InterpreterHashIndex {
+    /* a slot of the hash table; an ordinal of zero marks an empty slot */
+    struct slot {
+        uint32_t tag;
+        size_t ordinal;  // ordinal of tuple + 1, addressing the arena like the b-tree indexes
+    };
+
+    const InterpreterTupleArena& arena;  // the arena of the indexed relation
+    const size_t arity;                  // the arity of the indexed relation
+    std::vector<slot> slots;             // the hash table, its size is a power of two
+    size_t count = 0;                    // the number of indexed tuples
+
+    /* hash function on complete tuples */
+    uint64_t hash(const RamDomain* tuple) const {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < arity; i++) {
+            h = (h ^ static_cast<uint64_t>(tuple[i])) * 0x100000001b3ULL;
+        }
+        return h ^ (h >> 29);
+    }
+
+    /* obtain the tuple stored in a slot */
+    const RamDomain* resolve(const slot& cur) const {
+        return arena.get(cur.ordinal - 1);
+    }
+
+    /* add a tuple with the given hash value, assuming there is a free slot */
+    void place(uint64_t h, size_t ordinal) {
+        size_t mask = slots.size() - 1;
+        size_t pos = h & mask;
+        while (slots[pos].ordinal != 0) {
+            pos = (pos + 1) & mask;
+        }
+        slots[pos].tag = static_cast<uint32_t>(h >> 32);
+        slots[pos].ordinal = ordinal + 1;
+    }
+
+    /* double the size of the hash table */
+    void grow() {
+        std::vector<slot> old(std::max<size_t>(16, 2 * slots.size()), slot{0, 0});
+        old.swap(slots);
+        for (const slot& cur : old) {
+            if (cur.ordinal != 0) {
+                place(hash(resolve(cur)), cur.ordinal - 1);
+            }
+        }
+    }
+
+public:
+    explicit InterpreterHashIndex(const InterpreterTupleArena& arena)
+            : arena(arena), arity(arena.getArity()) {}
+
+    /**
+     * add the tuple with the given ordinal in the arena to the index
+     *
+     * precondition: tuple does not exist in the index
+     */
+    void insert(size_t ordinal) {
+        // keep load factor below 1/2
+        if (2 * (count + 1) > slots.size()) {
+            grow();
+        }
+        place(hash(arena.get(ordinal)), ordinal);
+        count++;
+    }
+
+    /** check whether tuple exists in index */
+    bool exists(const RamDomain* tuple) const {
+        if (count == 0) {
+            return false;
+        }
+        uint64_t h = hash(tuple);
+        auto tag = static_cast<uint32_t>(h >> 32);
+        size_t mask = slots.size() - 1;
+        for (size_t pos = h & mask; slots[pos].ordinal != 0; pos = (pos + 1) & mask) {
+            if (slots[pos].tag == tag && std::equal(tuple, tuple + arity, resolve(slots[pos]))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** purge all hashes of index, retaining the table for re-use */
+    void purge() {
+        std::fill(slots.begin(), slots.end(), slot{0, 0});
+        count = 0;
     }
 };
 
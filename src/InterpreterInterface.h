@@ -20,6 +20,7 @@
 #include "RamVisitor.h"
 #include "SouffleInterface.h"
 
+#include <algorithm>
 #include <array>
 #include <utility>
 
@@ -136,6 +137,25 @@ public:
         relation.insert(convertTupleToNums(t));
     }
 
+    /** Insert tuples stored row by row */
+    void insertRows(const RamDomain* rows, size_t count) override {
+        const size_t arity = relation.getArity();
+        for (size_t n = 0; n < count; n++) {
+            relation.insert(rows + n * arity);
+        }
+    }
+
+    /** Export all tuples row by row */
+    size_t exportRows(RamDomain* rows) const override {
+        const size_t arity = relation.getArity();
+        size_t n = 0;
+        for (const RamDomain* cur : relation) {
+            std::copy(cur, cur + arity, rows + n * arity);
+            n++;
+        }
+        return n;
+    }
+
     /** Check whether tuple exists */
     bool contains(const tuple& t) const override {
         return relation.exists(convertTupleToNums(t));
@@ -218,6 +238,10 @@ public:
 
         // Build wrapper relations for Souffle's interface
         for (auto& rel_pair : exec.getRelationMap()) {
+            // skip relations that have been dropped
+            if (rel_pair.second == nullptr) {
+                continue;
+            }
             auto& name = rel_pair.first;
             auto& interpreterRel = *rel_pair.second;
             assert(map[name]);
@@ -274,6 +298,11 @@ public:
     const SymbolTable& getSymbolTable() const override {
         return symTable;
     }
+
+    /** Get symbol table */
+    SymbolTable& getSymbolTable() override {
+        return symTable;
+    }
 };
 
 }  // end of namespace souffle
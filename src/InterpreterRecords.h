@@ -17,18 +17,19 @@
 #pragma once
 
 #include "RamTypes.h"
+#include "RecordTable.h"
 
 namespace souffle {
 
 /**
  * A function packing a tuple of the given arity into a reference.
  */
-RamDomain pack(RamDomain* tuple, int arity);
+RamDomain pack(const RamDomain* tuple, int arity);
 
 /**
  * A function obtaining a pointer to the tuple addressed by the given reference.
  */
-RamDomain* unpack(RamDomain ref, int arity);
+const RamDomain* unpack(RamDomain ref, int arity);
 
 /**
  * Obtains the null-reference constant.
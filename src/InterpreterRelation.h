@@ -20,7 +20,8 @@
 #include "ParallelUtils.h"
 #include "RamTypes.h"
 
-#include <deque>
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <vector>
@@ -29,31 +30,57 @@ namespace souffle {
 
 /**
  * Interpreter Relation
+ *
+ * Tuples are stored in an arena of blocks that are never moved. Indices refer to
+ * tuples by their ordinal within the arena.
  */
 class InterpreterRelation {
 private:
     /** Arity of relation */
     const size_t arity;
 
-    /** Size of blocks containing tuples */
-    static const int BLOCK_SIZE = 1024;
-
     /** Number of tuples in relation */
     size_t num_tuples;
 
-    std::deque<std::unique_ptr<RamDomain[]>> blockList;
+    /** Arena storing the tuples of the relation */
+    InterpreterTupleArena arena;
 
     /** List of indices */
     mutable std::map<InterpreterIndexOrder, std::unique_ptr<InterpreterIndex>> indices;
 
-    /** Total index for existence checks */
-    mutable InterpreterIndex* totalIndex;
+    /** Total index for existence checks, created with the relation unless there is a hash index */
+    InterpreterIndex* totalIndex;
+
+    /** Hash index for existence checks, replacing the total index if present */
+    std::unique_ptr<InterpreterHashIndex> hashIndex;
 
     /** Lock for parallel execution */
     mutable Lock lock;
 
+    /** Lock for concurrent insertions */
+    Lock insertLock;
+
+    /** A number distinguishing this relation from all other relations created */
+    const size_t serial;
+
+    static size_t nextSerial() {
+        static std::atomic<size_t> lastSerial(0);
+        return ++lastSerial;
+    }
+
 public:
-    InterpreterRelation(size_t relArity) : arity(relArity), num_tuples(0), totalIndex(nullptr) {}
+    InterpreterRelation(size_t relArity, bool hashed = false)
+            : arity(relArity), num_tuples(0), arena(relArity), totalIndex(nullptr), serial(nextSerial()) {
+        if (arity == 0) {
+            return;
+        }
+        // existence checks run concurrently, so their index is not created on demand
+        if (hashed) {
+            hashIndex = std::make_unique<InterpreterHashIndex>(arena);
+        } else {
+            totalIndex = getIndex(getTotalIndexKey());
+        }
+    }
 
     InterpreterRelation(const InterpreterRelation& other) = delete;
 
@@ -64,6 +91,11 @@ public:
         return arity;
     }
 
+    /** Get the number distinguishing this relation from all other relations created */
+    size_t getSerial() const {
+        return serial;
+    }
+
     /** Check whether relation is empty */
     bool empty() const {
         return num_tuples == 0;
@@ -85,26 +117,24 @@ public:
 
         assert(tuple);
 
+        // serialise concurrent insertions of parallel loop nests
+        auto lease = insertLock.acquire();
+        (void)lease;
+
         // make existence check
         if (exists(tuple)) {
             return;
         }
 
-        int blockIndex = num_tuples / (BLOCK_SIZE / arity);
-        int tupleIndex = (num_tuples % (BLOCK_SIZE / arity)) * arity;
-
-        if (tupleIndex == 0) {
-            blockList.push_back(std::make_unique<RamDomain[]>(BLOCK_SIZE));
-        }
-
-        RamDomain* newTuple = &blockList[blockIndex][tupleIndex];
-        for (size_t i = 0; i < arity; ++i) {
-            newTuple[i] = tuple[i];
-        }
+        // append tuple to the arena
+        arena.store(num_tuples, tuple);
 
         // update all indexes with new tuple
+        if (hashIndex) {
+            hashIndex->insert(num_tuples);
+        }
         for (const auto& cur : indices) {
-            cur.second->insert(newTuple);
+            cur.second->insert(num_tuples);
         }
 
         // increment relation size
@@ -118,17 +148,101 @@ public:
         insert(tuple);
     }
 
+    /** Insert tuples stored row by row, e.g. read from a file, merging them into the indices at once */
+    virtual void insertRows(const RamDomain* rows, size_t count) {
+        // check for null-arity
+        if (arity == 0) {
+            if (count > 0) {
+                num_tuples = 1;
+            }
+            return;
+        }
+
+        // serialise concurrent insertions of parallel loop nests
+        auto lease = insertLock.acquire();
+        (void)lease;
+
+        // order the rows, such that duplicates among them are adjacent
+        std::vector<const RamDomain*> sorted(count);
+        for (size_t n = 0; n < count; n++) {
+            sorted[n] = rows + n * arity;
+        }
+        std::sort(sorted.begin(), sorted.end(), [&](const RamDomain* a, const RamDomain* b) {
+            return std::lexicographical_compare(a, a + arity, b, b + arity);
+        });
+
+        // existence checks cover the tuples stored so far only, none if the relation is empty
+        size_t first = num_tuples;
+
+        // append new tuples to the arena
+        const RamDomain* last = nullptr;
+        for (const RamDomain* cur : sorted) {
+            if (last != nullptr && std::equal(cur, cur + arity, last)) {
+                continue;
+            }
+            last = cur;
+            if (first > 0 && exists(cur)) {
+                continue;
+            }
+            arena.store(num_tuples, cur);
+            if (hashIndex) {
+                hashIndex->insert(num_tuples);
+            }
+            num_tuples++;
+        }
+
+        // merge the new tuples into the indices at once, releasing nodes of earlier erase operations
+        if (first != num_tuples) {
+            for (const auto& cur : indices) {
+                cur.second->reclaim();
+                cur.second->insert(first, num_tuples);
+            }
+        }
+    }
+
     /** Merge another relation into this relation */
-    void insert(const InterpreterRelation& other) {
+    virtual void insert(const InterpreterRelation& other) {
         assert(getArity() == other.getArity());
+
+        // check for null-arity
+        if (arity == 0) {
+            if (!other.empty()) {
+                num_tuples = 1;
+            }
+            return;
+        }
+
+        // serialise concurrent insertions of parallel loop nests
+        auto lease = insertLock.acquire();
+        (void)lease;
+
+        // append new tuples to the arena -- tuples of the other relation are distinct
+        size_t first = num_tuples;
         for (const auto& cur : other) {
-            insert(cur);
+            if (exists(cur)) {
+                continue;
+            }
+            arena.store(num_tuples, cur);
+            if (hashIndex) {
+                hashIndex->insert(num_tuples);
+            }
+            num_tuples++;
+        }
+
+        // merge the new tuples into the indices at once, releasing nodes of earlier erase operations
+        if (first != num_tuples) {
+            for (const auto& cur : indices) {
+                cur.second->reclaim();
+                cur.second->insert(first, num_tuples);
+            }
         }
     }
 
-    /** Purge table */
+    /** Purge table, retaining the memory of the arena for re-use */
     void purge() {
-        blockList.clear();
+        if (hashIndex) {
+            hashIndex->purge();
+        }
         for (const auto& cur : indices) {
             cur.second->purge();
         }
@@ -197,8 +311,8 @@ public:
             auto pos = indices.find(order);
             if (pos == indices.end()) {
                 std::unique_ptr<InterpreterIndex>& newIndex = indices[order];
-                newIndex = std::make_unique<InterpreterIndex>(order);
-                newIndex->insert(this->begin(), this->end());
+                newIndex = std::make_unique<InterpreterIndex>(order, arena);
+                newIndex->insert(0, num_tuples);
                 res = newIndex.get();
             } else {
                 res = pos->second.get();
@@ -219,10 +333,12 @@ public:
             return !empty();
         }
 
-        // handle all other arities
-        if (!totalIndex) {
-            totalIndex = getIndex(getTotalIndexKey());
+        // use hash index if present
+        if (hashIndex) {
+            return hashIndex->exists(tuple);
         }
+
+        // handle all other arities
         return totalIndex->exists(tuple);
     }
 
@@ -230,64 +346,56 @@ public:
 
     /** Iterator for relation */
     class iterator : public std::iterator<std::forward_iterator_tag, RamDomain*> {
-        const InterpreterRelation* const relation = nullptr;
+        const InterpreterRelation* relation = nullptr;
         size_t index = 0;
-        RamDomain* tuple = nullptr;
 
     public:
         iterator() = default;
 
-        iterator(const InterpreterRelation* const relation)
-                : relation(relation), tuple(relation->arity == 0 ? reinterpret_cast<RamDomain*>(this)
-                                                                 : &relation->blockList[0][0]) {}
+        iterator(const InterpreterRelation* const relation, size_t index = 0)
+                : relation(relation), index(index) {}
 
         const RamDomain* operator*() {
-            return tuple;
+            return relation->arena.get(index);
         }
 
         bool operator==(const iterator& other) const {
-            return tuple == other.tuple;
+            return index == other.index;
         }
 
         bool operator!=(const iterator& other) const {
-            return (tuple != other.tuple);
+            return index != other.index;
         }
 
         iterator& operator++() {
-            // support 0-arity
-            if (relation->arity == 0) {
-                tuple = nullptr;
-                return *this;
-            }
-
-            // support all other arities
             ++index;
-            if (index == relation->num_tuples) {
-                tuple = nullptr;
-                return *this;
-            }
-
-            int blockIndex = index / (BLOCK_SIZE / relation->arity);
-            int tupleIndex = (index % (BLOCK_SIZE / relation->arity)) * relation->arity;
-
-            tuple = &relation->blockList[blockIndex][tupleIndex];
             return *this;
         }
     };
 
     /** get iterator begin of relation */
     inline iterator begin() const {
-        // check for emptiness
-        if (empty()) {
-            return end();
-        }
-
         return iterator(this);
     }
 
     /** get iterator begin of relation */
     inline iterator end() const {
-        return iterator();
+        return iterator(this, num_tuples);
+    }
+
+    /** Partition the relation into up to a given number of chunks of roughly equal size */
+    std::vector<range<iterator>> partition(size_t chunks) const {
+        std::vector<range<iterator>> res;
+        if (empty()) {
+            return res;
+        }
+
+        size_t step = std::max<size_t>(1, (num_tuples + chunks - 1) / std::max<size_t>(1, chunks));
+        for (size_t lower = 0; lower < num_tuples; lower += step) {
+            size_t upper = std::min(lower + step, num_tuples);
+            res.push_back(range<iterator>(iterator(this, lower), iterator(this, upper)));
+        }
+        return res;
     }
 
     /** Extend tuple */
@@ -309,11 +417,18 @@ public:
  */
 
 class InterpreterEqRelation : public InterpreterRelation {
+private:
+    /** Lock for concurrent insertions, covering the closure computation */
+    Lock eqInsertLock;
+
 public:
     InterpreterEqRelation(size_t relArity) : InterpreterRelation(relArity) {}
 
     /** Insert tuple */
     void insert(const RamDomain* tuple) override {
+        auto lease = eqInsertLock.acquire();
+        (void)lease;
+
         // TODO: (pnappa) an eqrel check here is all that appears to be needed for implicit additions
         // TODO: future optimisation would require this as a member datatype
         // brave soul required to pass this quest
@@ -332,6 +447,21 @@ public:
         }
     }
 
+    /** Insert tuples stored row by row, inserting each tuple with its implications */
+    void insertRows(const RamDomain* rows, size_t count) override {
+        for (size_t n = 0; n < count; n++) {
+            insert(rows + n * getArity());
+        }
+    }
+
+    /** Merge another relation into this relation, inserting each tuple with its implications */
+    void insert(const InterpreterRelation& other) override {
+        assert(getArity() == other.getArity());
+        for (const auto& cur : other) {
+            insert(cur);
+        }
+    }
+
     /** Find the new knowledge generated by inserting a tuple */
     std::vector<RamDomain*> extend(const RamDomain* tuple) override {
         std::vector<RamDomain*> newTuples;
@@ -377,4 +507,43 @@ public:
     }
 };
 
+/**
+ * The index of a relation searched with fixed keys by a lowered operation. The relation is given
+ * by its slot in the environment, and the index is looked up again only once the slot refers to
+ * another relation, e.g., after a swap.
+ */
+class InterpreterIndexHandle {
+private:
+    /** Slot of the relation */
+    InterpreterRelation* const* rel;
+
+    /** Searched columns */
+    const SearchColumns keys;
+
+    /** Serial number of the relation the index has been looked up for */
+    std::atomic<size_t> serial;
+
+    /** Index looked up for the relation */
+    std::atomic<InterpreterIndex*> index;
+
+public:
+    InterpreterIndexHandle(InterpreterRelation* const* rel, SearchColumns keys)
+            : rel(rel), keys(keys), serial(0), index(nullptr) {}
+
+    InterpreterIndexHandle(const InterpreterIndexHandle& other) = delete;
+
+    /** Get the index of the relation currently in the slot */
+    InterpreterIndex* get() {
+        const InterpreterRelation& cur = **rel;
+        if (serial.load(std::memory_order_acquire) == cur.getSerial()) {
+            return index.load(std::memory_order_relaxed);
+        }
+        // concurrent lookups of the same relation obtain the same index
+        InterpreterIndex* res = cur.getIndex(keys);
+        index.store(res, std::memory_order_relaxed);
+        serial.store(cur.getSerial(), std::memory_order_release);
+        return res;
+    }
+};
+
 }  // end of namespace souffle
@@ -1173,6 +1173,9 @@ bool MagicSetTransformer::transform(AstTranslationUnit& translationUnit) {
                     if (inputDirectives.getIOType() == "file" && !inputDirectives.has("filename")) {
                         newDirective->addKVP("filename", originalName.getNames()[0] + ".facts");
                     }
+                    if (inputDirectives.getIOType() == "binary" && !inputDirectives.has("filename")) {
+                        newDirective->addKVP("filename", originalName.getNames()[0] + ".bin");
+                    }
 
                     newRelation->addIODirectives(std::unique_ptr<AstIODirective>(newDirective));
                 }
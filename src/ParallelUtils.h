@@ -31,8 +31,11 @@
 #define pthread_yield pthread_yield_np
 #endif
 
-// support for a parallel region
-#define PARALLEL_START _Pragma("omp parallel") {
+// a pragma composed of macro arguments
+#define SOUFFLE_PRAGMA(X) _Pragma(#X)
+
+// support for a parallel region; within a task, the region only uses the task's share of the threads
+#define PARALLEL_START _Pragma("omp parallel num_threads(souffle::getTaskThreads())") {
 #define PARALLEL_END }
 
 // support for parallel loops
@@ -43,16 +46,29 @@
 #define task_spawn
 #define task_sync
 
-// section start / end => corresponding OpenMP pragmas
-// NOTE: disabled since it causes performance losses
-//#define SECTIONS_START _Pragma("omp parallel sections") {
-// NOTE: we stick to flat-level parallelism since it is faster due to thread pooling
+// support for a task graph => a single thread creates the tasks, all threads of the team run them
+#define TASKS_START                                     \
+    {                                                   \
+        souffle::NestedParallelism nestedParallelism;   \
+        _Pragma("omp parallel") _Pragma("omp single") {
+#define TASKS_END \
+    }             \
+    }
+
+// the markers for a single task, started once the tasks it depends on (as given by depend clauses) are done
+#define TASK_START(DEPENDENCIES)                            \
+    SOUFFLE_PRAGMA(omp task default(shared) DEPENDENCIES) { \
+        souffle::TaskScope taskScope;
+#define TASK_END }
+
+// section start / end => tasks of the enclosing task graph, which are run in sequence outside of task graphs
 #define SECTIONS_START {
-#define SECTIONS_END }
+#define SECTIONS_END _Pragma("omp taskwait") }
 
 // the markers for a single section
-//#define SECTION_START _Pragma("omp section") {
-#define SECTION_START {
+#define SECTION_START                     \
+    _Pragma("omp task default(shared)") { \
+        souffle::TaskScope taskScope;
 #define SECTION_END }
 
 // a macro to create an operation context
@@ -79,6 +95,12 @@
 #define task_spawn cilk_spawn
 #define task_sync cilk_sync
 
+// task graphs are processed sequentially
+#define TASKS_START {
+#define TASKS_END }
+#define TASK_START(DEPENDENCIES) {
+#define TASK_END }
+
 // section start / end
 #define SECTIONS_START {
 #define SECTIONS_END \
@@ -110,6 +132,12 @@
 #define task_spawn
 #define task_sync
 
+// task graphs are processed sequentially
+#define TASKS_START {
+#define TASKS_END }
+#define TASK_START(DEPENDENCIES) {
+#define TASK_END }
+
 // sections are processed sequentially
 #define SECTIONS_START {
 #define SECTIONS_END }
@@ -131,6 +159,62 @@
 #define IS_PARALLEL
 #endif
 
+#ifdef _OPENMP
+
+#include <algorithm>
+
+namespace souffle {
+
+/**
+ * Obtains the number of currently running tasks of task graphs and sections.
+ */
+inline std::atomic<int>& getRunningTasks() {
+    static std::atomic<int> tasks(0);
+    return tasks;
+}
+
+/**
+ * Registers a running task for its life time.
+ */
+struct TaskScope {
+    TaskScope() {
+        getRunningTasks().fetch_add(1, std::memory_order_relaxed);
+    }
+    ~TaskScope() {
+        getRunningTasks().fetch_sub(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Obtains the number of threads of a parallel region, such that the
+ * parallel regions of concurrently running tasks share the threads
+ * instead of oversubscribing the cores.
+ */
+inline int getTaskThreads() {
+    const int tasks = getRunningTasks().load(std::memory_order_relaxed);
+    const int threads = omp_get_max_threads();
+    return (tasks > 1) ? std::max(1, threads / tasks) : threads;
+}
+
+/**
+ * Enables parallel regions nested in tasks for its life time.
+ */
+class NestedParallelism {
+    int levels;
+
+public:
+    NestedParallelism() : levels(omp_get_max_active_levels()) {
+        omp_set_max_active_levels(std::max(levels, 2));
+    }
+    ~NestedParallelism() {
+        omp_set_max_active_levels(levels);
+    }
+};
+
+}  // end of namespace souffle
+
+#endif
+
 #ifdef IS_PARALLEL
 
 #include <mutex>
@@ -27,6 +27,8 @@
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -93,6 +95,13 @@ public:
         profile::EventProcessorSingleton::instance().process(database, txt.c_str(), number, iteration);
     }
 
+    /** create selectivity event */
+    void makeSelectivityEvent(const std::string& txt, size_t searches, size_t hits, size_t visited,
+            size_t passed, size_t iteration) {
+        profile::EventProcessorSingleton::instance().process(
+                database, txt.c_str(), searches, hits, visited, passed, iteration);
+    }
+
     /** create utilisation event */
     void makeUtilisationEvent(const std::string& txt) {
         /* current time */
@@ -227,4 +236,85 @@ private:
     ProfileTimer timer;
 };
 
+/**
+ * Counters for the selectivity of the profiled searches of a program, i.e.,
+ * how many searches found tuples, how many tuples they visited and how many
+ * of those passed the conditions of the search.
+ *
+ * Each thread accumulates into counters of its own, such that counting
+ * inside parallel loops neither locks nor shares cache lines. The counters
+ * of all threads are summed up when read.
+ */
+class SelectivityCounters {
+public:
+    enum Counter { SEARCHES, HITS, VISITED, PASSED, NUM_COUNTERS };
+
+    explicit SelectivityCounters(size_t numSearches) : numSearches(numSearches), id(nextId()) {}
+
+    SelectivityCounters(const SelectivityCounters&) = delete;
+    SelectivityCounters& operator=(const SelectivityCounters&) = delete;
+
+    /** Add to a counter of the given search */
+    void count(size_t search, Counter counter, size_t n = 1) {
+        assert(search < numSearches && "search index out of range");
+        getLocalCounters()[search * NUM_COUNTERS + counter] += n;
+    }
+
+    /** Get the total of a counter of the given search over all threads */
+    size_t get(size_t search, Counter counter) const {
+        std::lock_guard<std::mutex> guard(lock);
+        size_t sum = 0;
+        for (const auto& cur : counters) {
+            sum += (*cur.second)[search * NUM_COUNTERS + counter];
+        }
+        return sum;
+    }
+
+    /**
+     * Record the counters of the given search in the profile, where the search
+     * is identified by its atom frequency profile text
+     */
+    void dump(size_t search, const std::string& profileText) const {
+        std::string txt = "@selectivity-atom" + profileText.substr(profileText.find(';'));
+        ProfileEventSingleton::instance().makeSelectivityEvent(txt, get(search, SEARCHES),
+                get(search, HITS), get(search, VISITED), get(search, PASSED), 0);
+    }
+
+private:
+    /** Get the counters of the calling thread, which are created on its first call */
+    std::vector<size_t>& getLocalCounters() {
+        // cache the counters of the last set of counters used by this thread
+        thread_local size_t cachedId = 0;
+        thread_local std::vector<size_t>* cached = nullptr;
+        if (cachedId != id) {
+            std::lock_guard<std::mutex> guard(lock);
+            auto& local = counters[std::this_thread::get_id()];
+            if (!local) {
+                local = std::make_unique<std::vector<size_t>>(numSearches * NUM_COUNTERS);
+            }
+            cached = local.get();
+            cachedId = id;
+        }
+        return *cached;
+    }
+
+    /** the number of profiled searches */
+    const size_t numSearches;
+
+    /** a unique identifier of this set of counters, distinguishing it in the caches of threads */
+    const size_t id;
+
+    /** the counters of each thread */
+    std::map<std::thread::id, std::unique_ptr<std::vector<size_t>>> counters;
+
+    /** lock for the map of counters of threads */
+    mutable std::mutex lock;
+
+    /** Create a new identifier for a set of counters */
+    static size_t nextId() {
+        static std::atomic<size_t> lastId(0);
+        return ++lastId;
+    }
+};
+
 }  // namespace souffle
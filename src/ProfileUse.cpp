@@ -0,0 +1,86 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProfileUse.cpp
+ *
+ * Reads the profile of a previous run of a program
+ *
+ ***********************************************************************/
+
+#include "ProfileUse.h"
+#include "Global.h"
+#include "ProfileDatabase.h"
+#include "Util.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace souffle {
+
+ProfileUse::ProfileUse(const std::string& filename) {
+    if (!existFile(filename)) {
+        throw std::runtime_error("cannot open profile log " + filename);
+    }
+    profile::ProfileDatabase db(filename);
+
+    const auto* relations =
+            dynamic_cast<const profile::DirectoryEntry*>(db.lookupEntry({"program", "relation"}));
+    if (relations == nullptr) {
+        return;
+    }
+    for (const auto& relName : relations->getKeys()) {
+        if (const auto* dir = relations->readDirectoryEntry(relName)) {
+            // the profile joins the names of relations in components by '.'
+            std::string ramName = relName;
+            std::replace(ramName.begin(), ramName.end(), '.', '-');
+            readRelation(ramName, *dir);
+        }
+    }
+}
+
+void ProfileUse::readRelation(const std::string& relName, const profile::DirectoryEntry& dir) {
+    // non-recursive relations are computed at once
+    if (const auto* size = dynamic_cast<const profile::SizeEntry*>(dir.readEntry("num-tuples"))) {
+        relationSizes[relName] = size->getSize();
+        return;
+    }
+
+    // recursive relations record the number of new tuples of each iteration
+    const auto* iterations = dir.readDirectoryEntry("iteration");
+    if (iterations == nullptr) {
+        return;
+    }
+    size_t total = 0;
+    size_t numIterations = 0;
+    for (const auto& iteration : iterations->getKeys()) {
+        const auto* iterationDir = iterations->readDirectoryEntry(iteration);
+        if (iterationDir == nullptr) {
+            continue;
+        }
+        const auto* size = dynamic_cast<const profile::SizeEntry*>(iterationDir->readEntry("num-tuples"));
+        if (size != nullptr) {
+            total += size->getSize();
+            ++numIterations;
+        }
+    }
+    relationSizes[relName] = total;
+    if (numIterations > 0) {
+        deltaSizes[relName] = total / numIterations;
+    }
+}
+
+const ProfileUse* ProfileUse::getInstance() {
+    if (!Global::config().has("profile-use")) {
+        return nullptr;
+    }
+    static const ProfileUse instance(Global::config().get("profile-use"));
+    return &instance;
+}
+
+}  // end of namespace souffle
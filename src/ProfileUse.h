@@ -0,0 +1,78 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ProfileUse.h
+ *
+ * Provides the profile of a previous run of a program, as written by
+ * the -p option, for profile-guided optimisations (--profile-use)
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace souffle {
+
+namespace profile {
+class DirectoryEntry;
+}  // namespace profile
+
+/**
+ * The statistics of a profiled run of a program utilized for guiding optimisations.
+ *
+ * Relations are identified by their names in RAM, i.e., the names of
+ * relations in components are joined by '-'.
+ */
+class ProfileUse {
+private:
+    /** The number of tuples of each relation at the end of the profiled run */
+    std::map<std::string, size_t> relationSizes;
+
+    /** The average number of tuples added per iteration to each recursive relation */
+    std::map<std::string, size_t> deltaSizes;
+
+    /** Collect the statistics of a relation from its directory in the profile */
+    void readRelation(const std::string& relName, const profile::DirectoryEntry& dir);
+
+public:
+    /** Read the profile of the given log file; throws if it can not be read */
+    explicit ProfileUse(const std::string& filename);
+
+    /** Determine whether the profile records the size of the given relation */
+    bool hasRelationSize(const std::string& relName) const {
+        return relationSizes.find(relName) != relationSizes.end();
+    }
+
+    /** Get the number of tuples of the given relation at the end of the profiled run */
+    size_t getRelationSize(const std::string& relName) const {
+        auto pos = relationSizes.find(relName);
+        return (pos != relationSizes.end()) ? pos->second : 0;
+    }
+
+    /**
+     * Get the average number of tuples added per iteration of the profiled run, i.e., the size of
+     * the delta relation; for non-recursive relations this is the number of tuples
+     */
+    size_t getDeltaSize(const std::string& relName) const {
+        auto pos = deltaSizes.find(relName);
+        return (pos != deltaSizes.end()) ? pos->second : getRelationSize(relName);
+    }
+
+    /**
+     * Get the profile given by the profile-use option, or null if the option is not set.
+     * The profile is read on the first call.
+     */
+    static const ProfileUse* getInstance();
+};
+
+}  // end of namespace souffle
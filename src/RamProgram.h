@@ -23,6 +23,7 @@ namespace souffle {
 class RamProgram : public RamNode {
 private:
     std::unique_ptr<RamStatement> main;
+    std::unique_ptr<RamStatement> incremental;
     std::map<std::string, std::unique_ptr<RamStatement>> subroutines;
     std::map<std::string, std::unique_ptr<RamRelation>> relations;
 
@@ -34,6 +35,11 @@ public:
         std::vector<const RamNode*> children;
         children.push_back(main.get());
 
+        // add incremental program
+        if (incremental) {
+            children.push_back(incremental.get());
+        }
+
         // add subroutines
         for (auto& s : subroutines) {
             children.push_back(s.second.get());
@@ -52,6 +58,11 @@ public:
         out << "PROGRAM" << std::endl;
         out << *main;
         out << "\nEND PROGRAM" << std::endl;
+        if (incremental) {
+            out << std::endl << "INCREMENTAL" << std::endl;
+            out << *incremental;
+            out << "\nEND INCREMENTAL" << std::endl;
+        }
         for (const auto& subroutine : subroutines) {
             out << std::endl << "SUBROUTINE " << subroutine.first << std::endl;
             out << *subroutine.second;
@@ -65,6 +76,16 @@ public:
         return main.get();
     }
 
+    /** Set program propagating tuples added since the last evaluation */
+    void setIncremental(std::unique_ptr<RamStatement> stmt) {
+        incremental = std::move(stmt);
+    }
+
+    /** Get incremental program, or nullptr if the program is not evaluated incrementally */
+    RamStatement* getIncremental() const {
+        return incremental.get();
+    }
+
     /** Add relation */
     void addRelation(std::string name, std::unique_ptr<RamRelation> rel) {
         relations.insert(std::make_pair(name, std::move(rel)));
@@ -97,6 +118,9 @@ public:
     /** Create clone */
     RamProgram* clone() const override {
         RamProgram* res = new RamProgram(std::unique_ptr<RamStatement>(main->clone()));
+        if (incremental) {
+            res->setIncremental(std::unique_ptr<RamStatement>(incremental->clone()));
+        }
         for (auto& cur : subroutines) {
             res->addSubroutine(cur.first, std::unique_ptr<RamStatement>(cur.second->clone()));
         }
@@ -106,6 +130,9 @@ public:
     /** Apply mapper */
     void apply(const RamNodeMapper& map) override {
         main = map(std::move(main));
+        if (incremental) {
+            incremental = map(std::move(incremental));
+        }
         for (auto& cur : subroutines) {
             subroutines[cur.first] = map(std::move(cur.second));
         }
@@ -128,7 +155,9 @@ protected:
                 }
             }
         }
-        return getMain() == other.getMain() && areSubroutinesEqual;
+        bool areIncrementalsEqual = (incremental == nullptr) == (other.incremental == nullptr) &&
+                                    (incremental == nullptr || *incremental == *other.incremental);
+        return getMain() == other.getMain() && areSubroutinesEqual && areIncrementalsEqual;
     }
 };
 
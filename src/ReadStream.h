@@ -19,7 +19,10 @@
 #include "SymbolMask.h"
 #include "SymbolTable.h"
 
+#include <exception>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace souffle {
 
@@ -29,21 +32,114 @@ public:
             : symbolMask(symbolMask), symbolTable(symbolTable), isProvenance(prov) {}
     template <typename T>
     void readAll(T& relation) {
-        auto lease = symbolTable.acquireLock();
-        (void)lease;
-        while (const auto next = readNextTuple()) {
-            const RamDomain* ramDomain = next.get();
-            relation.insert(ramDomain);
-        }
+        readAll(relation, 0);
     }
 
     virtual ~ReadStream() = default;
 
+private:
+    /**
+     * Read tuples into a relation building its indices in bulk from batches of rows; the tuples
+     * read before an error are inserted before the error is passed on
+     */
+    template <typename T>
+    auto readAll(T& relation, int)
+            -> decltype(relation.insertRows(std::declval<const RamDomain*>(), size_t()), void()) {
+        const size_t arity = symbolMask.getArity();
+        std::vector<RamDomain> rows;
+        std::vector<RamDomain> block;
+        size_t count = 0;
+        try {
+            while (size_t numTuples = readNextTuples(block)) {
+                // large blocks are inserted without being copied
+                if (count == 0 && numTuples >= BULK_SIZE) {
+                    relation.insertRows(block.data(), numTuples);
+                    continue;
+                }
+                rows.insert(rows.end(), block.begin(), block.begin() + numTuples * arity);
+                count += numTuples;
+                if (count >= BULK_SIZE) {
+                    relation.insertRows(rows.data(), count);
+                    rows.clear();
+                    count = 0;
+                }
+            }
+        } catch (...) {
+            relation.insertRows(rows.data(), count);
+            throw;
+        }
+        relation.insertRows(rows.data(), count);
+    }
+
+    /** Read tuples block by block into any other relation, inserting them one at a time */
+    template <typename T>
+    void readAll(T& relation, long) {
+        const size_t arity = symbolMask.getArity();
+        std::vector<RamDomain> block;
+        while (size_t numTuples = readNextTuples(block)) {
+            for (size_t i = 0; i < numTuples; ++i) {
+                const RamDomain* ramDomain = block.data() + i * arity;
+                relation.insert(ramDomain);
+            }
+        }
+    }
+
 protected:
     virtual std::unique_ptr<RamDomain[]> readNextTuple() = 0;
+
+    /**
+     * Read the next block of tuples, which are stored consecutively in the given buffer.
+     *
+     * Returns the number of tuples read, or zero if no tuple was readable. An error raised
+     * after some tuples of the block were read is deferred to the next call, such that the
+     * tuples before it are returned.
+     */
+    virtual size_t readNextTuples(std::vector<RamDomain>& block) {
+        rethrowPendingError();
+        const size_t arity = symbolMask.getArity();
+        size_t numTuples = 0;
+        block.clear();
+        while (numTuples < BLOCK_SIZE) {
+            std::unique_ptr<RamDomain[]> next;
+            try {
+                next = readNextTuple();
+            } catch (...) {
+                if (numTuples == 0) {
+                    throw;
+                }
+                pendingError = std::current_exception();
+                break;
+            }
+            if (!next) {
+                break;
+            }
+            block.insert(block.end(), next.get(), next.get() + arity);
+            ++numTuples;
+        }
+        return numTuples;
+    }
+
+    /** Raise an error deferred by a previous call of readNextTuples, if any */
+    void rethrowPendingError() {
+        if (pendingError) {
+            std::exception_ptr error = pendingError;
+            pendingError = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    /** Number of tuples read at once by the default implementation of readNextTuples */
+    static const size_t BLOCK_SIZE = 1024;
+
+    /** Number of tuples collected before they are inserted into a relation in bulk */
+    static const size_t BULK_SIZE = 1 << 16;
+
     const SymbolMask& symbolMask;
     SymbolTable& symbolTable;
     const bool isProvenance;
+
+    /** An error raised while reading a block of tuples, passed on by the next call of readNextTuples */
+    std::exception_ptr pendingError;
 };
 
 class ReadStreamFactory {
@@ -0,0 +1,239 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ReadStreamBinary.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "IODirectives.h"
+#include "RamTypes.h"
+#include "ReadStream.h"
+#include "StreamBinary.h"
+#include "SymbolMask.h"
+#include "SymbolTable.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace souffle {
+
+/**
+ * Reads a relation in the binary fact format described in StreamBinary.h.
+ *
+ * The file is mapped into memory. The file-local symbol dictionary is
+ * interned into the symbol table in a single pass, after which symbol
+ * columns are remapped while tuples are assembled from the columns.
+ */
+class ReadFileBinary : public StreamBinary, public ReadStream {
+public:
+    ReadFileBinary(const SymbolMask& symbolMask, SymbolTable& symbolTable, const IODirectives& ioDirectives,
+            const bool provenance = false)
+            : ReadStream(symbolMask, symbolTable, provenance),
+              baseName(souffle::baseName(getFileName(ioDirectives))) {
+        // map file into memory
+        int fd = open(getFileName(ioDirectives).c_str(), O_RDONLY);
+        struct stat fileStat;
+        if (fd < 0 || fstat(fd, &fileStat) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            throw std::invalid_argument("Cannot open fact file " + baseName + "\n");
+        }
+        size = fileStat.st_size;
+        if (size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::invalid_argument("Cannot map fact file " + baseName + "\n");
+            }
+            data = static_cast<const char*>(mapped);
+        }
+        close(fd);
+
+        try {
+            readHeader();
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    ~ReadFileBinary() override {
+        unmap();
+    }
+
+protected:
+    /**
+     * Read and return the next tuple.
+     *
+     * Returns nullptr if no tuple was readable.
+     */
+    std::unique_ptr<RamDomain[]> readNextTuple() override {
+        if (nextTuple >= numTuples) {
+            return nullptr;
+        }
+        loadSymbols();
+        auto tuple = std::make_unique<RamDomain[]>(symbolMask.getArity());
+        readTuple(nextTuple++, tuple.get());
+        return tuple;
+    }
+
+    /**
+     * Read the next block of tuples, which are stored consecutively in the given buffer.
+     *
+     * Returns the number of tuples read, or zero if no tuple was readable.
+     */
+    size_t readNextTuples(std::vector<RamDomain>& block) override {
+        rethrowPendingError();
+        const size_t arity = symbolMask.getArity();
+        const size_t remaining = numTuples - nextTuple;
+        const size_t count = (remaining < BINARY_BLOCK_SIZE) ? remaining : BINARY_BLOCK_SIZE;
+        if (count == 0) {
+            return 0;
+        }
+        loadSymbols();
+        block.resize(count * arity);
+        for (size_t i = 0; i < count; ++i) {
+            try {
+                readTuple(nextTuple++, block.data() + i * arity);
+            } catch (...) {
+                // return the tuples before the invalid one and raise the error on the next call
+                if (i == 0) {
+                    throw;
+                }
+                pendingError = std::current_exception();
+                block.resize(i * arity);
+                return i;
+            }
+        }
+        return count;
+    }
+
+    /** Check the header and locate the columns and the symbol dictionary */
+    void readHeader() {
+        if (size < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0) {
+            throw std::invalid_argument("Invalid header in fact file " + baseName + "\n");
+        }
+        if (decode<uint32_t>(data + 4) != VERSION) {
+            throw std::invalid_argument("Unsupported version of fact file " + baseName + "\n");
+        }
+        if (decode<uint32_t>(data + 8) != sizeof(RamDomain)) {
+            throw std::invalid_argument("Mismatching domain size in fact file " + baseName + "\n");
+        }
+        numColumns = decode<uint32_t>(data + 12);
+        numTuples = decode<uint64_t>(data + 16);
+        numSymbols = decode<uint64_t>(data + 24);
+
+        const size_t arity = symbolMask.getArity();
+        if (numColumns != (isProvenance ? arity - 2 : arity)) {
+            throw std::invalid_argument("Mismatching arity in fact file " + baseName + "\n");
+        }
+
+        // check that columns and symbol offsets fit into the file
+        const size_t offsetPos = HEADER_SIZE + numColumns * numTuples * sizeof(RamDomain);
+        const size_t symbolPos = offsetPos + (numSymbols + 1) * sizeof(uint64_t);
+        if (numTuples > size || numSymbols > size || symbolPos > size ||
+                decode<uint64_t>(data + symbolPos - sizeof(uint64_t)) > size - symbolPos) {
+            throw std::invalid_argument("Truncated fact file " + baseName + "\n");
+        }
+        columnData = data + HEADER_SIZE;
+        offsetData = data + offsetPos;
+        symbolData = data + symbolPos;
+    }
+
+    /** Intern the file-local symbol dictionary into the symbol table */
+    void loadSymbols() {
+        if (symbolsLoaded) {
+            return;
+        }
+        symbolsLoaded = true;
+        symbolIndex.reserve(numSymbols);
+        // only the final offset has been checked against the size of the file
+        const uint64_t last = decode<uint64_t>(offsetData + numSymbols * sizeof(uint64_t));
+        for (size_t i = 0; i < numSymbols; ++i) {
+            uint64_t begin = decode<uint64_t>(offsetData + i * sizeof(uint64_t));
+            uint64_t end = decode<uint64_t>(offsetData + (i + 1) * sizeof(uint64_t));
+            if (begin > end || end > last) {
+                throw std::invalid_argument("Invalid symbol dictionary in fact file " + baseName + "\n");
+            }
+            symbolIndex.push_back(symbolTable.unsafeLookup(std::string(symbolData + begin, end - begin)));
+        }
+    }
+
+    /** Assemble the tuple with the given index from the columns */
+    void readTuple(size_t index, RamDomain* tuple) const {
+        for (size_t col = 0; col < numColumns; ++col) {
+            RamDomain value = decode<RamDomain>(columnData + (col * numTuples + index) * sizeof(RamDomain));
+            if (symbolMask.isSymbol(col)) {
+                if (value < 0 || static_cast<size_t>(value) >= symbolIndex.size()) {
+                    throw std::invalid_argument("Invalid symbol in column " + std::to_string(col + 1) +
+                                                " of fact file " + baseName + "\n");
+                }
+                value = symbolIndex[value];
+            }
+            tuple[col] = value;
+        }
+
+        // add two provenance columns
+        if (isProvenance) {
+            tuple[numColumns] = 0;
+            tuple[numColumns + 1] = 0;
+        }
+    }
+
+    void unmap() {
+        if (data != nullptr) {
+            munmap(const_cast<char*>(data), size);
+            data = nullptr;
+        }
+    }
+
+    /** Number of tuples assembled per call of readNextTuples */
+    static const size_t BINARY_BLOCK_SIZE = 4096;
+
+    std::string baseName;
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t numColumns = 0;
+    size_t numTuples = 0;
+    size_t numSymbols = 0;
+    const char* columnData = nullptr;
+    const char* offsetData = nullptr;
+    const char* symbolData = nullptr;
+    bool symbolsLoaded = false;
+    std::vector<RamDomain> symbolIndex;
+    size_t nextTuple = 0;
+};
+
+class ReadFileBinaryFactory : public ReadStreamFactory {
+public:
+    std::unique_ptr<ReadStream> getReader(const SymbolMask& symbolMask, SymbolTable& symbolTable,
+            const IODirectives& ioDirectives, const bool provenance) override {
+        return std::make_unique<ReadFileBinary>(symbolMask, symbolTable, ioDirectives, provenance);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "binary";
+        return name;
+    }
+    ~ReadFileBinaryFactory() override = default;
+};
+
+} /* namespace souffle */
@@ -23,15 +23,29 @@
 
 #ifdef USE_LIBZ
 #include "gzfstream.h"
-#else
-#include <fstream>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace souffle {
 
@@ -154,14 +168,15 @@ protected:
         return tuple;
     }
 
-    std::string getDelimiter(const IODirectives& ioDirectives) const {
+public:
+    static std::string getDelimiter(const IODirectives& ioDirectives) {
         if (ioDirectives.has("delimiter")) {
             return ioDirectives.get("delimiter");
         }
         return "\t";
     }
 
-    std::map<int, int> getInputColumnMap(const IODirectives& ioDirectives, const unsigned arity) const {
+    static std::map<int, int> getInputColumnMap(const IODirectives& ioDirectives, const unsigned arity) {
         std::string columnString = "";
         if (ioDirectives.has("columns")) {
             columnString = ioDirectives.get("columns");
@@ -187,6 +202,7 @@ protected:
         return inputMap;
     }
 
+protected:
     const std::string delimiter;
     std::istream& file;
     size_t lineNumber;
@@ -244,6 +260,366 @@ protected:
 #endif
 };
 
+/**
+ * A reader for uncompressed fact files, enabled by the IO directive mmap=true.
+ *
+ * The file is mapped into memory and split at line boundaries into chunks,
+ * which are parsed in parallel. Delimiters are located by memchr and numbers
+ * are converted in place, without copying fields. Symbols are collected per
+ * chunk, each distinct symbol once, and interned in one batch per chunk in the
+ * order of the file, such that they obtain the same indices as with the stream
+ * reader. Chunks are parsed in rounds of one chunk per thread, such that only
+ * the tuples of a single round are held besides the relation.
+ */
+class ReadMappedFileCSV : public ReadStream {
+public:
+    ReadMappedFileCSV(const SymbolMask& symbolMask, SymbolTable& symbolTable, const IODirectives& ioDirectives,
+            const bool provenance = false)
+            : ReadStream(symbolMask, symbolTable, provenance),
+              delimiter(ReadStreamCSV::getDelimiter(ioDirectives)),
+              baseName(souffle::baseName(getFileName(ioDirectives))), skipHeader(false) {
+        // compute the target position of each input column
+        const size_t arity = symbolMask.getArity();
+        for (const auto& cur : ReadStreamCSV::getInputColumnMap(ioDirectives, arity)) {
+            columns.resize(std::max<size_t>(columns.size(), cur.first + 1), -1);
+            columns[cur.first] = cur.second;
+            if (symbolMask.isSymbol(cur.first)) {
+                symbolPositions.push_back(cur.second);
+            }
+        }
+        if (!ioDirectives.has("intermediate")) {
+            skipHeader = ioDirectives.has("headers") && ioDirectives.get("headers") == "true";
+        }
+
+        // map file into memory
+        int fd = open(getFileName(ioDirectives).c_str(), O_RDONLY);
+        struct stat fileStat;
+        if (fd < 0 || fstat(fd, &fileStat) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            throw std::invalid_argument("Cannot open fact file " + baseName + "\n");
+        }
+        size = fileStat.st_size;
+        if (size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::invalid_argument("Cannot map fact file " + baseName + "\n");
+            }
+            data = static_cast<const char*>(mapped);
+            madvise(mapped, size, MADV_SEQUENTIAL);
+        }
+        close(fd);
+    }
+
+    ~ReadMappedFileCSV() override {
+        if (data != nullptr) {
+            munmap(const_cast<char*>(data), size);
+        }
+    }
+
+protected:
+    /**
+     * Read and return the next tuple.
+     *
+     * Returns nullptr if no tuple was readable.
+     */
+    std::unique_ptr<RamDomain[]> readNextTuple() override {
+        const size_t arity = symbolMask.getArity();
+        while (nextTuple >= numTuplesOfLastChunk) {
+            if (!loadNextChunk()) {
+                return nullptr;
+            }
+        }
+        auto tuple = std::make_unique<RamDomain[]>(arity);
+        std::copy_n(chunks[nextChunk - 1].tuples.data() + nextTuple * arity, arity, tuple.get());
+        ++nextTuple;
+        return tuple;
+    }
+
+    /**
+     * Read the tuples of the next chunk of the file.
+     *
+     * Returns the number of tuples read, or zero if no tuple was readable.
+     */
+    size_t readNextTuples(std::vector<RamDomain>& block) override {
+        do {
+            if (!loadNextChunk()) {
+                return 0;
+            }
+        } while (numTuplesOfLastChunk == 0);
+        block.swap(chunks[nextChunk - 1].tuples);
+        nextTuple = numTuplesOfLastChunk;
+        return numTuplesOfLastChunk;
+    }
+
+    /** A part of the file being parsed by a single thread */
+    struct Chunk {
+        const char* begin;
+        const char* end;
+        std::vector<RamDomain> tuples;
+        size_t numTuples = 0;
+        size_t numLines = 0;
+        std::vector<std::string> symbols;  // symbols in order of their first occurrence
+        std::string error;                 // error message of first invalid line, if any
+    };
+
+    /** Split the file at line boundaries into chunks, which are parsed later in rounds */
+    void splitIntoChunks() {
+        const char* begin = data;
+        const char* end = data + size;
+
+        // skip header line
+        if (skipHeader && begin != end) {
+            const char* eol = static_cast<const char*>(memchr(begin, '\n', end - begin));
+            begin = (eol == nullptr) ? end : eol + 1;
+        }
+
+        // chunks are small enough to bound the memory of the tuples parsed in a round
+        size_t numChunks = 1 + (end - begin) / MAX_CHUNK_SIZE;
+#ifdef _OPENMP
+        if (static_cast<size_t>(end - begin) > MIN_CHUNK_SIZE) {
+            numChunks = std::max<size_t>(numChunks,
+                    std::min<size_t>(4 * omp_get_max_threads(), (end - begin) / MIN_CHUNK_SIZE));
+        }
+#endif
+        const char* cur = begin;
+        for (size_t i = 1; i <= numChunks && cur != end; ++i) {
+            const char* split = (i == numChunks) ? end : begin + (end - begin) * i / numChunks;
+            if (split < cur) {
+                continue;
+            }
+            if (split != end) {
+                const char* eol = static_cast<const char*>(memchr(split, '\n', end - split));
+                split = (eol == nullptr) ? end : eol + 1;
+            }
+            chunks.emplace_back();
+            chunks.back().begin = cur;
+            chunks.back().end = split;
+            cur = split;
+        }
+    }
+
+    /**
+     * Parse the chunks of the next round in parallel, one chunk per thread, such that only the
+     * tuples of a single round are held at once; chunks after the first error are dropped
+     */
+    void parseRound() {
+        size_t roundSize = 1;
+#ifdef _OPENMP
+        roundSize = getTaskThreads();
+#endif
+        const size_t first = numParsed;
+        const size_t last = std::min(chunks.size(), first + roundSize);
+#pragma omp parallel for schedule(dynamic) num_threads(getTaskThreads())
+        for (size_t i = first; i < last; ++i) {
+            parseChunk(chunks[i]);
+        }
+        numParsed = last;
+
+        // keep the first error in the file, which is raised once the tuples before it are read
+        for (size_t i = first; i < last; ++i) {
+            if (!chunks[i].error.empty()) {
+                std::stringstream errorMessage;
+                errorMessage << chunks[i].error << " in line " << numLines + chunks[i].numLines << "; ";
+                errorMessage << "cannot parse fact file " << baseName << "!\n";
+                error = errorMessage.str();
+                chunks.resize(i + 1);
+                numParsed = i + 1;
+                break;
+            }
+            numLines += chunks[i].numLines;
+        }
+    }
+
+    /** Make the tuples of the next chunk available, interning its symbols */
+    bool loadNextChunk() {
+        if (!chunked) {
+            splitIntoChunks();
+            chunked = true;
+        }
+        if (nextChunk > 0) {
+            // release tuples and symbols of previous chunk
+            std::vector<RamDomain>().swap(chunks[nextChunk - 1].tuples);
+            std::vector<std::string>().swap(chunks[nextChunk - 1].symbols);
+        }
+        numTuplesOfLastChunk = 0;
+        nextTuple = 0;
+        if (nextChunk >= numParsed && nextChunk < chunks.size()) {
+            parseRound();
+        }
+        if (nextChunk >= chunks.size()) {
+            if (!error.empty()) {
+                throw std::invalid_argument(error);
+            }
+            return false;
+        }
+        Chunk& chunk = chunks[nextChunk++];
+
+        // replace chunk-local symbol numbers by symbol table indices; the symbols of a chunk are
+        // interned in one batch in the order of the file
+        if (!chunk.symbols.empty()) {
+            std::vector<RamDomain> symbolIndex(chunk.symbols.size());
+            symbolTable.lookup(chunk.symbols.data(), chunk.symbols.size(), symbolIndex.data());
+            const size_t arity = symbolMask.getArity();
+            for (size_t i = 0; i < chunk.numTuples; ++i) {
+                RamDomain* tuple = chunk.tuples.data() + i * arity;
+                for (size_t pos : symbolPositions) {
+                    tuple[pos] = symbolIndex[tuple[pos]];
+                }
+            }
+        }
+        numTuplesOfLastChunk = chunk.numTuples;
+        nextTuple = 0;
+        return true;
+    }
+
+    /** Parse the lines of a chunk; errors are recorded in the chunk */
+    void parseChunk(Chunk& chunk) const {
+        const size_t arity = symbolMask.getArity();
+        const size_t numColumns = isProvenance ? arity - 2 : arity;
+        std::unordered_map<std::string, RamDomain> localSymbols;
+        std::vector<RamDomain> tuple(arity);
+
+        const char* cur = chunk.begin;
+        while (cur != chunk.end) {
+            // find end of line, handle Windows line endings on non-Windows systems
+            const char* eol = static_cast<const char*>(memchr(cur, '\n', chunk.end - cur));
+            const char* next = (eol == nullptr) ? chunk.end : eol + 1;
+            if (eol == nullptr) {
+                eol = chunk.end;
+            }
+            if (eol != cur && *(eol - 1) == '\r') {
+                --eol;
+            }
+            ++chunk.numLines;
+
+            // split line into cells
+            size_t columnsFilled = 0;
+            const char* start = cur;
+            for (size_t column = 0; start < eol || (column > 0 && start == eol); ++column) {
+                if (isProvenance && columnsFilled >= numColumns) {
+                    break;
+                }
+                const char* cellEnd = findDelimiter(start, eol);
+                const char* nextStart = cellEnd + delimiter.size();
+                if (column >= columns.size() || columns[column] < 0) {
+                    start = nextStart;
+                    continue;
+                }
+                ++columnsFilled;
+                int pos = columns[column];
+                bool isEmpty = (cellEnd == start);
+                if (symbolMask.isSymbol(column)) {
+                    std::string element = isEmpty ? "n/a" : std::string(start, cellEnd);
+                    auto it = localSymbols.find(element);
+                    if (it == localSymbols.end()) {
+                        it = localSymbols.emplace(element, chunk.symbols.size()).first;
+                        chunk.symbols.push_back(element);
+                    }
+                    tuple[pos] = it->second;
+                } else if (isEmpty || !parseNumber(start, cellEnd, tuple[pos])) {
+                    chunk.error = "Error converting number <" +
+                                  (isEmpty ? std::string("n/a") : std::string(start, cellEnd)) +
+                                  "> in column " + std::to_string(column + 1);
+                    return;
+                }
+                start = nextStart;
+            }
+
+            // add two provenance columns
+            if (isProvenance) {
+                tuple[arity - 2] = 0;
+                tuple[arity - 1] = 0;
+                if (columnsFilled == numColumns) {
+                    columnsFilled = arity;
+                }
+            }
+            if (columnsFilled != arity) {
+                chunk.error = "Values missing";
+                return;
+            }
+
+            chunk.tuples.insert(chunk.tuples.end(), tuple.begin(), tuple.end());
+            ++chunk.numTuples;
+            cur = next;
+        }
+    }
+
+    /** Locate the next delimiter in [begin,end), or end if there is none */
+    const char* findDelimiter(const char* begin, const char* end) const {
+        const char first = delimiter[0];
+        while (begin < end) {
+            const char* pos = static_cast<const char*>(memchr(begin, first, end - begin));
+            if (pos == nullptr) {
+                return end;
+            }
+            if (delimiter.size() == 1 ||
+                    (static_cast<size_t>(end - pos) >= delimiter.size() &&
+                            delimiter.compare(0, delimiter.size(), pos, delimiter.size()) == 0)) {
+                return pos;
+            }
+            begin = pos + 1;
+        }
+        return end;
+    }
+
+    /** Convert a number in [begin,end) like std::stoll, ignoring trailing characters */
+    static bool parseNumber(const char* begin, const char* end, RamDomain& result) {
+        while (begin != end && std::isspace(static_cast<unsigned char>(*begin))) {
+            ++begin;
+        }
+        bool negative = false;
+        if (begin != end && (*begin == '-' || *begin == '+')) {
+            negative = (*begin == '-');
+            ++begin;
+        }
+        if (begin == end || !std::isdigit(static_cast<unsigned char>(*begin))) {
+            return false;
+        }
+        uint64_t value = 0;
+        const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<RamDomain>::max()) + (negative ? 1 : 0);
+        for (; begin != end && std::isdigit(static_cast<unsigned char>(*begin)); ++begin) {
+            value = value * 10 + (*begin - '0');
+            if (value > limit) {
+                return false;
+            }
+        }
+        result = negative ? static_cast<RamDomain>(0 - value) : static_cast<RamDomain>(value);
+        return true;
+    }
+
+    std::string getFileName(const IODirectives& ioDirectives) const {
+        if (ioDirectives.has("filename")) {
+            return ioDirectives.get("filename");
+        }
+        return ioDirectives.getRelationName() + ".facts";
+    }
+
+    /** Minimal size of a chunk parsed by a single thread */
+    static const size_t MIN_CHUNK_SIZE = 1 << 20;
+
+    /** Maximal size of a chunk parsed by a single thread */
+    static const size_t MAX_CHUNK_SIZE = 1 << 26;
+
+    const std::string delimiter;
+    std::string baseName;
+    bool skipHeader;
+    std::vector<int> columns;  // target position of each input column, or -1 if ignored
+    std::vector<size_t> symbolPositions;
+    const char* data = nullptr;
+    size_t size = 0;
+    bool chunked = false;
+    std::string error;  // error message of the first invalid line of the file, if any
+    std::vector<Chunk> chunks;
+    size_t numParsed = 0;  // number of chunks parsed so far
+    size_t numLines = 0;   // number of lines of the parsed chunks before the first error
+    size_t nextChunk = 0;
+    size_t nextTuple = 0;
+    size_t numTuplesOfLastChunk = 0;
+};
+
 class ReadCinCSVFactory : public ReadStreamFactory {
 public:
     std::unique_ptr<ReadStream> getReader(const SymbolMask& symbolMask, SymbolTable& symbolTable,
@@ -261,6 +637,9 @@ class ReadFileCSVFactory : public ReadStreamFactory {
 public:
     std::unique_ptr<ReadStream> getReader(const SymbolMask& symbolMask, SymbolTable& symbolTable,
             const IODirectives& ioDirectives, const bool provenance) override {
+        if (ioDirectives.has("mmap") && ioDirectives.get("mmap") == "true" && !isCompressed(ioDirectives)) {
+            return std::make_unique<ReadMappedFileCSV>(symbolMask, symbolTable, ioDirectives, provenance);
+        }
         return std::make_unique<ReadFileCSV>(symbolMask, symbolTable, ioDirectives, provenance);
     }
     const std::string& getName() const override {
@@ -269,6 +648,17 @@ public:
     }
 
     ~ReadFileCSVFactory() override = default;
+
+private:
+    /** Check whether a fact file is compressed and thus cannot be mapped into memory */
+    static bool isCompressed(const IODirectives& ioDirectives) {
+        std::string fileName = ioDirectives.has("filename") ? ioDirectives.get("filename")
+                                                             : ioDirectives.getRelationName() + ".facts";
+        std::ifstream file(fileName, std::ios::binary);
+        char magic[2] = {0, 0};
+        file.read(magic, 2);
+        return file && magic[0] == '\x1f' && magic[1] == '\x8b';
+    }
 };
 
 } /* namespace souffle */
@@ -24,6 +24,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 
 #include <sqlite3.h>
 
@@ -35,14 +36,20 @@ public:
             const SymbolMask& symbolMask, SymbolTable& symbolTable, const bool provenance)
             : ReadStream(symbolMask, symbolTable, provenance), dbFilename(dbFilename),
               relationName(relationName) {
-        openDB();
-        checkTableExists();
-        prepareSelectStatement();
+        try {
+            openDB();
+            checkTableExists();
+            if (!prepareRawSelectStatement()) {
+                prepareSelectStatement();
+            }
+        } catch (...) {
+            closeDB();
+            throw;
+        }
     }
 
     ~ReadStreamSQLite() override {
-        sqlite3_finalize(selectStatement);
-        sqlite3_close(db);
+        closeDB();
     }
 
 protected:
@@ -53,14 +60,29 @@ protected:
      * @return
      */
     std::unique_ptr<RamDomain[]> readNextTuple() override {
-        if (sqlite3_step(selectStatement) != SQLITE_ROW) {
+        // a finished statement would restart when stepped again
+        if (finished || sqlite3_step(selectStatement) != SQLITE_ROW) {
+            finished = true;
             return nullptr;
         }
 
         std::unique_ptr<RamDomain[]> tuple = std::make_unique<RamDomain[]>(symbolMask.getArity());
+        const size_t numColumns = symbolMask.getArity() - (isProvenance ? 2 : 0);
 
         uint32_t column;
-        for (column = 0; column < symbolMask.getArity(); column++) {
+        for (column = 0; column < numColumns; column++) {
+            if (symbolSelectStatement != nullptr) {
+                // values of the underlying table are numbers or identifiers of symbols
+                if (sqlite3_column_type(selectStatement, column) != SQLITE_INTEGER) {
+                    std::stringstream errorMessage;
+                    errorMessage << "Error converting number in column " << (column) + 1;
+                    throw std::invalid_argument(errorMessage.str());
+                }
+                sqlite3_int64 value = sqlite3_column_int64(selectStatement, column);
+                tuple[column] = symbolMask.isSymbol(column) ? getSymbolIndex(value) : value;
+                continue;
+            }
+
             std::string element(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, column)));
 
             if (element.empty()) {
@@ -113,6 +135,68 @@ protected:
         throw std::invalid_argument(error.str());
     }
 
+    /** Return the index in the symbol table of a symbol stored in the database */
+    RamDomain getSymbolIndex(sqlite3_int64 id) {
+        auto cached = symbolIndex.find(id);
+        if (cached != symbolIndex.end()) {
+            return cached->second;
+        }
+        if (sqlite3_bind_int64(symbolSelectStatement, 1, id) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_bind_int64: ");
+        }
+        if (sqlite3_step(symbolSelectStatement) != SQLITE_ROW) {
+            sqlite3_reset(symbolSelectStatement);
+            throw std::invalid_argument(
+                    "Unknown symbol " + std::to_string(id) + " in relation " + relationName + "\n");
+        }
+        std::string symbol(reinterpret_cast<const char*>(sqlite3_column_text(symbolSelectStatement, 0)));
+        if (symbol.empty()) {
+            symbol = "n/a";
+        }
+        sqlite3_reset(symbolSelectStatement);
+        RamDomain index = symbolTable.unsafeLookup(symbol);
+        symbolIndex[id] = index;
+        return index;
+    }
+
+    /**
+     * Select from the table underlying the view of the relation, if it was written by souffle.
+     *
+     * Its values are read as numbers and each distinct symbol is fetched and interned only once,
+     * rather than joining every row with the symbol table and converting all values from text.
+     */
+    bool prepareRawSelectStatement() {
+        sqlite3_stmt* tableStatement;
+        const std::string tableSQL = "SELECT count(*) FROM sqlite_master WHERE type = 'table' AND name = '" +
+                                     symbolTableName + "';";
+        if (sqlite3_prepare_v2(db, tableSQL.c_str(), -1, &tableStatement, nullptr) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
+        }
+        bool hasSymbolTable =
+                sqlite3_step(tableStatement) == SQLITE_ROW && sqlite3_column_int(tableStatement, 0) == 1;
+        sqlite3_finalize(tableStatement);
+        if (!hasSymbolTable) {
+            return false;
+        }
+
+        const std::string selectSQL = "SELECT * FROM '_" + relationName + "'";
+        if (sqlite3_prepare_v2(db, selectSQL.c_str(), -1, &selectStatement, nullptr) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
+        }
+        const size_t numColumns = symbolMask.getArity() - (isProvenance ? 2 : 0);
+        if (static_cast<size_t>(sqlite3_column_count(selectStatement)) != numColumns) {
+            sqlite3_finalize(selectStatement);
+            selectStatement = nullptr;
+            return false;
+        }
+
+        const std::string symbolSQL = "SELECT symbol FROM '" + symbolTableName + "' WHERE id = @V0;";
+        if (sqlite3_prepare_v2(db, symbolSQL.c_str(), -1, &symbolSelectStatement, nullptr) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
+        }
+        return true;
+    }
+
     void prepareSelectStatement() {
         std::stringstream selectSQL;
         selectSQL << "SELECT * FROM '" << relationName << "'";
@@ -122,6 +206,14 @@ protected:
         }
     }
 
+    /** Release the statements and the connection */
+    void closeDB() {
+        sqlite3_finalize(selectStatement);
+        sqlite3_finalize(symbolSelectStatement);
+        sqlite3_close(db);
+        db = nullptr;
+    }
+
     void openDB() {
         if (sqlite3_open(dbFilename.c_str(), &db) != SQLITE_OK) {
             throwError("SQLite error in sqlite3_open: ");
@@ -152,10 +244,14 @@ protected:
         sqlite3_finalize(tableStatement);
         throw std::invalid_argument("Required table and view does not exist for relation " + relationName);
     }
-    const std::string& dbFilename;
-    const std::string& relationName;
+    const std::string dbFilename;
+    const std::string relationName;
+    const std::string symbolTableName = "__SymbolTable";
+    std::unordered_map<sqlite3_int64, RamDomain> symbolIndex;
     sqlite3_stmt* selectStatement = nullptr;
+    sqlite3_stmt* symbolSelectStatement = nullptr;
     sqlite3* db = nullptr;
+    bool finished = false;
 };
 
 class ReadSQLiteFactory : public ReadStreamFactory {
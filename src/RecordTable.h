@@ -0,0 +1,217 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file RecordTable.h
+ *
+ * The storage of records shared by the interpreter and the compiled
+ * execution.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "ParallelUtils.h"
+#include "RamTypes.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * A bidirectional mapping between tuples of a fixed arity and reference indices.
+ *
+ * Tuples are stored consecutively in blocks, which double in size and are
+ * never moved, such that unpacking a reference neither locks nor waits. The
+ * index from tuples to references is split into shards, each protected by
+ * its own lock, such that concurrent packs rarely contend.
+ */
+class RecordMap {
+    /** Number of tuples of the first block; each further block doubles in size */
+    static const size_t FIRST_BLOCK_SIZE = 1024;
+
+    /** Maximal number of blocks */
+    static const size_t NUM_BLOCKS = 48;
+
+    /** Number of independently locked shards of the index from tuples to references */
+    static const size_t NUM_SHARDS = 64;
+
+    /** Hashes tuples referenced by pointer */
+    struct TupleHash {
+        size_t arity;
+        size_t operator()(const RamDomain* tuple) const {
+            uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < arity; ++i) {
+                hash = (hash ^ static_cast<uint64_t>(tuple[i])) * 1099511628211ull;
+            }
+            return static_cast<size_t>(hash ^ (hash >> 32));
+        }
+    };
+
+    /** Compares tuples referenced by pointer */
+    struct TupleEqual {
+        size_t arity;
+        bool operator()(const RamDomain* a, const RamDomain* b) const {
+            return std::equal(a, a + arity, b);
+        }
+    };
+
+    using index_type = std::unordered_map<const RamDomain*, RamDomain, TupleHash, TupleEqual>;
+
+    /** A part of the index from tuples to references, keyed by tuples stored in the blocks */
+    struct Shard {
+        Lock lock;
+        index_type r2i;
+    };
+
+    /** The arity of the stored tuples */
+    const size_t arity;
+
+    /** The blocks holding the tuples; a reference is the position of its tuple */
+    std::atomic<RamDomain*> i2r[NUM_BLOCKS];
+
+    /** The next reference to be handed out; 0 is reserved for the Nil element */
+    std::atomic<size_t> next;
+
+    /** The mapping from tuples to references */
+    Shard shards[NUM_SHARDS];
+
+    /** Compute the block holding the given reference and the position of its tuple within the block */
+    static std::pair<size_t, size_t> getPosition(size_t index) {
+        const size_t scaled = index / FIRST_BLOCK_SIZE + 1;
+        const size_t block = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(scaled);
+        return std::make_pair(block, index - FIRST_BLOCK_SIZE * ((size_t(1) << block) - 1));
+    }
+
+    /** Obtain the storage of the tuple of the given reference, allocating its block if necessary */
+    RamDomain* getSlot(size_t index) {
+        const auto pos = getPosition(index);
+        RamDomain* block = i2r[pos.first].load(std::memory_order_acquire);
+        if (block == nullptr) {
+            auto* fresh = new RamDomain[(FIRST_BLOCK_SIZE << pos.first) * arity + 1];
+            if (i2r[pos.first].compare_exchange_strong(block, fresh, std::memory_order_acq_rel)) {
+                block = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        return block + pos.second * arity;
+    }
+
+public:
+    explicit RecordMap(size_t arity) : arity(arity), i2r(), next(1) {
+        for (auto& shard : shards) {
+            shard.r2i = index_type(0, TupleHash{arity}, TupleEqual{arity});
+        }
+    }
+
+    RecordMap(const RecordMap&) = delete;
+    RecordMap& operator=(const RecordMap&) = delete;
+
+    ~RecordMap() {
+        for (auto& block : i2r) {
+            delete[] block.load();
+        }
+    }
+
+    /**
+     * Packs the given tuple -- and may create a new reference if necessary.
+     */
+    RamDomain pack(const RamDomain* tuple) {
+        Shard& shard = shards[(TupleHash{arity}(tuple) >> 8) % NUM_SHARDS];
+        auto lease = shard.lock.acquire();
+        (void)lease;  // avoid warning
+
+        // try lookup
+        auto pos = shard.r2i.find(tuple);
+        if (pos != shard.r2i.end()) {
+            return pos->second;
+        }
+
+        // store tuple and add it to index
+        size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        assert(index < static_cast<size_t>(std::numeric_limits<RamDomain>::max()));
+        RamDomain* slot = getSlot(index);
+        std::copy(tuple, tuple + arity, slot);
+        shard.r2i.emplace(slot, index);
+        return index;
+    }
+
+    /**
+     * Obtains a pointer to the tuple addressed by the given reference.
+     */
+    const RamDomain* unpack(RamDomain index) const {
+        const auto pos = getPosition(index);
+        return i2r[pos.first].load(std::memory_order_acquire) + pos.second * arity;
+    }
+
+    /**
+     * Obtains the number of stored tuples.
+     */
+    size_t size() const {
+        return next.load(std::memory_order_acquire) - 1;
+    }
+};
+
+namespace detail {
+
+/** The record maps of all arities, created on demand */
+struct RecordMaps {
+    Lock lock;
+    std::map<size_t, std::unique_ptr<RecordMap>> maps;
+};
+
+inline RecordMaps& getRecordMaps() {
+    static RecordMaps recordMaps;
+    return recordMaps;
+}
+
+}  // namespace detail
+
+/**
+ * The static access function for the record map of a certain arity.
+ *
+ * Callers should keep the returned map rather than looking it up for every record.
+ */
+inline RecordMap& getRecordMap(size_t arity) {
+    auto& recordMaps = detail::getRecordMaps();
+    auto lease = recordMaps.lock.acquire();
+    (void)lease;  // avoid warning
+    auto& map = recordMaps.maps[arity];
+    if (!map) {
+        map = std::make_unique<RecordMap>(arity);
+    }
+    return *map;
+}
+
+/**
+ * Obtains the arities of all record maps created so far, in ascending order.
+ */
+inline std::vector<size_t> getRecordArities() {
+    auto& recordMaps = detail::getRecordMaps();
+    auto lease = recordMaps.lock.acquire();
+    (void)lease;  // avoid warning
+    std::vector<size_t> arities;
+    for (const auto& cur : recordMaps.maps) {
+        arities.push_back(cur.first);
+    }
+    return arities;
+}
+
+}  // end of namespace souffle
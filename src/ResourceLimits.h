@@ -0,0 +1,181 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file ResourceLimits.h
+ *
+ * Limits on the number of tuples of relations and on the evaluation time
+ * of strata, shared by the interpreter and the compiled execution.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * The exception raised when the evaluation of a program exceeds one of its limits.
+ */
+class ResourceLimitExceeded : public std::runtime_error {
+public:
+    explicit ResourceLimitExceeded(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+/**
+ * Limits on the resources of an evaluation, i.e., on the number of tuples of
+ * each relation and on the wall-clock time of each stratum.
+ *
+ * Limits are checked after merges and rules and at every iteration of a
+ * fixpoint loop, i.e., never inside of parallel loops. A violated limit
+ * raises a ResourceLimitExceeded naming the rules of the current stratum
+ * responsible for it.
+ */
+class ResourceLimits {
+public:
+    /** A rule given by the relation it computes and its text */
+    using Rule = std::pair<std::string, std::string>;
+
+    /**
+     * Set the limits of tuples, given either as a number for all relations or as a
+     * comma separated list of <relation>=<number>; throws std::invalid_argument if
+     * the limits are malformed
+     */
+    void setTupleLimits(const std::string& spec) {
+        std::stringstream ss(spec);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            auto pos = item.find('=');
+            if (pos == std::string::npos) {
+                defaultTupleLimit = parseNumber(item);
+                continue;
+            }
+            // relations in components are named by '.' in programs and by '-' in RAM
+            std::string relName = item.substr(0, pos);
+            std::replace(relName.begin(), relName.end(), '.', '-');
+            tupleLimits[relName] = parseNumber(item.substr(pos + 1));
+        }
+    }
+
+    /** Set the limit of seconds for each stratum; throws std::invalid_argument if it is malformed */
+    void setStratumTimeout(const std::string& seconds) {
+        stratumTimeout = parseNumber(seconds);
+    }
+
+    /** Determine whether any limit is set */
+    bool isEnabled() const {
+        return defaultTupleLimit > 0 || !tupleLimits.empty() || stratumTimeout > 0;
+    }
+
+    /** Get the limit of tuples of a relation given by its name in RAM, or 0 if it is unlimited */
+    size_t getTupleLimit(const std::string& relName) const {
+        // temporary relations are checked when merged into their relation
+        if (relName.empty() || relName[0] == '@') {
+            return 0;
+        }
+        auto pos = tupleLimits.find(relName);
+        return pos != tupleLimits.end() ? pos->second : defaultTupleLimit;
+    }
+
+    /** Get the index of the current stratum */
+    size_t getStratumIndex() const {
+        return stratumIndex;
+    }
+
+    /** Start the time limit of a stratum, given with its rules */
+    void startStratum(size_t index, std::vector<Rule> rules) {
+        stratumIndex = index;
+        stratumRules = std::move(rules);
+        stratumStart = std::chrono::steady_clock::now();
+    }
+
+    /** Check the number of tuples of a relation given by its name in RAM */
+    void checkSize(const std::string& relName, size_t size) const {
+        size_t limit = getTupleLimit(relName);
+        if (limit == 0 || size <= limit) {
+            return;
+        }
+        std::stringstream msg;
+        msg << "Relation " << relName << " exceeded its limit of " << limit << " tuples with " << size
+            << " tuples in rules:\n";
+        for (const auto& rule : stratumRules) {
+            if (rule.first == relName || rule.first == "@new_" + relName) {
+                msg << rule.second << "\n";
+            }
+        }
+        throw ResourceLimitExceeded(msg.str());
+    }
+
+    /** Check the time spent in the current stratum */
+    void checkTime() const {
+        if (stratumTimeout == 0) {
+            return;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - stratumStart;
+        if (elapsed <= std::chrono::seconds(stratumTimeout)) {
+            return;
+        }
+        std::stringstream msg;
+        msg << "Stratum " << stratumIndex << " exceeded its limit of " << stratumTimeout
+            << " seconds in rules:\n";
+        for (const auto& rule : stratumRules) {
+            msg << rule.second << "\n";
+        }
+        throw ResourceLimitExceeded(msg.str());
+    }
+
+    /** Report an exceeded limit together with the current numbers of tuples of relations */
+    static void report(const ResourceLimitExceeded& e, const std::map<std::string, size_t>& sizes,
+            std::ostream& out) {
+        out << "Evaluation aborted: " << e.what() << "Current sizes of relations:\n";
+        for (const auto& cur : sizes) {
+            out << "\t" << cur.first << "\t" << cur.second << "\n";
+        }
+    }
+
+private:
+    /** Parse a positive number of a limit */
+    static size_t parseNumber(const std::string& str) {
+        if (str.empty() || str.find_first_not_of("0123456789") != std::string::npos ||
+                std::strtoull(str.c_str(), nullptr, 10) == 0) {
+            throw std::invalid_argument("Invalid resource limit " + str);
+        }
+        return std::strtoull(str.c_str(), nullptr, 10);
+    }
+
+    /** the limit of tuples of relations without a limit of their own, or 0 for none */
+    size_t defaultTupleLimit = 0;
+
+    /** the limits of tuples of individual relations */
+    std::map<std::string, size_t> tupleLimits;
+
+    /** the limit of seconds of each stratum, or 0 for none */
+    size_t stratumTimeout = 0;
+
+    /** the index of the current stratum */
+    size_t stratumIndex = 0;
+
+    /** the rules of the current stratum */
+    std::vector<Rule> stratumRules;
+
+    /** the start of the evaluation of the current stratum */
+    std::chrono::steady_clock::time_point stratumStart;
+};
+
+}  // end of namespace souffle
@@ -0,0 +1,209 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved.
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file Snapshot.h
+ *
+ * Layout of the binary images of the state of a program written by
+ * SouffleProgram::snapshot and read by SouffleProgram::restore. All
+ * numbers are stored little-endian.
+ *
+ *   header      magic "SFSN", version, domain size (uint32 each)
+ *   symbols     number of symbols (uint64), followed by each symbol as its
+ *               length (uint64) and characters, in the order of indices
+ *   records     number of record maps (uint64), followed by each map as its
+ *               arity and number of records (uint64 each) and the records
+ *               row by row, in the order of references
+ *   relations   number of relations (uint64), followed by each relation as
+ *               its name, arity and number of tuples (uint64 each) and the
+ *               tuples row by row, in the order of its primary index
+ *
+ * Tuples and records are stored by the indices of their symbols and the
+ * references of their records, which are restored unchanged.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "RamTypes.h"
+#include "StreamBinary.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace souffle {
+
+class Snapshot : public StreamBinary {
+protected:
+    static constexpr const char* SNAPSHOT_MAGIC = "SFSN";
+    static const uint32_t SNAPSHOT_VERSION = 1;
+    static const size_t SNAPSHOT_HEADER_SIZE = 4 + 2 * sizeof(uint32_t);
+
+public:
+    /** Number of tuples transferred at once between relations and images */
+    static const size_t BLOCK_SIZE = 4096;
+};
+
+/**
+ * Writes an image sequentially, encoding numbers into a buffer.
+ */
+class SnapshotWriter : public Snapshot {
+public:
+    explicit SnapshotWriter(const std::string& filename)
+            : filename(filename), file(filename, std::ios::out | std::ios::binary | std::ios::trunc) {
+        if (!file.is_open()) {
+            throw std::invalid_argument("Cannot open snapshot " + filename);
+        }
+        char header[SNAPSHOT_HEADER_SIZE];
+        std::memcpy(header, SNAPSHOT_MAGIC, 4);
+        encode<uint32_t>(header + 4, SNAPSHOT_VERSION);
+        encode<uint32_t>(header + 8, sizeof(RamDomain));
+        file.write(header, SNAPSHOT_HEADER_SIZE);
+    }
+
+    void writeNumber(uint64_t value) {
+        char buffer[sizeof(uint64_t)];
+        encode<uint64_t>(buffer, value);
+        file.write(buffer, sizeof(uint64_t));
+    }
+
+    void writeString(const std::string& str) {
+        writeNumber(str.size());
+        file.write(str.data(), str.size());
+    }
+
+    /** Write the given number of consecutive elements of tuples */
+    void writeDomains(const RamDomain* values, size_t count) {
+        buffer.resize(count * sizeof(RamDomain));
+        for (size_t i = 0; i < count; ++i) {
+            encode<RamDomain>(buffer.data() + i * sizeof(RamDomain), values[i]);
+        }
+        file.write(buffer.data(), buffer.size());
+    }
+
+    /** Flush the image, throwing if it could not be written completely */
+    void close() {
+        file.close();
+        if (file.fail()) {
+            throw std::runtime_error("Cannot write snapshot " + filename);
+        }
+    }
+
+private:
+    std::string filename;
+    std::ofstream file;
+    std::vector<char> buffer;
+};
+
+/**
+ * Reads an image mapped into memory, checking that it is not truncated.
+ */
+class SnapshotReader : public Snapshot {
+public:
+    explicit SnapshotReader(const std::string& filename) : filename(filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        struct stat fileStat;
+        if (fd < 0 || fstat(fd, &fileStat) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            throw std::invalid_argument("Cannot open snapshot " + filename);
+        }
+        size = fileStat.st_size;
+        if (size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::invalid_argument("Cannot map snapshot " + filename);
+            }
+            data = static_cast<const char*>(mapped);
+        }
+        ::close(fd);
+
+        if (size < SNAPSHOT_HEADER_SIZE || std::memcmp(data, SNAPSHOT_MAGIC, 4) != 0) {
+            unmap();
+            throw std::invalid_argument("Invalid header in snapshot " + filename);
+        }
+        if (decode<uint32_t>(data + 4) != SNAPSHOT_VERSION ||
+                decode<uint32_t>(data + 8) != sizeof(RamDomain)) {
+            unmap();
+            throw std::invalid_argument("Unsupported version of snapshot " + filename);
+        }
+        pos = SNAPSHOT_HEADER_SIZE;
+    }
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    ~SnapshotReader() {
+        unmap();
+    }
+
+    uint64_t readNumber() {
+        require(sizeof(uint64_t));
+        uint64_t value = decode<uint64_t>(data + pos);
+        pos += sizeof(uint64_t);
+        return value;
+    }
+
+    std::string readString() {
+        uint64_t length = readNumber();
+        require(length);
+        std::string str(data + pos, length);
+        pos += length;
+        return str;
+    }
+
+    /** Read the given number of consecutive elements of tuples */
+    void readDomains(RamDomain* values, size_t count) {
+        if (count > size) {
+            throw std::invalid_argument("Truncated snapshot " + filename);
+        }
+        require(count * sizeof(RamDomain));
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = decode<RamDomain>(data + pos + i * sizeof(RamDomain));
+        }
+        pos += count * sizeof(RamDomain);
+    }
+
+    /** Report an image that does not belong to the restored program */
+    [[noreturn]] void mismatch(const std::string& what) const {
+        throw std::invalid_argument("Snapshot " + filename + " does not match the program: " + what);
+    }
+
+private:
+    void require(uint64_t bytes) const {
+        if (bytes > size - pos) {
+            throw std::invalid_argument("Truncated snapshot " + filename);
+        }
+    }
+
+    void unmap() {
+        if (data != nullptr) {
+            munmap(const_cast<char*>(data), size);
+            data = nullptr;
+        }
+    }
+
+    std::string filename;
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t pos = 0;
+};
+
+} /* namespace souffle */
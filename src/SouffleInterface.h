@@ -17,11 +17,15 @@
 #pragma once
 
 #include "RamTypes.h"
+#include "RecordTable.h"
+#include "Snapshot.h"
 #include "SymbolTable.h"
 
+#include <algorithm>
 #include <initializer_list>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -109,6 +113,58 @@ public:
     // number of tuples in relation
     virtual std::size_t size() = 0;
 
+    /**
+     * A part of the tuples of a relation, which can be read independently of
+     * the other parts, e.g., by a thread of its own, while the relation is not
+     * modified.
+     */
+    class partition {
+    public:
+        virtual ~partition() = default;
+
+        /**
+         * Copy up to count next tuples row by row into the given buffer of
+         * count * arity elements; returns the number of tuples copied, which
+         * is zero once all tuples of this part are read.
+         */
+        virtual size_t readRows(RamDomain* rows, size_t count) = 0;
+    };
+
+    // -- bulk operations --
+    // tuples are given by their elements, where symbols are given by their
+    // indices in the symbol table (see encodeSymbols)
+
+    // insert count tuples stored row by row in the given buffer; unlike insert,
+    // bulk inserts rebuild the indices of the relation and must not overlap with
+    // any other operation on the relation, including other bulk inserts
+    virtual void insertRows(const RamDomain* rows, size_t count);
+
+    // insert count tuples, where columns[i] holds the count elements of attribute i;
+    // like insertRows, it must not overlap with other operations on the relation
+    virtual void insertColumns(const RamDomain* const* columns, size_t count);
+
+    // copy all tuples row by row into the given buffer of size() * arity elements;
+    // returns the number of tuples copied
+    virtual size_t exportRows(RamDomain* rows) const;
+
+    // copy all tuples into the given columns of size() elements each;
+    // returns the number of tuples copied
+    virtual size_t exportColumns(RamDomain* const* columns) const;
+
+    // split the tuples into about the given number of parts to be read in parallel
+    virtual std::vector<std::unique_ptr<partition>> getPartitions(size_t num) const;
+
+    // insert count tuples of a snapshot stored row by row, which are not considered as
+    // inserted since the last run; like insertRows, it must not overlap with other operations
+    virtual void restoreRows(const RamDomain* rows, size_t count) {
+        insertRows(rows, count);
+    }
+
+    // encode a batch of symbols by their indices in the symbol table, interning new symbols
+    void encodeSymbols(const std::vector<std::string>& symbols, RamDomain* indices) const {
+        getSymbolTable().lookup(symbols.data(), symbols.size(), indices);
+    }
+
     // properties
     virtual bool isOutput() const = 0;
     virtual bool isInput() const = 0;
@@ -230,6 +286,82 @@ public:
     }
 };
 
+/**
+ * A part of a relation read through the iterator of the relation, for
+ * relations without partitions of their own
+ */
+class iterator_partition : public Relation::partition {
+    Relation::iterator it;
+    Relation::iterator end;
+    size_t arity;
+
+public:
+    iterator_partition(const Relation& rel) : it(rel.begin()), end(rel.end()), arity(rel.getArity()) {}
+
+    size_t readRows(RamDomain* rows, size_t count) override {
+        size_t n = 0;
+        for (; n < count && it != end; ++it, ++n) {
+            const tuple& t = *it;
+            for (size_t i = 0; i < arity; i++) {
+                rows[n * arity + i] = t[i];
+            }
+        }
+        return n;
+    }
+};
+
+inline void Relation::insertRows(const RamDomain* rows, size_t count) {
+    const size_t arity = getArity();
+    tuple t(this);
+    for (size_t n = 0; n < count; n++) {
+        for (size_t i = 0; i < arity; i++) {
+            t[i] = rows[n * arity + i];
+        }
+        insert(t);
+    }
+}
+
+inline void Relation::insertColumns(const RamDomain* const* columns, size_t count) {
+    const size_t arity = getArity();
+    tuple t(this);
+    for (size_t n = 0; n < count; n++) {
+        for (size_t i = 0; i < arity; i++) {
+            t[i] = columns[i][n];
+        }
+        insert(t);
+    }
+}
+
+inline size_t Relation::exportRows(RamDomain* rows) const {
+    const size_t arity = getArity();
+    size_t n = 0;
+    for (auto it = begin(), stop = end(); it != stop; ++it, ++n) {
+        const tuple& t = *it;
+        for (size_t i = 0; i < arity; i++) {
+            rows[n * arity + i] = t[i];
+        }
+    }
+    return n;
+}
+
+inline size_t Relation::exportColumns(RamDomain* const* columns) const {
+    const size_t arity = getArity();
+    size_t n = 0;
+    for (auto it = begin(), stop = end(); it != stop; ++it, ++n) {
+        const tuple& t = *it;
+        for (size_t i = 0; i < arity; i++) {
+            columns[i][n] = t[i];
+        }
+    }
+    return n;
+}
+
+inline std::vector<std::unique_ptr<Relation::partition>> Relation::getPartitions(size_t /* num */) const {
+    std::vector<std::unique_ptr<partition>> res;
+    res.push_back(std::make_unique<iterator_partition>(*this));
+    return res;
+}
+
 /**
  * Abstract base class for generated Datalog programs
  */
@@ -266,6 +398,12 @@ public:
     virtual void runAll(std::string inputDirectory = ".", std::string outputDirectory = ".",
             size_t stratumIndex = -1) = 0;
 
+    // propagate the tuples inserted into relations since the last run, keeping all derived tuples;
+    // programs with negation, aggregates or equivalence relations are not compiled for incremental
+    // evaluation (souffle warns about it) and instead re-evaluate all non-input relations from the
+    // input relations, discarding tuples inserted into non-input relations
+    virtual void runIncremental() {}
+
     // load all input relations
     virtual void loadAll(std::string inputDirectory = ".") = 0;
 
@@ -311,6 +449,106 @@ public:
     virtual void executeSubroutine(std::string name, const std::vector<RamDomain>& args,
             std::vector<RamDomain>& ret, std::vector<bool>& retErr) {}
     virtual const SymbolTable& getSymbolTable() const = 0;
+    virtual SymbolTable& getSymbolTable() = 0;
+
+    // write the symbols, records and tuples of all relations into a binary image (see Snapshot.h)
+    void snapshot(const std::string& filename) const {
+        SnapshotWriter out(filename);
+
+        const SymbolTable& symbolTable = getSymbolTable();
+        const size_t numSymbols = symbolTable.size();
+        out.writeNumber(numSymbols);
+        for (size_t i = 0; i < numSymbols; i++) {
+            out.writeString(symbolTable.resolve(i));
+        }
+
+        const auto arities = getRecordArities();
+        out.writeNumber(arities.size());
+        for (size_t arity : arities) {
+            const RecordMap& records = getRecordMap(arity);
+            const size_t numRecords = records.size();
+            out.writeNumber(arity);
+            out.writeNumber(numRecords);
+            for (size_t ref = 1; ref <= numRecords; ref++) {
+                out.writeDomains(records.unpack(ref), arity);
+            }
+        }
+
+        out.writeNumber(relationMap.size());
+        std::vector<RamDomain> block;
+        for (const auto& cur : relationMap) {
+            Relation* rel = cur.second;
+            const size_t arity = rel->getArity();
+            const size_t numTuples = rel->size();
+            out.writeString(cur.first);
+            out.writeNumber(arity);
+            out.writeNumber(numTuples);
+            block.resize(Snapshot::BLOCK_SIZE * arity);
+            size_t numWritten = 0;
+            for (auto& part : rel->getPartitions(1)) {
+                while (size_t num = part->readRows(block.data(), Snapshot::BLOCK_SIZE)) {
+                    out.writeDomains(block.data(), num * arity);
+                    numWritten += num;
+                }
+            }
+            if (numWritten != numTuples) {
+                throw std::runtime_error("Relation " + cur.first + " changed while writing a snapshot");
+            }
+        }
+        out.close();
+    }
+
+    // restore an image written by snapshot; the program must not have been run yet and
+    // symbols and records keep the indices they had in the snapshot
+    void restore(const std::string& filename) {
+        SnapshotReader in(filename);
+
+        // symbols are interned one after another such that they obtain their indices of the
+        // snapshot; the table is shared with all relations of the program
+        const size_t numSymbols = in.readNumber();
+        SymbolTable& symbolTable = getSymbolTable();
+        for (size_t i = 0; i < numSymbols; i++) {
+            const std::string symbol = in.readString();
+            if (i < symbolTable.size() ? symbolTable.resolve(i) != symbol
+                                       : symbolTable.lookup(symbol) != static_cast<RamDomain>(i)) {
+                in.mismatch("symbol " + symbol);
+            }
+        }
+
+        const size_t numMaps = in.readNumber();
+        std::vector<RamDomain> block;
+        for (size_t m = 0; m < numMaps; m++) {
+            const size_t arity = in.readNumber();
+            const size_t numRecords = in.readNumber();
+            RecordMap& records = getRecordMap(arity);
+            block.resize(arity);
+            for (size_t ref = 1; ref <= numRecords; ref++) {
+                in.readDomains(block.data(), arity);
+                if (ref <= records.size() ? !std::equal(block.begin(), block.end(), records.unpack(ref))
+                                          : records.pack(block.data()) != static_cast<RamDomain>(ref)) {
+                    in.mismatch("record of arity " + std::to_string(arity));
+                }
+            }
+        }
+
+        const size_t numRelations = in.readNumber();
+        for (size_t r = 0; r < numRelations; r++) {
+            const std::string name = in.readString();
+            const size_t arity = in.readNumber();
+            size_t numTuples = in.readNumber();
+            Relation* rel = getRelation(name);
+            if (rel == nullptr || rel->getArity() != arity) {
+                in.mismatch("relation " + name);
+            }
+            block.resize(Snapshot::BLOCK_SIZE * arity);
+            while (numTuples > 0) {
+                const size_t num = std::min<size_t>(numTuples, Snapshot::BLOCK_SIZE);
+                in.readDomains(block.data(), num * arity);
+                rel->restoreRows(block.data(), num);
+                numTuples -= num;
+            }
+        }
+    }
 };
 
 /**
@@ -0,0 +1,72 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file StreamBinary.h
+ *
+ * Layout of the binary fact format shared by ReadStreamBinary and
+ * WriteStreamBinary. All numbers are stored little-endian.
+ *
+ *   header      magic "SFBN", version, domain size, arity (uint32 each),
+ *               number of tuples, number of symbols (uint64 each)
+ *   columns     one array of fixed-width values per column
+ *   offsets     (number of symbols + 1) uint64 offsets into the symbol data
+ *   symbols     the concatenated symbols of the file-local dictionary
+ *
+ * Symbol columns hold indices into the file-local dictionary.
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "IODirectives.h"
+#include "RamTypes.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace souffle {
+
+class StreamBinary {
+protected:
+    static constexpr const char* MAGIC = "SFBN";
+    static const uint32_t VERSION = 1;
+    static const size_t HEADER_SIZE = 4 + 3 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+    /** Store a number at the given position in little-endian byte order */
+    template <typename T>
+    static void encode(char* out, T value) {
+        auto bits = static_cast<typename std::make_unsigned<T>::type>(value);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            out[i] = static_cast<char>(bits & 0xff);
+            bits >>= 8;
+        }
+    }
+
+    /** Load a number stored at the given position in little-endian byte order */
+    template <typename T>
+    static T decode(const char* in) {
+        typename std::make_unsigned<T>::type bits = 0;
+        for (size_t i = sizeof(T); i-- > 0;) {
+            bits = (bits << 8) | static_cast<unsigned char>(in[i]);
+        }
+        return static_cast<T>(bits);
+    }
+
+    static std::string getFileName(const IODirectives& ioDirectives) {
+        if (ioDirectives.has("filename")) {
+            return ioDirectives.get("filename");
+        }
+        return ioDirectives.getRelationName() + ".bin";
+    }
+};
+
+} /* namespace souffle */
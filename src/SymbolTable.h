@@ -22,15 +22,17 @@
 
 #ifdef USE_MPI
 #include "Mpi.h"
-#include <thread>
 #endif
 
+#include <atomic>
 #include <cassert>
-#include <deque>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace souffle {
 
@@ -40,6 +42,8 @@ namespace souffle {
  * Global pool of re-usable strings
  *
  * SymbolTable stores Datalog symbols and converts them to numbers and vice versa.
+ * Lookups only lock one of several shards of the table and resolving a number
+ * does not lock at all, so the table may be used by many threads at once.
  */
 class SymbolTable {
 #ifdef USE_MPI
@@ -172,75 +176,216 @@ public:
 #endif
 
 private:
-    /** A lock to synchronize parallel accesses */
+    /** A lock handed out to clients that need exclusive access to the table */
     mutable Lock access;
 
-    /** Map indices to strings. */
-    std::deque<std::string> numToStr;
+    /** Number of strings of the first block of the string arena; each further block doubles in size */
+    static const size_t FIRST_BLOCK_SIZE = 1024;
+
+    /** Maximal number of blocks of the string arena */
+    static const size_t NUM_BLOCKS = 48;
+
+    /** Number of independently locked shards of the map from strings to indices */
+    static const size_t NUM_SHARDS = 64;
+
+    /** Hashes strings referenced by pointer */
+    struct StringPtrHash {
+        size_t operator()(const std::string* symbol) const {
+            return std::hash<std::string>()(*symbol);
+        }
+    };
+
+    /** Compares strings referenced by pointer */
+    struct StringPtrEqual {
+        bool operator()(const std::string* a, const std::string* b) const {
+            return *a == *b;
+        }
+    };
+
+    /** A string of the arena, which may be read once it is marked ready */
+    struct Slot {
+        std::string symbol;
+        std::atomic<bool> ready{false};
+    };
+
+    /** A part of the map from strings to indices, keyed by strings stored in the arena */
+    struct Shard {
+        mutable Lock lock;
+        std::unordered_map<const std::string*, size_t, StringPtrHash, StringPtrEqual> strToNum;
+    };
+
+    /**
+     * Map indices to strings. The arena is a sequence of blocks that are never moved or freed
+     * while the table exists, so resolving an index neither locks nor waits for other threads.
+     */
+    std::atomic<Slot*> numToStr[NUM_BLOCKS];
+
+    /** The number of indices reserved for symbols, including those still being stored */
+    std::atomic<size_t> numReserved;
 
     /** Map strings to indices. */
-    std::unordered_map<std::string, size_t> strToNum;
+    Shard strToNum[NUM_SHARDS];
+
+    /** Compute the block of the string arena holding the given index and the position within it */
+    static inline std::pair<size_t, size_t> getArenaPosition(size_t index) {
+        const size_t scaled = index / FIRST_BLOCK_SIZE + 1;
+        const size_t block = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(scaled);
+        return std::make_pair(block, index - FIRST_BLOCK_SIZE * ((size_t(1) << block) - 1));
+    }
+
+    /** Return the slot of the string arena for the given index, allocating its block if necessary */
+    Slot& getArenaSlot(size_t index) {
+        const auto pos = getArenaPosition(index);
+        Slot* block = numToStr[pos.first].load(std::memory_order_acquire);
+        if (block == nullptr) {
+            auto* fresh = new Slot[FIRST_BLOCK_SIZE << pos.first];
+            if (numToStr[pos.first].compare_exchange_strong(block, fresh, std::memory_order_acq_rel)) {
+                block = fresh;
+            } else {
+                delete[] fresh;
+            }
+        }
+        return block[pos.second];
+    }
+
+    /** Return the string stored in the arena for the given index */
+    inline const std::string& getArenaString(size_t index) const {
+        const auto pos = getArenaPosition(index);
+        return numToStr[pos.first].load(std::memory_order_acquire)[pos.second].symbol;
+    }
+
+    /** Check whether the string for the given index below size() has been stored, as symbols are
+     * created concurrently */
+    inline bool isStored(size_t index) const {
+        const auto pos = getArenaPosition(index);
+        const Slot* block = numToStr[pos.first].load(std::memory_order_acquire);
+        return block != nullptr && block[pos.second].ready.load(std::memory_order_acquire);
+    }
+
+    /** Return the index of the shard of the map from strings to indices responsible for the given symbol */
+    static inline size_t getShardIndex(const std::string& symbol) {
+        return (std::hash<std::string>()(symbol) >> 8) % NUM_SHARDS;
+    }
+
+    inline Shard& getShard(const std::string& symbol) {
+        return strToNum[getShardIndex(symbol)];
+    }
+
+    inline const Shard& getShard(const std::string& symbol) const {
+        return strToNum[getShardIndex(symbol)];
+    }
 
     /** Convenience method to place a new symbol in the table, if it does not exist, and return the index of
      * it. */
     inline size_t newSymbolOfIndex(const std::string& symbol) {
-        size_t index;
-        auto it = strToNum.find(symbol);
-        if (it == strToNum.end()) {
-            index = numToStr.size();
-            strToNum[symbol] = index;
-            numToStr.push_back(symbol);
-        } else {
-            index = it->second;
+        Shard& shard = getShard(symbol);
+        auto lease = shard.lock.acquire();
+        (void)lease;  // avoid warning;
+        return newSymbolInShard(shard, symbol);
+    }
+
+    /** Place a new symbol in the given shard, which must be locked by the caller, if it does not exist,
+     * and return the index of it. */
+    inline size_t newSymbolInShard(Shard& shard, const std::string& symbol) {
+        auto it = shard.strToNum.find(&symbol);
+        if (it != shard.strToNum.end()) {
+            return it->second;
         }
+        const size_t index = numReserved.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = getArenaSlot(index);
+        slot.symbol = symbol;
+
+        // readers skip the slot until it is stored, rather than waiting for symbols created concurrently
+        slot.ready.store(true, std::memory_order_release);
+        shard.strToNum.emplace(&slot.symbol, index);
         return index;
     }
 
     /** Convenience method to place a new symbol in the table, if it does not exist. */
     inline void newSymbol(const std::string& symbol) {
-        if (strToNum.find(symbol) == strToNum.end()) {
-            strToNum[symbol] = numToStr.size();
-            numToStr.push_back(symbol);
+        newSymbolOfIndex(symbol);
+    }
+
+    /** Copy all stored symbols of another table, preserving their indices; the table must be empty. */
+    void copySymbols(const SymbolTable& other) {
+        const size_t n = other.size();
+        for (size_t i = 0; i < n; ++i) {
+            if (!other.isStored(i)) {
+                continue;
+            }
+            Slot& slot = getArenaSlot(i);
+            slot.symbol = other.getArenaString(i);
+            slot.ready.store(true, std::memory_order_relaxed);
+            getShard(slot.symbol).strToNum.emplace(&slot.symbol, i);
+        }
+        numReserved.store(n);
+    }
+
+    /** Swap the contents of two tables; neither may be accessed concurrently. */
+    void swapSymbols(SymbolTable& other) {
+        for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+            Slot* block = numToStr[i].load();
+            numToStr[i].store(other.numToStr[i].load());
+            other.numToStr[i].store(block);
+        }
+        size_t n = numReserved.load();
+        numReserved.store(other.numReserved.load());
+        other.numReserved.store(n);
+        for (size_t i = 0; i < NUM_SHARDS; ++i) {
+            strToNum[i].strToNum.swap(other.strToNum[i].strToNum);
+        }
+    }
+
+    /** Remove all symbols from the table; it may not be accessed concurrently. */
+    void clear() {
+        for (auto& shard : strToNum) {
+            shard.strToNum.clear();
+        }
+        for (auto& block : numToStr) {
+            delete[] block.load();
+            block.store(nullptr);
         }
+        numReserved.store(0);
     }
 
 public:
     /** Empty constructor. */
-    SymbolTable() = default;
+    SymbolTable() : numToStr(), numReserved(0) {}
 
     /** Copy constructor, performs a deep copy. */
-    SymbolTable(const SymbolTable& other) : numToStr(other.numToStr), strToNum(other.strToNum) {}
+    SymbolTable(const SymbolTable& other) : SymbolTable() {
+        copySymbols(other);
+    }
 
     /** Copy constructor for r-value reference. */
-    SymbolTable(SymbolTable&& other) noexcept {
-        numToStr.swap(other.numToStr);
-        strToNum.swap(other.strToNum);
+    SymbolTable(SymbolTable&& other) noexcept : SymbolTable() {
+        swapSymbols(other);
     }
 
-    SymbolTable(std::initializer_list<std::string> symbols) {
-        strToNum.reserve(symbols.size());
+    SymbolTable(std::initializer_list<std::string> symbols) : SymbolTable() {
         for (const auto& symbol : symbols) {
             newSymbol(symbol);
         }
     }
 
     /** Destructor, frees memory allocated for all strings. */
-    virtual ~SymbolTable() = default;
+    virtual ~SymbolTable() {
+        clear();
+    }
 
     /** Assignment operator, performs a deep copy and frees memory allocated for all strings. */
     SymbolTable& operator=(const SymbolTable& other) {
         if (this == &other) {
             return *this;
         }
-        numToStr = other.numToStr;
-        strToNum = other.strToNum;
+        clear();
+        copySymbols(other);
         return *this;
     }
 
     /** Assignment operator for r-value references. */
     SymbolTable& operator=(SymbolTable&& other) noexcept {
-        numToStr.swap(other.numToStr);
-        strToNum.swap(other.strToNum);
+        swapSymbols(other);
         return *this;
     }
 
@@ -252,10 +397,37 @@ public:
             return cacheLookup(symbol, LOOKUP);
         } else
 #endif
-        {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
             return static_cast<RamDomain>(newSymbolOfIndex(symbol));
+    }
+
+    /** Find the indices of a batch of symbols, inserting new symbols in the order of the batch; the shards
+     * of all symbols are locked at once, such that each shard is locked only once for the whole batch. */
+    void lookup(const std::string* symbols, size_t count, RamDomain* indices) {
+#ifdef USE_MPI
+        if (mpi::commRank() != 0) {
+            for (size_t i = 0; i < count; ++i) {
+                indices[i] = cacheLookup(symbols[i], LOOKUP);
+            }
+            return;
+        }
+#endif
+        std::vector<size_t> shardOf(count);
+        std::vector<bool> used(NUM_SHARDS, false);
+        for (size_t i = 0; i < count; ++i) {
+            shardOf[i] = getShardIndex(symbols[i]);
+            used[shardOf[i]] = true;
+        }
+
+        // acquire the locks in the order of the shards, which cannot deadlock with other batches
+        std::vector<Lock::Lease> leases;
+        leases.reserve(NUM_SHARDS);
+        for (size_t shard = 0; shard < NUM_SHARDS; ++shard) {
+            if (used[shard]) {
+                leases.push_back(strToNum[shard].lock.acquire());
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            indices[i] = static_cast<RamDomain>(newSymbolInShard(strToNum[shardOf[i]], symbols[i]));
         }
     }
 
@@ -267,10 +439,11 @@ public:
         } else
 #endif
         {
-            auto lease = access.acquire();
+            const Shard& shard = getShard(symbol);
+            auto lease = shard.lock.acquire();
             (void)lease;  // avoid warning;
-            auto result = strToNum.find(symbol);
-            if (result == strToNum.end()) {
+            auto result = shard.strToNum.find(&symbol);
+            if (result == shard.strToNum.end()) {
                 std::cerr << "Error string not found in call to SymbolTable::lookupExisting.\n";
                 exit(1);
             }
@@ -299,15 +472,13 @@ public:
         } else
 #endif
         {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
             auto pos = static_cast<size_t>(index);
-            if (pos >= size()) {
+            if (pos >= size() || !isStored(pos)) {
                 // TODO: use different error reporting here!!
                 std::cerr << "Error index out of bounds in call to SymbolTable::resolve.\n";
                 exit(1);
             }
-            return numToStr[pos];
+            return getArenaString(pos);
         }
     }
 
@@ -317,10 +488,11 @@ public:
             return cacheResolve(index, UNSAFE_RESOLVE);
         } else
 #endif
-            return numToStr[static_cast<size_t>(index)];
+            return getArenaString(static_cast<size_t>(index));
     }
 
-    /* Return the size of the symbol table, being the number of symbols it currently holds. */
+    /* Return the size of the symbol table, being the number of indices handed out to symbols, including
+     * symbols still being stored by other threads. */
     size_t size() const {
 #ifdef USE_MPI
         if (mpi::commRank() != 0) {
@@ -330,7 +502,7 @@ public:
             return size;
         } else
 #endif
-            return numToStr.size();
+            return numReserved.load(std::memory_order_acquire);
     }
 
     /** Bulk insert symbols into the table, note that this operation is more efficient than repeated
@@ -343,9 +515,6 @@ public:
         } else
 #endif
         {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
-            strToNum.reserve(size() + symbols.size());
             for (auto& symbol : symbols) {
                 newSymbol(symbol);
             }
@@ -361,11 +530,7 @@ public:
             mpi::send(symbol, 0, INSERT_STRING);
         } else
 #endif
-        {
-            auto lease = access.acquire();
-            (void)lease;  // avoid warning;
             newSymbol(symbol);
-        }
     }
 
     /** Print the symbol table to the given stream. */
@@ -377,11 +542,19 @@ public:
 #endif
         {
             out << "SymbolTable: {\n\t";
-            out << join(strToNum, "\n\t",
-                           [](std::ostream& out, const std::pair<std::string, std::size_t>& entry) {
-                               out << entry.first << "\t => " << entry.second;
-                           })
-                << "\n";
+            const size_t n = size();
+            bool first = true;
+            for (size_t i = 0; i < n; ++i) {
+                if (!isStored(i)) {
+                    continue;
+                }
+                if (!first) {
+                    out << "\n\t";
+                }
+                first = false;
+                out << getArenaString(i) << "\t => " << i;
+            }
+            out << "\n";
             out << "}\n";
         }
     }
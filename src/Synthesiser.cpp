@@ -212,7 +212,8 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                 out << "try {";
                 out << "std::map<std::string, std::string> directiveMap(";
                 out << ioDirectives << ");\n";
-                out << R"_(if (!inputDirectory.empty() && directiveMap["IO"] == "file" && )_";
+                out << R"_(if (!inputDirectory.empty() && )_";
+                out << R"_((directiveMap["IO"] == "file" || directiveMap["IO"] == "binary") && )_";
                 out << "directiveMap[\"filename\"].front() != '/') {";
                 out << R"_(directiveMap["filename"] = inputDirectory + "/" + directiveMap["filename"];)_";
                 out << "}\n";
@@ -236,7 +237,8 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             for (IODirectives ioDirectives : store.getIODirectives()) {
                 out << "try {";
                 out << "std::map<std::string, std::string> directiveMap(" << ioDirectives << ");\n";
-                out << R"_(if (!outputDirectory.empty() && directiveMap["IO"] == "file" && )_";
+                out << R"_(if (!outputDirectory.empty() && )_";
+                out << R"_((directiveMap["IO"] == "file" || directiveMap["IO"] == "binary") && )_";
                 out << "directiveMap[\"filename\"].front() != '/') {";
                 out << R"_(directiveMap["filename"] = outputDirectory + "/" + directiveMap["filename"];)_";
                 out << "}\n";
@@ -252,6 +254,14 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             PRINT_END_COMMENT(out);
         }
 
+        /** Emit the check of the limit of tuples of a relation, if it has a limit */
+        void checkSize(const RamRelation& rel, std::ostream& out) {
+            if (synthesiser.limits.getTupleLimit(rel.getName()) > 0) {
+                out << "limits.checkSize(R\"_(" << rel.getName() << ")_\","
+                    << synthesiser.getRelationName(rel) << "->size());\n";
+            }
+        }
+
         void visitInsert(const RamInsert& insert, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
             // enclose operation with a check for an empty relation
@@ -314,6 +324,12 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
                         out << "auto part = range.partition();\n";
                     }
 
+                    // count the search of the outermost loop once
+                    countSelectivity(*scan, "SEARCHES", out);
+                    bool fullScan = scan->getRangeQueryColumns() == 0;
+                    countSelectivity(
+                            *scan, "HITS", out, fullScan ? "!" + relName + "->empty()" : "!range.empty()");
+
                     // build a parallel block around this loop nest
                     out << "PARALLEL_START;\n";
                 }
@@ -338,6 +354,17 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
             out << "}\n";  // end lambda
             // out << "();";  // call lambda
+
+            // check the limit of the computed relation, and the time of rules outside of fixpoint loops,
+            // which compute temporary relations and are checked at each iteration
+            bool checkTime = false;
+            visitDepthFirst(insert, [&](const RamProject& project) {
+                checkSize(project.getRelation(), out);
+                checkTime = checkTime || project.getRelation().getName()[0] != '@';
+            });
+            if (checkTime && synthesiser.limits.isEnabled()) {
+                out << "limits.checkTime();\n";
+            }
             PRINT_END_COMMENT(out);
         }
 
@@ -351,6 +378,10 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             out << synthesiser.getRelationName(merge.getTargetRelation()) << "->"
                 << "insertAll("
                 << "*" << synthesiser.getRelationName(merge.getSourceRelation()) << ");\n";
+            checkSize(merge.getTargetRelation(), out);
+            if (synthesiser.limits.isEnabled()) {
+                out << "limits.checkTime();\n";
+            }
             PRINT_END_COMMENT(out);
         }
 
@@ -441,6 +472,9 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             out << "iter = 0;\n";
             out << "for(;;) {\n";
             visit(loop.getBody(), out);
+            if (synthesiser.limits.isEnabled()) {
+                out << "limits.checkTime();\n";
+            }
             out << "iter++;\n";
             out << "}\n";
             out << "iter = 0;\n";
@@ -505,19 +539,36 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
         // -- operations --
 
+        /** Emit the increment of a selectivity counter of a profiled search, if the guard holds */
+        void countSelectivity(const RamSearch& search, const std::string& counter, std::ostream& out,
+                const std::string& guard = "") {
+            if (!Global::config().has("profile") || !Global::config().has("profile-selectivity") ||
+                    search.getProfileText().empty()) {
+                return;
+            }
+            if (!guard.empty()) {
+                out << "if(" << guard << ") ";
+            }
+            out << "selectivity.count(" << synthesiser.lookupFreqIdx(search.getProfileText())
+                << ",SelectivityCounters::" << counter << ");\n";
+        }
+
         void visitSearch(const RamSearch& search, std::ostream& out) override {
             PRINT_BEGIN_COMMENT(out);
+            countSelectivity(search, "VISITED", out);
             auto condition = search.getCondition();
             if (condition) {
                 out << "if( ";
                 visit(condition, out);
                 out << ") {\n";
+                countSelectivity(search, "PASSED", out);
                 visit(search.getNestedOperation(), out);
                 if (Global::config().has("profile") && !search.getProfileText().empty()) {
                     out << "freqs[" << synthesiser.lookupFreqIdx(search.getProfileText()) << "]++;\n";
                 }
                 out << "}\n";
             } else {
+                countSelectivity(search, "PASSED", out);
                 visit(search.getNestedOperation(), out);
                 if (Global::config().has("profile") && !search.getProfileText().empty()) {
                     out << "freqs[" << synthesiser.lookupFreqIdx(search.getProfileText()) << "]++;\n";
@@ -536,6 +587,11 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
 
             // if this search is a full scan
             if (scan.getRangeQueryColumns() == 0) {
+                // searches of the outermost parallel loop are counted before entering the parallel block
+                if (scan.isPureExistenceCheck() || scan.getLevel() != 0) {
+                    countSelectivity(scan, "SEARCHES", out);
+                    countSelectivity(scan, "HITS", out, "!" + relName + "->empty()");
+                }
                 if (scan.isPureExistenceCheck()) {
                     out << "if(!" << relName << "->"
                         << "empty()) {\n";
@@ -601,6 +657,8 @@ void Synthesiser::emitCode(std::ostream& out, const RamStatement& stmt) {
             out << "}});\n";
             out << "auto range = " << relName << "->"
                 << "equalRange_" << keys << "(key," << ctxName << ");\n";
+            countSelectivity(scan, "SEARCHES", out);
+            countSelectivity(scan, "HITS", out, "!range.empty()");
             if (scan.isPureExistenceCheck()) {
                 out << "if(!range.empty()) {\n";
                 visitSearch(scan, out);
@@ -1335,6 +1393,14 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
 
     std::string classname = "Sf_" + id;
 
+    // resource limits are compiled into the program
+    if (Global::config().has("tuple-limit")) {
+        limits.setTupleLimits(Global::config().get("tuple-limit"));
+    }
+    if (Global::config().has("stratum-timeout")) {
+        limits.setStratumTimeout(Global::config().get("stratum-timeout"));
+    }
+
 #ifdef USE_MPI
     // turn off mpi support if not enabled as the execution engine
     if (Global::config().get("engine") != "mpi") {
@@ -1441,6 +1507,19 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         size_t numFreq = 0;
         visitDepthFirst(*(prog.getMain()), [&](const RamStatement& node) { numFreq++; });
         os << "  size_t freqs[" << numFreq << "]{};\n";
+        if (Global::config().has("profile-selectivity")) {
+            std::set<std::string> profileTexts;
+            visitDepthFirst(prog, [&](const RamSearch& node) {
+                if (!node.getProfileText().empty()) {
+                    profileTexts.insert(node.getProfileText());
+                }
+            });
+            os << "  SelectivityCounters selectivity{" << profileTexts.size() << "};\n";
+        }
+    }
+    if (limits.isEnabled()) {
+        os << "private:\n";
+        os << "  ResourceLimits limits;\n";
     }
 
     // print relation definitions
@@ -1449,6 +1528,20 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     std::string registerRel;   // registration of relations
     int relCtr = 0;
     std::string tempType;  // string to hold the type of the temporary relations
+    // relations of the tuples added between runs, with their types
+    std::map<std::string, std::pair<const RamRelation*, std::string>> incRelations;
+    if (prog.getIncremental()) {
+        // the types of these relations are needed before their declarations
+        visitDepthFirst(*(prog.getMain()), [&](const RamCreate& create) {
+            const auto& rel = create.getRelation();
+            if (rel.isTemp() && rel.getName().find("@inc_") == 0) {
+                auto relationType =
+                        SynthesiserRelation::getSynthesiserRelation(rel, idxAnalysis->getIndexes(rel), false);
+                incRelations[rel.getName()] = std::make_pair(&rel, relationType->getTypeName());
+                generateRelationTypeStruct(os, std::move(relationType));
+            }
+        });
+    }
     visitDepthFirst(*(prog.getMain()), [&](const RamCreate& create) {
         // get some table details
         const auto& rel = create.getRelation();
@@ -1464,7 +1557,7 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         auto relationType = SynthesiserRelation::getSynthesiserRelation(
                 rel, idxAnalysis->getIndexes(rel), Global::config().has("provenance") && !isProvInfo);
         tempType = isDelta ? relationType->getTypeName() : tempType;
-        const std::string& type = (rel.isTemp()) ? tempType : relationType->getTypeName();
+        const std::string& type = (isDelta || isNew) ? tempType : relationType->getTypeName();
 
         // print class definition for the type
         if (!isNew) {
@@ -1480,7 +1573,9 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         }
         initCons += name + "(new " + type + "())";
         deleteForNew += "delete " + name + ";\n";
-        if ((rel.isInput() || rel.isComputed() || Global::config().has("provenance")) && !rel.isTemp()) {
+        // internal relations are kept by provenance and incremental evaluation, and thus part of snapshots
+        const bool keepsInternals = Global::config().has("provenance") || Global::config().has("incremental");
+        if ((rel.isInput() || rel.isComputed() || keepsInternals) && !rel.isTemp()) {
             os << "souffle::RelationWrapper<";
             os << relCtr++ << ",";
             os << type << ",";
@@ -1488,6 +1583,13 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
             os << arity << ",";
             os << (rel.isInput() ? "true" : "false") << ",";
             os << (rel.isComputed() ? "true" : "false");
+            // tuples inserted through the interface are also recorded as added since the last run
+            const auto incRelation = incRelations.find("@inc_" + raw_name);
+            if (incRelation != incRelations.end()) {
+                os << "," << incRelation->second.second;
+                registerRel += "wrapper_" + name + ".setDeltaRelation(" +
+                               getRelationName(*incRelation->second.first) + ");\n";
+            }
             os << "> wrapper_" << name << ";\n";
 
             // construct types
@@ -1551,6 +1653,12 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     if (Global::config().has("verbose")) {
         os << "SignalHandler::instance()->enableLogging();\n";
     }
+    if (Global::config().has("tuple-limit")) {
+        os << "limits.setTupleLimits(R\"_(" << Global::config().get("tuple-limit") << ")_\");\n";
+    }
+    if (Global::config().has("stratum-timeout")) {
+        os << "limits.setStratumTimeout(R\"_(" << Global::config().get("stratum-timeout") << ")_\");\n";
+    }
 
     // initialize counter
     os << "// -- initialize counter --\n";
@@ -1582,18 +1690,26 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
 
         // Record relations created in each stratum
         visitDepthFirst(*(prog.getMain()), [&](const RamStratum& stratum) {
-            std::map<std::string, size_t> relNames;
+            std::map<std::string, const RamRelation*> relations;
             visitDepthFirst(stratum, [&](const RamCreate& create) {
-                relNames[create.getRelation().getName()] = create.getRelation().getArity();
+                relations[create.getRelation().getName()] = &create.getRelation();
             });
-            for (const auto& cur : relNames) {
+            for (const auto& cur : relations) {
                 // Skip temporary relations, marked with '@'
                 if (cur.first[0] == '@') {
                     continue;
                 }
                 os << "ProfileEventSingleton::instance().makeStratumRecord(" << stratum.getIndex()
-                   << R"_(, "relation", ")_" << cur.first << R"_(", "arity", ")_" << cur.second << R"_(");)_"
-                   << '\n';
+                   << R"_(, "relation", ")_" << cur.first << R"_(", "arity", ")_" << cur.second->getArity()
+                   << R"_(");)_" << '\n';
+
+                // Record the data structure chosen from the profile of a previous run
+                const std::string& representation = idxAnalysis->getIndexes(*cur.second).getRepresentation();
+                if (!representation.empty()) {
+                    os << "ProfileEventSingleton::instance().makeStratumRecord(" << stratum.getIndex()
+                       << R"_(, "relation", ")_" << cur.first << R"_(", "representation", ")_"
+                       << representation << R"_(");)_" << '\n';
+                }
             }
         });
     }
@@ -1618,6 +1734,77 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         }
     }
 
+    // strata are run as tasks, each started once the strata preceding it on shared relations are done
+    const bool stratumTasks =
+            !Global::config().has("engine") && !Global::config().has("profile") && !limits.isEnabled();
+    std::map<std::string, size_t> dependencyIndex;  // the dependency token of each relation
+    std::map<const RamStratum*, std::string> stratumDependencies;
+    if (stratumTasks) {
+        // token 0 orders the strata producing output such that their output does not interleave
+        dependencyIndex[""] = 0;
+        visitDepthFirst(*(prog.getMain()), [&](const RamStratum& stratum) {
+            // a stratum modifies the relations it creates or discards, and reads all others
+            std::set<std::string> modified;
+            std::set<std::string> read;
+            visitDepthFirst(stratum,
+                    [&](const RamCreate& create) { modified.insert(create.getRelation().getName()); });
+            visitDepthFirst(
+                    stratum, [&](const RamDrop& drop) { modified.insert(drop.getRelation().getName()); });
+            visitDepthFirst(
+                    stratum, [&](const RamClear& clear) { modified.insert(clear.getRelation().getName()); });
+            auto addRead = [&](const RamRelation& rel) {
+                if (modified.find(rel.getName()) == modified.end()) {
+                    read.insert(rel.getName());
+                }
+            };
+            visitDepthFirst(stratum, addRead);
+            // searches and conditions do not list their relations as child nodes
+            visitDepthFirst(stratum, [&](const RamScan& scan) { addRead(scan.getRelation()); });
+            visitDepthFirst(
+                    stratum, [&](const RamAggregate& aggregate) { addRead(aggregate.getRelation()); });
+            visitDepthFirst(
+                    stratum, [&](const RamNotExists& notExists) { addRead(notExists.getRelation()); });
+            visitDepthFirst(stratum, [&](const RamProvenanceNotExists& notExists) {
+                addRead(notExists.getRelation());
+            });
+            visitDepthFirst(stratum, [&](const RamEmpty& empty) { addRead(empty.getRelation()); });
+            visitDepthFirst(stratum, [&](const RamProject& project) {
+                if (project.hasFilter()) {
+                    addRead(project.getFilter());
+                }
+            });
+            bool hasOutput = false;
+            visitDepthFirst(stratum, [&](const RamStore&) { hasOutput = true; });
+            visitDepthFirst(stratum, [&](const RamPrintSize&) { hasOutput = true; });
+            if (hasOutput) {
+                modified.insert("");
+            }
+
+            // print the depend clauses of the task
+            auto printDependencies = [&](const std::string& type, const std::set<std::string>& names) {
+                if (names.empty()) {
+                    return std::string();
+                }
+                std::vector<std::string> tokens;
+                for (const auto& name : names) {
+                    auto pos = dependencyIndex.insert(std::make_pair(name, dependencyIndex.size())).first;
+                    tokens.push_back("stratumDependencies[" + std::to_string(pos->second) + "]");
+                }
+                return "depend(" + type + ": " + toString(join(tokens, ", ")) + ")";
+            };
+            stratumDependencies[&stratum] =
+                    printDependencies("in", read) + " " + printDependencies("inout", modified);
+        });
+        os << "char stratumDependencies[" << dependencyIndex.size() << "];\n";
+        os << "(void)stratumDependencies;\n";
+        os << "TASKS_START;\n";
+    }
+
+    // abort the evaluation cleanly if a resource limit is exceeded
+    if (limits.isEnabled()) {
+        os << "try {\n";
+    }
+
     // Set up stratum
     visitDepthFirst(*(prog.getMain()), [&](const RamStratum& stratum) {
         os << "/* BEGIN STRATUM " << stratum.getIndex() << " */\n";
@@ -1626,15 +1813,64 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
             auto i = stratum.getIndex();
             os << "STRATUM_" << i << ":\n";
         }
+        if (stratumTasks) {
+            os << "TASK_START(" << stratumDependencies[&stratum] << ");\n";
+        }
         os << "{\n";
+        if (stratumTasks) {
+            // strata evaluated concurrently count their iterations separately
+            os << "std::atomic<size_t> iter(0);\n";
+        }
+        if (limits.isEnabled()) {
+            // start the time limit of the stratum, naming its rules for reporting exceeded limits
+            os << "limits.startStratum(" << stratum.getIndex() << ", {";
+            bool first = true;
+            visitDepthFirst(stratum, [&](const RamDebugInfo& dbg) {
+                visitDepthFirst(dbg, [&](const RamProject& project) {
+                    os << (first ? "" : ",\n") << "{R\"_(" << project.getRelation().getName() << ")_\", R\"_("
+                       << dbg.getMessage() << ")_\"}";
+                    first = false;
+                });
+            });
+            os << "});\n";
+        }
         emitCode(os, stratum.getBody());
         os << "}\n";
+        if (stratumTasks) {
+            os << "TASK_END\n";
+        }
         if (Global::config().has("engine")) {
             os << "if (stratumIndex != (size_t) -1) goto EXIT;\n";
         }
         os << "/* END STRATUM " << stratum.getIndex() << " */\n";
     });
 
+    if (limits.isEnabled()) {
+        os << "} catch (const ResourceLimitExceeded& e) {\n";
+        os << "std::map<std::string, size_t> sizes;\n";
+        os << "for (auto* rel : getAllRelations()) {\n";
+        os << "sizes[rel->getName()] = rel->size();\n";
+        os << "}\n";
+        os << "ResourceLimits::report(e, sizes, std::cerr);\n";
+        if (Global::config().has("partial-output")) {
+            // store the outputs of the aborted stratum; those of earlier strata are stored already
+            os << "switch (limits.getStratumIndex()) {\n";
+            visitDepthFirst(*(prog.getMain()), [&](const RamStratum& stratum) {
+                os << "case " << stratum.getIndex() << ": {\n";
+                visitDepthFirst(stratum, [&](const RamStore& store) { emitCode(os, store); });
+                os << "} break;\n";
+            });
+            os << "}\n";
+        }
+        os << "SignalHandler::instance()->reset();\n";
+        os << "throw;\n";
+        os << "}\n";
+    }
+
+    if (stratumTasks) {
+        os << "TASKS_END\n";
+    }
+
     if (Global::config().has("engine")) {
         os << "EXIT:{}";
     }
@@ -1670,12 +1906,44 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     if (Global::config().has("live-profile")) {
         os << "std::thread profiler([]() { profile::Tui().runProf(); });\n";
     }
-    os << "runFunction<true>(inputDirectory, outputDirectory, stratumIndex);\n";
+    if (Global::config().has("live-profile") && limits.isEnabled()) {
+        // wait for the profiler before passing on an exceeded limit
+        os << "try {\n";
+        os << "runFunction<true>(inputDirectory, outputDirectory, stratumIndex);\n";
+        os << "} catch (const ResourceLimitExceeded&) {\n";
+        os << "profiler.join();\n";
+        os << "throw;\n";
+        os << "}\n";
+    } else {
+        os << "runFunction<true>(inputDirectory, outputDirectory, stratumIndex);\n";
+    }
     if (Global::config().has("live-profile")) {
         os << "if (profiler.joinable()) { profiler.join(); }\n";
     }
     os << "}\n";
 
+    // add method propagating the tuples inserted since the last run
+    os << "public:\nvoid runIncremental() override {\n";
+    if (prog.getIncremental()) {
+        os << "SignalHandler::instance()->set();\n";
+        os << "std::atomic<RamDomain> ctr(0);\n";
+        os << "std::atomic<size_t> iter(0);\n";
+        os << "const bool performIO = false;\n";
+        os << "(void)performIO;\n";
+        emitCode(os, *prog.getIncremental());
+        os << "SignalHandler::instance()->reset();\n";
+    } else {
+        // otherwise all computed relations are re-evaluated from the input relations, which are not
+        // dropped after a run if incremental evaluation was requested
+        visitDepthFirst(*(prog.getMain()), [&](const RamCreate& create) {
+            if (!create.getRelation().isInput()) {
+                os << getRelationName(create.getRelation()) << "->purge();\n";
+            }
+        });
+        os << "runFunction<false>(\".\", \".\", (size_t) -1);\n";
+    }
+    os << "}\n";
+
     // issue printAll method
     os << "public:\n";
     os << "void printAll(std::string outputDirectory = \".\") override {\n";
@@ -1684,7 +1952,8 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
             for (IODirectives ioDirectives : store->getIODirectives()) {
                 os << "try {";
                 os << "std::map<std::string, std::string> directiveMap(" << ioDirectives << ");\n";
-                os << R"_(if (!outputDirectory.empty() && directiveMap["IO"] == "file" && )_";
+                os << R"_(if (!outputDirectory.empty() && )_";
+                os << R"_((directiveMap["IO"] == "file" || directiveMap["IO"] == "binary") && )_";
                 os << "directiveMap[\"filename\"].front() != '/') {";
                 os << R"_(directiveMap["filename"] = outputDirectory + "/" + directiveMap["filename"];)_";
                 os << "}\n";
@@ -1714,6 +1983,9 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         for (auto const& cur : idxMap) {
             os << "\tProfileEventSingleton::instance().makeQuantityEvent(R\"_(" << cur.first << ")_\", freqs["
                << cur.second << "],0);\n";
+            if (Global::config().has("profile-selectivity")) {
+                os << "\tselectivity.dump(" << cur.second << ", R\"_(" << cur.first << ")_\");\n";
+            }
         }
         os << "}\n";  // end of dumpFreqs() method
     }
@@ -1727,7 +1999,8 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
             os << "try {";
             os << "std::map<std::string, std::string> directiveMap(";
             os << ioDirectives << ");\n";
-            os << R"_(if (!inputDirectory.empty() && directiveMap["IO"] == "file" && )_";
+            os << R"_(if (!inputDirectory.empty() && )_";
+            os << R"_((directiveMap["IO"] == "file" || directiveMap["IO"] == "binary") && )_";
             os << "directiveMap[\"filename\"].front() != '/') {";
             os << R"_(directiveMap["filename"] = inputDirectory + "/" + directiveMap["filename"];)_";
             os << "}\n";
@@ -1785,6 +2058,9 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
     os << "const SymbolTable &getSymbolTable() const override {\n";
     os << "return symTable;\n";
     os << "}\n";  // end of getSymbolTable() method
+    os << "SymbolTable &getSymbolTable() override {\n";
+    os << "return symTable;\n";
+    os << "}\n";  // end of getSymbolTable() method
 
     // TODO: generate code for subroutines
     if (Global::config().has("provenance")) {
@@ -1908,6 +2184,11 @@ void Synthesiser::generateCode(const RamTranslationUnit& unit, std::ostream& os,
         os << "explain(obj, true, true);\n";
     }
     os << "return 0;\n";
+    if (limits.isEnabled()) {
+        // exceeded limits are reported by the program
+        os << "} catch (const souffle::ResourceLimitExceeded&) {\n";
+        os << "return 1;\n";
+    }
     os << "} catch(std::exception &e) { souffle::SignalHandler::instance()->error(e.what());}\n";
     os << "}\n";
     os << "\n#endif\n";
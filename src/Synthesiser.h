@@ -19,6 +19,7 @@
 #include "IndexSetAnalysis.h"
 #include "RamStatement.h"
 #include "RamTypes.h"
+#include "ResourceLimits.h"
 #include "SynthesiserRelation.h"
 #include <map>
 #include <ostream>
@@ -45,6 +46,9 @@ private:
     /** Cache for generated types for relations */
     std::set<std::string> typeCache;
 
+    /** Limits of tuples and time checked by the generated program */
+    ResourceLimits limits;
+
 protected:
     /** Convert RAM identifier */
     const std::string convertRamIdent(const std::string& name);
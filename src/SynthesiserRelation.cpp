@@ -32,6 +32,15 @@ std::unique_ptr<SynthesiserRelation> SynthesiserRelation::getSynthesiserRelation
         rel = new SynthesiserRbtsetRelation(ramRel, indexSet, isProvenance);
     } else if (ramRel.isHashset()) {
         rel = new SynthesiserHashsetRelation(ramRel, indexSet, isProvenance);
+    } else if (!indexSet.getRepresentation().empty()) {
+        // Handle the data structure chosen from a profile
+        if (indexSet.getRepresentation() == "hashset") {
+            rel = new SynthesiserHashsetRelation(ramRel, indexSet, isProvenance);
+        } else if (indexSet.getRepresentation() == "brie") {
+            rel = new SynthesiserBrieRelation(ramRel, indexSet, isProvenance);
+        } else {
+            rel = new SynthesiserDirectRelation(ramRel, indexSet, isProvenance);
+        }
     } else {
         // Handle the data structure command line flag
         if (Global::config().has("data-structure")) {
@@ -271,10 +280,66 @@ void SynthesiserDirectRelation::generateTypeStruct(std::ostream& out) {
 
     out << "void insertAll(" << getTypeName() << "& other) {\n";
     for (size_t i = 0; i < numIndexes; i++) {
-        out << "ind_" << i << ".insertAll(other.ind_" << i << ");\n";
+        // merging is exclusive, so nodes removed by earlier erase operations can be freed and
+        // the indices rebuilt from the merged sequences
+        out << "ind_" << i << ".reclaim();\n";
+        out << "ind_" << i << ".mergeAll(other.ind_" << i << ");\n";
     }
     out << "}\n";  // end of insertAll(relationType& other)
 
+    // bulk insertion of tuples read from files, building the indices from sorted sequences;
+    // provenance annotations of equal tuples are updated by the element-wise insertion only
+    if (!isProvenance) {
+        out << "void insertRows(const RamDomain* rows, size_t count) {\n";
+        out << "std::vector<t_tuple> tuples(count);\n";
+        out << "for (size_t n = 0; n < count; n++) {\n";
+        out << "std::copy(rows + n * " << arity << ", rows + (n + 1) * " << arity << ", tuples[n].data);\n";
+        out << "}\n";
+
+        // keep the new tuples only, which are inserted into all indices
+        for (size_t i = 0; i < numIndexes; i++) {
+            out << "index_utils::comparator<" << join(inds[i]) << "> comp_" << i << ";\n";
+        }
+        out << "std::sort(tuples.begin(), tuples.end(), [&](const t_tuple& a, const t_tuple& b) { return "
+               "comp_"
+            << masterIndex << ".less(a, b); });\n";
+        out << "tuples.erase(std::unique(tuples.begin(), tuples.end()), tuples.end());\n";
+        out << "if (!ind_" << masterIndex << ".empty()) {\n";
+        out << "tuples.erase(std::remove_if(tuples.begin(), tuples.end(), [&](const t_tuple& t) { return ind_"
+            << masterIndex << ".contains(t); }), tuples.end());\n";
+        out << "}\n";
+        out << "ind_" << masterIndex << ".reclaim();\n";
+        out << "ind_" << masterIndex << ".insertSorted(tuples.begin(), tuples.end());\n";
+        for (size_t i = 0; i < numIndexes; i++) {
+            if (i != masterIndex) {
+                out << "std::sort(tuples.begin(), tuples.end(), [&](const t_tuple& a, const t_tuple& b) { "
+                       "return comp_"
+                    << i << ".less(a, b); });\n";
+                out << "ind_" << i << ".reclaim();\n";
+                out << "ind_" << i << ".insertSorted(tuples.begin(), tuples.end());\n";
+            }
+        }
+        out << "}\n";  // end of insertRows(const RamDomain* rows, size_t count)
+    }
+
+    // erase methods
+    out << "bool erase(const t_tuple& t, context& h) {\n";
+    out << "if (ind_" << masterIndex << ".erase(t, h.hints_" << masterIndex << ")) {\n";
+    // all indexes cover the full tuple, such that each of them holds exactly the tuple erased
+    for (size_t i = 0; i < numIndexes; i++) {
+        if (i != masterIndex) {
+            out << "ind_" << i << ".erase(t, h.hints_" << i << ");\n";
+        }
+    }
+    out << "return true;\n";
+    out << "} else return false;\n";
+    out << "}\n";  // end of erase(t_tuple&, context&)
+
+    out << "bool erase(const t_tuple& t) {\n";
+    out << "context h;\n";
+    out << "return erase(t, h);\n";
+    out << "}\n";  // end of erase(t_tuple&)
+
     // contains methods
     out << "bool contains(const t_tuple& t, context& h) const {\n";
     out << "return ind_" << masterIndex << ".contains(t, h.hints_" << masterIndex << ");\n";
@@ -1576,7 +1641,7 @@ void SynthesiserHashsetRelation::generateTypeStruct(std::ostream& out) {
 
         // generate a custom tuple hasher based on the index order
         out << "struct tuple_hasher_" << i << " {\n";
-        out << "bool operator()(const t_tuple& a) const {\n";
+        out << "std::size_t operator()(const t_tuple& a) const {\n";
         out << "size_t h = a[" << ind[ind.size() - 1] << "];\n";
         for (int i = ind.size() - 2; i >= 0; i--) {
             out << "h = a[" << ind[i] << "] + 0x9e3779b9 + (h << 6) + (h >> 2);\n";
@@ -1597,33 +1662,32 @@ void SynthesiserHashsetRelation::generateTypeStruct(std::ostream& out) {
         out << "}\n";
         out << "};\n";
 
+        // tuples are grouped by the columns of the index, enabling exact-key range queries
         if (ind.size() == arity) {
-            out << "using t_ind_" << i << " = std::unordered_set<t_tuple, tuple_hasher_" << i
-                << ", tuple_equal_" << i << ">;\n";
+            out << "using t_ind_" << i << " = hash_set<t_tuple, tuple_hasher_" << i << ", tuple_equal_" << i
+                << ">;\n";
         } else {
-            out << "using t_ind_" << i << " = std::unordered_multiset<t_tuple, tuple_hasher_" << i
-                << ", tuple_equal_" << i << ">;\n";
+            out << "using t_ind_" << i << " = hash_multiset<t_tuple, tuple_hasher_" << i << ", tuple_equal_"
+                << i << ">;\n";
         }
         out << "t_ind_" << i << " ind_" << i << ";\n";
     }
 
     // typedef master index iterator to be struct iterator
-    out << "using iterator = t_ind_" << masterIndex << "::const_iterator;\n";
-
-    // create a global mutex lock for inserts
-    out << "std::mutex lock;\n";
+    out << "using iterator = t_ind_" << masterIndex << "::iterator;\n";
 
     // create a struct storing hints for each btree
     out << "struct context {\n";
     out << "};\n";
     out << "context createContext() { return context(); }\n";
 
-    // insert methods
+    // insert methods, the master index admits each tuple only once
     out << "bool insert(const t_tuple& t) {\n";
-    out << "std::lock_guard<std::mutex> guard(lock);\n";
-    out << "if (!contains(t)) {\n";
+    out << "if (ind_" << masterIndex << ".insert(t)) {\n";
     for (size_t i = 0; i < numIndexes; i++) {
-        out << "ind_" << i << ".insert(t);\n";
+        if (i != masterIndex) {
+            out << "ind_" << i << ".insert(t);\n";
+        }
     }
     out << "return true;\n";
     out << "} else return false;\n";
@@ -1660,7 +1724,7 @@ void SynthesiserHashsetRelation::generateTypeStruct(std::ostream& out) {
 
     // contains methods
     out << "bool contains(const t_tuple& t) const {\n";
-    out << "return ind_" << masterIndex << ".find(t) != ind_" << masterIndex << ".end();\n";
+    out << "return ind_" << masterIndex << ".contains(t);\n";
     out << "}\n";
 
     out << "bool contains(const t_tuple& t, context& h) const {\n";
@@ -1691,13 +1755,12 @@ void SynthesiserHashsetRelation::generateTypeStruct(std::ostream& out) {
         auto lexOrder = getIndexSet().getLexOrder(search);
         size_t indNum = indexToNumMap[lexOrder];
 
-        out << "range<t_ind_" << indNum << "::const_iterator> equalRange_" << search;
+        out << "range<t_ind_" << indNum << "::local_iterator> equalRange_" << search;
         out << "(const t_tuple& t) const {\n";
-        out << "auto pair = ind_" << indNum << ".equal_range(t);\n";
-        out << "return make_range(pair.first, pair.second);\n";
+        out << "return ind_" << indNum << ".equal_range(t);\n";
         out << "}\n";
 
-        out << "range<t_ind_" << indNum << "::const_iterator> equalRange_" << search;
+        out << "range<t_ind_" << indNum << "::local_iterator> equalRange_" << search;
         out << "(const t_tuple& t, context& h) const {\n";
         out << "return equalRange_" << search << "(t);\n";
         out << "}\n";
@@ -1710,8 +1773,7 @@ void SynthesiserHashsetRelation::generateTypeStruct(std::ostream& out) {
 
     // partition method for parallelism
     out << "std::vector<range<iterator>> partition() const {\n";
-    out << "range<iterator> full(begin(), end());\n";
-    out << "return full.partition(100);\n";
+    out << "return ind_" << masterIndex << ".partition(400);\n";
     out << "}\n";
 
     // purge method
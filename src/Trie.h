@@ -94,6 +94,12 @@ struct default_merge {
  * B-tree like fashion to inprove cache utilization and reduce the number
  * of steps required for lookup and insert operations.
  *
+ * Since nodes of sparse arrays are often sparsely populated, each node
+ * stores only a few cells in place, tagged with their index, similar to
+ * the smallest nodes of adaptive radix trees. Once those are exhausted, an
+ * array of cells covering all indices of the node is attached. Cells are
+ * never moved, such that concurrent insertions remain lock-free.
+ *
  * @tparam T the type of the stored elements
  * @tparam BITS the number of bits consumed per node-level
  *              e.g. if it is set to 3, the resulting tree will be of a degree of
@@ -115,6 +121,10 @@ class SparseArray {
     static const int BIT_PER_STEP = BITS;
     static const int NUM_CELLS = 1 << BIT_PER_STEP;
     static const key_type INDEX_MASK = NUM_CELLS - 1;
+    static const int NUM_COMPACT_CELLS = 4;
+
+    // compact cells are tagged by their index + 1 in a byte
+    static_assert(NUM_CELLS < 256, "too many cells per node");
 
 public:
     // the type utilized for indexing contained elements
@@ -148,13 +158,25 @@ private:
     };
 
     /**
-     * The node type of the internally maintained tree.
+     * The array of cells of a node covering all of its indices.
+     */
+    struct Cells {
+        Cell cell[NUM_CELLS];
+    };
+
+    /**
+     * The node type of the internally maintained tree. The first cells claimed
+     * are stored in place, all further cells in the full array of cells.
      */
     struct Node {
         // a pointer to the parent node (for efficient iteration)
         const Node* parent;
+        // the array of all cells, allocated once the compact cells are exhausted
+        std::atomic<Cells*> full;
+        // the index + 1 of each compact cell, or 0 if it is unclaimed; cells are claimed in order
+        std::atomic<uint8_t> tags[NUM_COMPACT_CELLS];
         // the pointers to the child nodes (inner nodes) or the stored values (leaf nodes)
-        Cell cell[NUM_CELLS];
+        Cell compact[NUM_COMPACT_CELLS];
     };
 
     /**
@@ -302,12 +324,14 @@ private:
 
         // add size of current node
         std::size_t res = sizeof(Node);
+        if (node->full.load(std::memory_order_relaxed)) {
+            res += sizeof(Cells);
+        }
 
         // sum up memory usage of child nodes
         if (level > 0) {
-            for (int i = 0; i < NUM_CELLS; i++) {
-                res += getMemoryUsage(node->cell[i].ptr, level - 1);
-            }
+            forEachCell(node,
+                    [&](index_type, const Cell& cell) { res += getMemoryUsage(cell.ptr, level - 1); });
         }
 
         // done
@@ -558,7 +582,7 @@ private:
         // check context
         if (ctxt.lastNode && (ctxt.lastIndex == (i & ~INDEX_MASK))) {
             // return reference to referenced
-            return ctxt.lastNode->cell[i & INDEX_MASK];
+            return getCell(ctxt.lastNode, i & INDEX_MASK);
         }
 
         // get snapshot of root
@@ -589,7 +613,7 @@ private:
                 }
 
                 // return reference to proper cell
-                return info.root->cell[i & INDEX_MASK];
+                return getCell(info.root, i & INDEX_MASK);
             }
 
             // somebody else was faster => use standard insertion procedure
@@ -626,7 +650,7 @@ private:
             --level;
 
             // check next node
-            std::atomic<Node*>& aNext = node->cell[x].aptr;
+            std::atomic<Node*>& aNext = getCell(node, x).aptr;
             Node* next = aNext;
             if (!next) {
                 // create new sub-tree
@@ -675,7 +699,7 @@ private:
         ctxt.lastNode = node;
 
         // return reference to cell
-        return node->cell[i & INDEX_MASK];
+        return getCell(node, i & INDEX_MASK);
     }
 
 public:
@@ -729,7 +753,7 @@ public:
 
         // check context
         if (ctxt.lastNode && ctxt.lastIndex == (i & ~INDEX_MASK)) {
-            return ctxt.lastNode->cell[i & INDEX_MASK].value;
+            return getValue(ctxt.lastNode, i & INDEX_MASK);
         }
 
         // navigate to value
@@ -743,7 +767,7 @@ public:
             --level;
 
             // check next node
-            Node* next = node->cell[x].ptr;
+            Node* next = getChild(node, x);
 
             // check next step
             if (!next) return detail::default_factory<value_type>()();
@@ -757,7 +781,7 @@ public:
         ctxt.lastNode = node;
 
         // return reference to cell
-        return node->cell[i & INDEX_MASK].value;
+        return getValue(node, i & INDEX_MASK);
     }
 
 private:
@@ -782,19 +806,24 @@ private:
 
         // otherwise merge recursively
 
-        // the leaf-node step
+        // the leaf-node step -- merging with a default value retains the other value
         if (levels == 0) {
             merge_op merg;
-            for (int i = 0; i < NUM_CELLS; ++i) {
-                trg->cell[i].value = merg(trg->cell[i].value, src->cell[i].value);
-            }
+            forEachCell(src, [&](index_type x, const Cell& cell) {
+                if (cell.value != value_type()) {
+                    Cell& cur = getCell(trg, x);
+                    cur.value = merg(cur.value, cell.value);
+                }
+            });
             return;
         }
 
         // the recursive step
-        for (int i = 0; i < NUM_CELLS; ++i) {
-            merge(trg, trg->cell[i].ptr, src->cell[i].ptr, levels - 1);
-        }
+        forEachCell(src, [&](index_type x, const Cell& cell) {
+            if (cell.ptr) {
+                merge(trg, getCell(trg, x).ptr, cell.ptr, levels - 1);
+            }
+        });
     }
 
 public:
@@ -830,7 +859,7 @@ public:
             --level;
 
             // check next node
-            Node*& next = (*node)->cell[x].ptr;
+            Node*& next = getCell(*node, x).ptr;
             if (!next) {
                 // create new sub-tree
                 next = newNode();
@@ -878,10 +907,10 @@ public:
             if (!first) return;
 
             // load the value
-            if (first->cell[0].value == value_type()) {
+            if (getValue(first, 0) == value_type()) {
                 ++(*this);  // walk to first element
             } else {
-                value.second = first->cell[0].value;
+                value.second = getValue(first, 0);
             }
         }
 
@@ -919,15 +948,14 @@ public:
             index_type x = value.first & INDEX_MASK;
 
             // go to next non-empty value in current node
-            do {
-                x++;
-            } while (x < NUM_CELLS && node->cell[x].value == value_type());
+            x++;
+            const Cell* cell = nextCell(node, x, true);
 
             // check whether one has been found
-            if (x < NUM_CELLS) {
+            if (cell) {
                 // update value and be done
                 value.first = (value.first & ~INDEX_MASK) | x;
-                value.second = node->cell[x].value;
+                value.second = cell->value;
                 return *this;  // done
             }
 
@@ -941,15 +969,12 @@ public:
 
             while (level > 0 && node) {
                 // search for next child
-                while (x < NUM_CELLS) {
-                    if (node->cell[x].ptr) break;
-                    x++;
-                }
+                cell = nextCell(node, x, false);
 
                 // pick next step
-                if (x < NUM_CELLS) {
+                if (cell) {
                     // going down
-                    node = node->cell[x].ptr;
+                    node = cell->ptr;
                     value.first &= getLevelMask(level + 1);
                     value.first |= x << (BIT_PER_STEP * level);
                     level--;
@@ -970,13 +995,12 @@ public:
 
             // search the first value in this node
             x = 0;
-            while (node->cell[x].value == value_type()) {
-                x++;
-            }
+            cell = nextCell(node, x, true);
+            assert(cell && "No value in leaf node!");
 
             // update value
             value.first |= x;
-            value.second = node->cell[x].value;
+            value.second = cell->value;
 
             // done
             return *this;
@@ -1041,7 +1065,7 @@ public:
             Node* node = ctxt.lastNode;
 
             // check whether there is a proper entry
-            value_type value = node->cell[i & INDEX_MASK].value;
+            value_type value = getValue(node, i & INDEX_MASK);
             if (value == 0) {
                 return end();
             }
@@ -1060,7 +1084,7 @@ public:
             --level;
 
             // check next node
-            Node* next = node->cell[x].ptr;
+            Node* next = getChild(node, x);
 
             // check next step
             if (!next) return end();
@@ -1074,7 +1098,7 @@ public:
         ctxt.lastIndex = (i & ~INDEX_MASK);
 
         // check whether there is a proper entry
-        value_type value = node->cell[i & INDEX_MASK].value;
+        value_type value = getValue(node, i & INDEX_MASK);
         if (value == 0) {
             return end();
         }
@@ -1111,7 +1135,7 @@ public:
             auto x = getIndex(i, level);
 
             // check next node
-            Node* next = node->cell[x].ptr;
+            Node* next = getChild(node, x);
 
             // check next step
             if (!next) {
@@ -1130,7 +1154,7 @@ public:
             } else {
                 if (level == 0) {
                     // found boundary
-                    return iterator(node, std::make_pair(i, node->cell[x].value));
+                    return iterator(node, std::make_pair(i, getValue(node, x)));
                 }
 
                 // decrease level counter
@@ -1156,15 +1180,15 @@ private:
 
         if (level == 0) {
             for (int i = 0; i < NUM_CELLS; i++) {
-                if (detailed || node.cell[i].value != value_type()) {
-                    out << times("\t", indent + 1) << i << ": [" << (offset + i) << "] " << node.cell[i].value
+                if (detailed || getValue(&node, i) != value_type()) {
+                    out << times("\t", indent + 1) << i << ": [" << (offset + i) << "] " << getValue(&node, i)
                         << "\n";
                 }
             }
         } else {
             for (int i = 0; i < NUM_CELLS; i++) {
-                if (node.cell[i].ptr) {
-                    dump(detailed, out, *node.cell[i].ptr, level - 1,
+                if (getChild(&node, i)) {
+                    dump(detailed, out, *getChild(&node, i), level - 1,
                             offset + (i * (index_type(1) << (level * BIT_PER_STEP))), indent + 1);
                 } else if (detailed) {
                     auto low = offset + (i * (1 << (level * BIT_PER_STEP)));
@@ -1202,20 +1226,130 @@ private:
      */
     static Node* newNode() {
         auto* res = (Node*)(malloc(sizeof(Node)));
-        std::memset(res->cell, 0, sizeof(Cell) * NUM_CELLS);
+        std::memset(static_cast<void*>(res), 0, sizeof(Node));
+        return res;
+    }
+
+    /**
+     * Obtains the cell of the given index within a node, claiming a compact cell or
+     * allocating the full array of cells if necessary. Claiming cells is lock-free.
+     */
+    static Cell& getCell(Node* node, index_type x) {
+        const auto tag = static_cast<uint8_t>(x + 1);
+        for (int j = 0; j < NUM_COMPACT_CELLS; ++j) {
+            uint8_t cur = node->tags[j].load(std::memory_order_acquire);
+            if (cur == 0 && node->tags[j].compare_exchange_strong(cur, tag)) {
+                return node->compact[j];
+            }
+            // either this cell was claimed before or concurrently
+            if (cur == tag) {
+                return node->compact[j];
+            }
+        }
+
+        // all compact cells are taken by other indices
+        Cells* full = node->full.load(std::memory_order_acquire);
+        if (!full) {
+            auto* fresh = (Cells*)(malloc(sizeof(Cells)));
+            std::memset(static_cast<void*>(fresh), 0, sizeof(Cells));
+            if (node->full.compare_exchange_strong(full, fresh)) {
+                full = fresh;
+            } else {
+                // some other thread was faster => use its cells
+                free(fresh);
+            }
+        }
+        return full->cell[x];
+    }
+
+    /**
+     * Obtains the cell of the given index within a node, or null if it has not been claimed.
+     */
+    static const Cell* findCell(const Node* node, index_type x) {
+        const auto tag = static_cast<uint8_t>(x + 1);
+        for (int j = 0; j < NUM_COMPACT_CELLS; ++j) {
+            uint8_t cur = node->tags[j].load(std::memory_order_acquire);
+            if (cur == tag) return &node->compact[j];
+            // later compact cells and the full cells are not used yet
+            if (cur == 0) return nullptr;
+        }
+        const Cells* full = node->full.load(std::memory_order_acquire);
+        return (full) ? &full->cell[x] : nullptr;
+    }
+
+    /**
+     * Obtains the value stored at the given index of a leaf node.
+     */
+    static value_type getValue(const Node* node, index_type x) {
+        const Cell* cell = findCell(node, x);
+        return (cell) ? cell->value : detail::default_factory<value_type>()();
+    }
+
+    /**
+     * Obtains the child at the given index of an inner node, or null.
+     */
+    static Node* getChild(const Node* node, index_type x) {
+        const Cell* cell = findCell(node, x);
+        return (cell) ? cell->ptr : nullptr;
+    }
+
+    /**
+     * Obtains the first cell of a node at an index >= x holding a non-default value (leaf
+     * nodes) or a child (inner nodes) and updates x to its index; null if there is none.
+     */
+    static const Cell* nextCell(const Node* node, index_type& x, bool leaf) {
+        const Cell* res = nullptr;
+        index_type pos = NUM_CELLS;
+        for (int j = 0; j < NUM_COMPACT_CELLS; ++j) {
+            index_type cur = node->tags[j].load(std::memory_order_acquire);
+            if (cur == 0) break;
+            const Cell& cell = node->compact[j];
+            if (x < cur && cur - 1 < pos && (leaf ? cell.value != value_type() : cell.ptr != nullptr)) {
+                pos = cur - 1;
+                res = &cell;
+            }
+        }
+        if (const Cells* full = node->full.load(std::memory_order_acquire)) {
+            for (index_type i = x; i < pos; ++i) {
+                const Cell& cell = full->cell[i];
+                if (leaf ? cell.value != value_type() : cell.ptr != nullptr) {
+                    pos = i;
+                    res = &cell;
+                    break;
+                }
+            }
+        }
+        x = pos;
         return res;
     }
 
+    /**
+     * Applies the given operation to the index and the cell of each claimed cell of a
+     * node, where cells of the full array are visited regardless of their content.
+     */
+    template <typename Op>
+    static void forEachCell(const Node* node, const Op& op) {
+        for (int j = 0; j < NUM_COMPACT_CELLS; ++j) {
+            index_type cur = node->tags[j].load(std::memory_order_relaxed);
+            if (cur == 0) break;
+            op(cur - 1, node->compact[j]);
+        }
+        if (const Cells* full = node->full.load(std::memory_order_relaxed)) {
+            for (index_type i = 0; i < NUM_CELLS; ++i) {
+                op(i, full->cell[i]);
+            }
+        }
+    }
+
     /**
      * Destroys a node and all its sub-nodes recursively.
      */
     static void freeNodes(Node* node, int level) {
         if (!node) return;
         if (level != 0) {
-            for (int i = 0; i < NUM_CELLS; i++) {
-                freeNodes(node->cell[i].ptr, level - 1);
-            }
+            forEachCell(node, [&](index_type, const Cell& cell) { freeNodes(cell.ptr, level - 1); });
         }
+        free(node->full.load(std::memory_order_relaxed));
         free(node);
     }
 
@@ -1236,23 +1370,27 @@ private:
         if (!node) return nullptr;
 
         // create a clone
-        auto* res = (Node*)(malloc(sizeof(Node)));
+        Node* res = newNode();
 
-        // handle leaf level
+        // handle leaf level -- default values need no cells
         if (level == 0) {
             copy_op copy;
-            for (int i = 0; i < NUM_CELLS; i++) {
-                res->cell[i].value = copy(node->cell[i].value);
-            }
+            forEachCell(node, [&](index_type x, const Cell& cell) {
+                if (cell.value != value_type()) {
+                    getCell(res, x).value = copy(cell.value);
+                }
+            });
             return res;
         }
 
         // for inner nodes clone each child
-        for (int i = 0; i < NUM_CELLS; i++) {
-            auto cur = clone(node->cell[i].ptr, level - 1);
-            if (cur) cur->parent = res;
-            res->cell[i].ptr = cur;
-        }
+        forEachCell(node, [&](index_type x, const Cell& cell) {
+            if (cell.ptr) {
+                auto cur = clone(cell.ptr, level - 1);
+                cur->parent = res;
+                getCell(res, x).ptr = cur;
+            }
+        });
 
         // done
         return res;
@@ -1264,17 +1402,11 @@ private:
      */
     static Node* findFirst(Node* node, int level) {
         while (level > 0) {
-            bool found = false;
-            for (int i = 0; i < NUM_CELLS; i++) {
-                Node* cur = node->cell[i].ptr;
-                if (cur) {
-                    node = cur;
-                    --level;
-                    found = true;
-                    break;
-                }
-            }
-            assert(found && "No first node!");
+            index_type x = 0;
+            const Cell* cell = nextCell(node, x, false);
+            assert(cell && "No first node!");
+            node = cell->ptr;
+            --level;
         }
 
         return node;
@@ -1294,7 +1426,7 @@ private:
 
         // insert existing root as child
         auto x = getIndex(unsynced.offset, unsynced.levels + 1);
-        node->cell[x].ptr = unsynced.root;
+        getCell(node, x).ptr = unsynced.root;
 
         // swap the root
         unsynced.root->parent = node;
@@ -1321,7 +1453,7 @@ private:
 
         // insert existing root as child
         auto x = getIndex(info.offset, info.levels + 1);
-        newRoot->cell[x].ptr = info.root;
+        getCell(newRoot, x).ptr = info.root;
 
         // exchange the root in the info struct
         auto oldRoot = info.root;
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "BlockList.h"
+#include "ParallelUtils.h"
 #include "Util.h"
 
 #include <atomic>
@@ -26,6 +27,7 @@
 #include <list>
 #include <mutex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace souffle {
@@ -37,15 +39,23 @@ using parent_t = uint32_t;
 constexpr uint8_t split_size = 32u;
 constexpr block_t rank_mask = (1ul << split_size) - 1;
 
+// the number of pairs of a batch of unions, from which on the batch is processed in parallel
+constexpr size_t parallel_union_batch = 1024;
+
 /**
  * Structure that emulates a Disjoint Set, i.e. a data structure that supports efficient union-find operations
+ * Nodes are united by rank and finds halve the paths to the representatives; finds never wait for other
+ * threads, and nodes can be created and united concurrently.
  */
 class DisjointSet {
     /* store blocks of atomics */
-    BlockList<std::atomic<block_t>> a_blocks;
+    BlockArena<std::atomic<block_t>> a_blocks;
+
+    /* whether the node at a position has been stored; set once the node is created */
+    BlockArena<std::atomic<bool>> a_ready;
 
-    // read/write mutex for inserting new nodes
-    mutable souffle::shared_mutex nodeLock;
+    /* the number of positions in the arena handed out to nodes, including those still being created */
+    std::atomic<size_t> numReserved;
 
     /* whether the generated iterator needs to be updated */
     std::atomic<bool> isStale;
@@ -56,13 +66,20 @@ class DisjointSet {
     std::unordered_map<parent_t, BlockList<parent_t>> repToSubords;
 
 public:
-    DisjointSet() : isStale(true), mapStale(true){};
+    DisjointSet() : numReserved(0), isStale(true), mapStale(true){};
 
     // Not a thread safe operation
     DisjointSet& operator=(const DisjointSet& old) {
         if (this == &old) return *this;
 
-        a_blocks = old.a_blocks;
+        a_blocks.clear();
+        a_ready.clear();
+        const size_t sz = old.size();
+        for (size_t i = 0; i < sz; ++i) {
+            a_blocks.create(i).store(old.get(i).load());
+            a_ready.create(i).store(true);
+        }
+        numReserved.store(sz);
         repToSubords = old.repToSubords;
         isStale.store(old.isStale.load());
         mapStale.store(old.mapStale.load());
@@ -71,10 +88,19 @@ public:
     }
 
     inline size_t size() const {
-        auto sz = a_blocks.size();
-        return sz;
+        return numReserved.load();
     };
 
+    /**
+     * Check whether the node at a position below size() has been stored, as nodes are
+     * created concurrently
+     * @param node the node index
+     * @return whether the node may be read
+     */
+    inline bool isReady(parent_t node) const {
+        return a_ready.isAllocated(node) && a_ready.get(node).load(std::memory_order_acquire);
+    }
+
     inline bool staleList() const {
         return isStale;
     };
@@ -96,29 +122,32 @@ public:
 
     /**
      * Equivalent to the find() function in union/find
-     * Find the highest ancestor of the provided node - flattening as we go
+     * Find the highest ancestor of the provided node - halving the path as we go, i.e. every node on the
+     * path is pointed to its grandparent. A failed update is not retried, as another thread has updated
+     * the node already.
      * @param x the node to find the parent of, whilst flattening its set-tree
      * @return The parent of x
      */
     parent_t findNode(parent_t x, bool isStrong = true) {
-        // If x is its own parent return immediately
-        if (x == b2p(get(x))) {
-            return x;
-        }
+        while (true) {
+            block_t xState = get(x);
+            parent_t parent = b2p(xState);
+            // If x is its own parent return immediately
+            if (x == parent) return x;
 
-        isStale.store(true);
-        mapStale.store(true);
+            parent_t grandParent = b2p(get(parent));
+            if (parent == grandParent) return parent;
 
-        block_t xState = get(x);
-        parent_t newParent = findNode(b2p(xState));
-        block_t newState = pr2b(newParent, b2r(xState));
+            markStale();
 
-        if (isStrong)
-            this->get(x).compare_exchange_strong(xState, newState);
-        else
-            this->get(x).compare_exchange_weak(xState, newState);
+            block_t newState = pr2b(grandParent, b2r(xState));
+            if (isStrong)
+                this->get(x).compare_exchange_strong(xState, newState);
+            else
+                this->get(x).compare_exchange_weak(xState, newState);
 
-        return newParent;
+            x = grandParent;
+        }
     }
 
     /**
@@ -128,13 +157,24 @@ public:
      * @return the representative that is found
      */
     parent_t readOnlyFindNode(parent_t x) const {
-        block_t ii = get(x);
-        parent_t p = b2p(ii);
-        if (x == p) return x;
-        return readOnlyFindNode(p);
+        parent_t p = b2p(get(x));
+        while (x != p) {
+            x = p;
+            p = b2p(get(x));
+        }
+        return x;
     }
 
 private:
+    /**
+     * Mark the iterators and the map of representatives as stale
+     * The flags are only written if necessary, as finds of all threads may mark them
+     */
+    inline void markStale() {
+        if (!isStale.load(std::memory_order_relaxed)) isStale.store(true);
+        if (!mapStale.load(std::memory_order_relaxed)) mapStale.store(true);
+    }
+
     /**
      * Update the root of the tree of which x is, to have y as the base instead
      * @param x : old root
@@ -146,8 +186,7 @@ private:
      */
     bool updateRoot(
             const parent_t x, const rank_t oldrank, const parent_t y, const rank_t newrank, bool isStrong) {
-        isStale.store(true);
-        mapStale.store(true);
+        markStale();
 
         block_t oldState = get(x);
         parent_t nextN = b2p(oldState);
@@ -283,15 +322,13 @@ public:
     void clear() {
         // Warning! Not threadsafe..
 
-        nodeLock.lock();
-
         isStale = true;
         mapStale = true;
 
         repToSubords.clear();
         a_blocks.clear();
-
-        nodeLock.unlock();
+        a_ready.clear();
+        numReserved.store(0);
     }
 
     /**
@@ -323,8 +360,7 @@ public:
             // no need to union if both already in same set
             if (x == y) return;
 
-            isStale.store(true);
-            mapStale.store(true);
+            markStale();
 
             rank_t xrank = b2r(get(x));
             rank_t yrank = b2r(get(y));
@@ -342,14 +378,30 @@ public:
         }
     }
 
+    /**
+     * Union the pairs of nodes of a batch, which is processed in parallel if it is large enough
+     * @param pairs the pairs of nodes to be unioned
+     */
+    void unionAll(const std::vector<std::pair<parent_t, parent_t>>& pairs) {
+#pragma omp parallel for schedule(static) num_threads(getTaskThreads()) \
+        if (pairs.size() >= parallel_union_batch)
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            unionNodes(pairs[i].first, pairs[i].second);
+        }
+    }
+
     /**
      * Performs a find operation on every node s.t. all nodes have a direct ref to their set's representative
      * This is only performed if necessary.
      */
     void findAll() {
         if (isStale) {
-            // TODO: check whether we should use strong=false/true in findNode args
-            for (parent_t i = 0; i < size(); ++i) findNode(i);
+            // point every node directly to its representative, as finds only halve the paths
+            for (parent_t i = 0; i < size(); ++i) {
+                if (!isReady(i)) continue;
+                block_t state = get(i);
+                get(i).store(pr2b(readOnlyFindNode(i), b2r(state)));
+            }
 
             isStale.store(false);
         }
@@ -360,23 +412,24 @@ public:
      * @return the newly created block
      */
     inline block_t makeNode() {
-        nodeLock.lock();
-
-        isStale.store(true);
-        mapStale.store(true);
-
-        // its parent is itself (size indicates the position in the listData structure)
-        auto xpar = (parent_t)a_blocks.size();
+        // its parent is itself; reserve the next position in the arena, unless it cannot be stored
+        size_t pos = numReserved.load();
+        do {
+            if (pos > std::numeric_limits<parent_t>::max()) {
+                throw std::runtime_error("out of bounds dense value");
+            }
+        } while (!numReserved.compare_exchange_weak(pos, pos + 1));
+        auto xpar = static_cast<parent_t>(pos);
         rank_t xrank = 0;
 
         block_t x = pr2b(xpar, xrank);
 
-        a_blocks.add(x);
+        a_blocks.create(xpar).store(x);
 
-        isStale.store(true);
-        mapStale.store(true);
+        // readers skip the node until it is stored, rather than waiting for nodes created concurrently
+        a_ready.create(xpar).store(true, std::memory_order_release);
 
-        nodeLock.unlock();
+        markStale();
 
         return x;
     };
@@ -401,6 +454,7 @@ public:
             repToSubords.clear();
 
             for (parent_t i = 0; i < size(); ++i) {
+                if (!isReady(i)) continue;
                 repToSubords[b2p(this->get(i))].add(i);
             }
 
@@ -450,59 +504,53 @@ public:
 
 template <typename SparseDomain>
 class SparseDisjointSet {
-    // lock on write operations - STL containers only support 1 writer at all times
-    // mutable std::mutex modLock;
-    // read/write lock on sparseToDenseMap & denseToSparseMap
-    mutable souffle::shared_mutex mapsLock;
+    // number of independently locked shards of the mapping from sparse to dense values
+    static constexpr size_t NUM_SHARDS = 64;
+
+    // a part of the mapping from sparse to dense values
+    struct Shard {
+        std::mutex lock;
+        std::unordered_map<SparseDomain, parent_t> sparseToDenseMap;
+    };
 
     DisjointSet ds;
 
-    // values stored in here to those in the dense disjoint set
-    std::unordered_map<SparseDomain, parent_t> sparseToDenseMap;
-    std::vector<SparseDomain> denseToSparseMap;
+    // values stored in here to those in the dense disjoint set, each shard locked on its own
+    mutable Shard shards[NUM_SHARDS];
+    // values stored in the dense disjoint set to those in here, read without locking
+    BlockArena<SparseDomain> denseToSparseMap;
 
 private:
+    /**
+     * Retrieve the shard of the mapping responsible for the given sparse value
+     * @param in the sparse value
+     * @return the shard containing the value, if it exists
+     */
+    inline Shard& getShard(const SparseDomain in) const {
+        return shards[std::hash<SparseDomain>()(in) % NUM_SHARDS];
+    }
+
     /**
      * Retrieve dense encoding, adding it in if non-existent
      * @param in the sparse value
      * @return the corresponding dense value
      */
     parent_t toDense(const SparseDomain in) {
-        mapsLock.lock_shared();
-        auto it = sparseToDenseMap.find(in);
+        Shard& shard = getShard(in);
+        std::lock_guard<std::mutex> guard(shard.lock);
 
         // use the pre-existing value
-        if (it != sparseToDenseMap.end()) {
-            auto ret = it->second;
-            mapsLock.unlock_shared();
-            return ret;
-        }
-        mapsLock.unlock_shared();
-
-        // create node in conversion
-        mapsLock.lock();
-
-        it = sparseToDenseMap.find(in);
-        // use the pre-existing value (as perhaps, it may have been written twice)
-        if (it != sparseToDenseMap.end()) {
-            auto ret = it->second;
-            mapsLock.unlock();
-            return ret;
+        auto it = shard.sparseToDenseMap.find(in);
+        if (it != shard.sparseToDenseMap.end()) {
+            return it->second;
         }
 
-        size_t j = denseToSparseMap.size();
-        // check if we create a dense value outside of the bounds that can be stored
-        if (j > std::numeric_limits<parent_t>::max()) throw std::runtime_error("out of bounds dense value");
-        auto jClipped = static_cast<parent_t>(j);
-
         // we create the node
-        ds.makeNode();
-        denseToSparseMap.push_back(in);
-        sparseToDenseMap[in] = jClipped;
-
-        mapsLock.unlock();
+        parent_t j = DisjointSet::b2p(ds.makeNode());
+        denseToSparseMap.create(j) = in;
+        shard.sparseToDenseMap.emplace(in, j);
 
-        return jClipped;
+        return j;
     }
 
 public:
@@ -511,8 +559,13 @@ public:
         if (&old == this) return *this;
 
         ds = old.ds;
-        sparseToDenseMap = old.sparseToDenseMap;
-        denseToSparseMap = old.denseToSparseMap;
+        for (size_t i = 0; i < NUM_SHARDS; ++i) {
+            shards[i].sparseToDenseMap = old.shards[i].sparseToDenseMap;
+        }
+        denseToSparseMap.clear();
+        for (size_t i = 0; i < old.ds.size(); ++i) {
+            denseToSparseMap.create(i) = old.denseToSparseMap.get(i);
+        }
 
         return *this;
     }
@@ -593,11 +646,7 @@ public:
      * @return the sparse value from the denseToSparseMap
      */
     inline const SparseDomain toSparse(const parent_t in) const {
-        mapsLock.lock_shared();
-        auto ret = denseToSparseMap.at(in);
-        mapsLock.unlock_shared();
-
-        return ret;
+        return denseToSparseMap.get(in);
     };
 
     /* a wrapper to enable checking in the sparse set - however also adds them if not already existing */
@@ -617,6 +666,21 @@ public:
         ds.unionNodes(toDense(x), toDense(y));
     };
 
+    /**
+     * Union the pairs of nodes of a batch, adding them if not existing
+     * Large batches are encoded and unioned in parallel
+     * @param pairs the pairs of nodes to be unioned
+     */
+    void unionAll(const std::vector<std::pair<SparseDomain, SparseDomain>>& pairs) {
+        std::vector<std::pair<parent_t, parent_t>> densePairs(pairs.size());
+#pragma omp parallel for schedule(static) num_threads(getTaskThreads()) \
+        if (pairs.size() >= parallel_union_batch)
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            densePairs[i] = std::make_pair(toDense(pairs[i].first), toDense(pairs[i].second));
+        }
+        ds.unionAll(densePairs);
+    }
+
     inline std::size_t size() {
         return ds.size();
     };
@@ -626,10 +690,10 @@ public:
         // we should clear this first, as we want to reduce how many locks are blocking at one given moment
         ds.clear();
 
-        mapsLock.lock();
-        sparseToDenseMap.clear();
+        for (auto& shard : shards) {
+            shard.sparseToDenseMap.clear();
+        }
         denseToSparseMap.clear();
-        mapsLock.unlock();
     }
 
     /**
@@ -649,11 +713,10 @@ public:
 
     /* whether we the supplied node exists */
     inline bool nodeExists(const SparseDomain val) const {
-        mapsLock.lock_shared();
-        bool result = sparseToDenseMap.find(val) != sparseToDenseMap.end();
-        mapsLock.unlock_shared();
+        Shard& shard = getShard(val);
+        std::lock_guard<std::mutex> guard(shard.lock);
 
-        return result;
+        return shard.sparseToDenseMap.find(val) != shard.sparseToDenseMap.end();
     };
 
     inline bool contains(SparseDomain v1, SparseDomain v2) {
@@ -27,17 +27,18 @@ public:
             : symbolMask(symbolMask), symbolTable(symbolTable), isProvenance(prov) {}
     template <typename T>
     void writeAll(const T& relation) {
-        auto lease = symbolTable.acquireLock();
-        (void)lease;
         for (const auto& current : relation) {
             writeNext(current);
         }
+        writeEnd();
     }
 
     virtual ~WriteStream() = default;
 
 protected:
     virtual void writeNextTuple(const RamDomain* tuple) = 0;
+    /** Complete the output after the last tuple, reporting failures by exceptions */
+    virtual void writeEnd() {}
     template <typename Tuple>
     void writeNext(const Tuple tuple) {
         writeNextTuple(tuple.data);
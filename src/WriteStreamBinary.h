@@ -0,0 +1,139 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file WriteStreamBinary.h
+ *
+ ***********************************************************************/
+
+#pragma once
+
+#include "IODirectives.h"
+#include "StreamBinary.h"
+#include "SymbolMask.h"
+#include "SymbolTable.h"
+#include "WriteStream.h"
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace souffle {
+
+/**
+ * Writes a relation in the binary fact format described in StreamBinary.h.
+ *
+ * Tuples are collected column by column and the file is written once all
+ * tuples have been passed, since the header records the number of tuples.
+ */
+class WriteFileBinary : public StreamBinary, public WriteStream {
+public:
+    WriteFileBinary(const SymbolMask& symbolMask, const SymbolTable& symbolTable,
+            const IODirectives& ioDirectives, const bool provenance = false)
+            : WriteStream(symbolMask, symbolTable, provenance),
+              arity(provenance ? symbolMask.getArity() - 2 : symbolMask.getArity()), columns(arity),
+              fileName(getFileName(ioDirectives)),
+              file(fileName, std::ios::out | std::ios::binary | std::ios::trunc) {
+        if (!file.is_open()) {
+            throw std::invalid_argument("Cannot open output file " + fileName + "\n");
+        }
+    }
+
+    ~WriteFileBinary() override = default;
+
+protected:
+    void writeNextTuple(const RamDomain* tuple) override {
+        for (size_t col = 0; col < arity; ++col) {
+            if (symbolMask.isSymbol(col)) {
+                columns[col].push_back(getSymbolIndex(tuple[col]));
+            } else {
+                columns[col].push_back(tuple[col]);
+            }
+        }
+        ++numTuples;
+    }
+
+    void writeEnd() override {
+        // header
+        char header[HEADER_SIZE];
+        std::memcpy(header, MAGIC, 4);
+        encode<uint32_t>(header + 4, VERSION);
+        encode<uint32_t>(header + 8, sizeof(RamDomain));
+        encode<uint32_t>(header + 12, arity);
+        encode<uint64_t>(header + 16, numTuples);
+        encode<uint64_t>(header + 24, symbols.size());
+        file.write(header, HEADER_SIZE);
+
+        // columns
+        std::vector<char> buffer;
+        for (const auto& column : columns) {
+            buffer.resize(column.size() * sizeof(RamDomain));
+            for (size_t i = 0; i < column.size(); ++i) {
+                encode<RamDomain>(buffer.data() + i * sizeof(RamDomain), column[i]);
+            }
+            file.write(buffer.data(), buffer.size());
+        }
+
+        // symbol dictionary
+        buffer.resize((symbols.size() + 1) * sizeof(uint64_t));
+        uint64_t offset = 0;
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            encode<uint64_t>(buffer.data() + i * sizeof(uint64_t), offset);
+            offset += symbols[i].size();
+        }
+        encode<uint64_t>(buffer.data() + symbols.size() * sizeof(uint64_t), offset);
+        file.write(buffer.data(), buffer.size());
+        for (const auto& symbol : symbols) {
+            file.write(symbol.data(), symbol.size());
+        }
+
+        file.close();
+        if (file.fail()) {
+            throw std::runtime_error("Cannot write output file " + fileName + "\n");
+        }
+    }
+
+    /** Return the index of a symbol in the file-local dictionary */
+    RamDomain getSymbolIndex(RamDomain index) {
+        auto it = symbolIndex.find(index);
+        if (it != symbolIndex.end()) {
+            return it->second;
+        }
+        RamDomain localIndex = symbols.size();
+        symbols.push_back(symbolTable.unsafeResolve(index));
+        symbolIndex[index] = localIndex;
+        return localIndex;
+    }
+
+    const size_t arity;
+    size_t numTuples = 0;
+    std::vector<std::vector<RamDomain>> columns;
+    std::unordered_map<RamDomain, RamDomain> symbolIndex;
+    std::vector<std::string> symbols;
+    const std::string fileName;
+    std::ofstream file;
+};
+
+class WriteFileBinaryFactory : public WriteStreamFactory {
+public:
+    std::unique_ptr<WriteStream> getWriter(const SymbolMask& symbolMask, const SymbolTable& symbolTable,
+            const IODirectives& ioDirectives, const bool provenance) override {
+        return std::make_unique<WriteFileBinary>(symbolMask, symbolTable, ioDirectives, provenance);
+    }
+    const std::string& getName() const override {
+        static const std::string name = "binary";
+        return name;
+    }
+    ~WriteFileBinaryFactory() override = default;
+};
+
+} /* namespace souffle */
@@ -14,14 +14,18 @@
 
 #pragma once
 
+#include "IODirectives.h"
 #include "SymbolMask.h"
 #include "SymbolTable.h"
 #include "WriteStream.h"
 
+#include <algorithm>
+#include <cctype>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <sqlite3.h>
 
@@ -30,7 +34,8 @@ namespace souffle {
 class WriteStreamSQLite : public WriteStream {
 public:
     WriteStreamSQLite(const std::string& dbFilename, const std::string& relationName,
-            const SymbolMask& symbolMask, const SymbolTable& symbolTable, const bool provenance)
+            const SymbolMask& symbolMask, const SymbolTable& symbolTable, const IODirectives& ioDirectives,
+            const bool provenance)
             : WriteStream(symbolMask, symbolTable, provenance), dbFilename(dbFilename),
               relationName(relationName) {
         if (provenance) {
@@ -38,18 +43,24 @@ public:
         } else {
             arity = symbolMask.getArity();
         }
+        if (ioDirectives.has("batchsize")) {
+            batchSize = std::stoull(ioDirectives.get("batchsize"));
+        }
 
-        openDB();
-        createTables();
-        prepareStatements();
-        //        executeSQL("BEGIN TRANSACTION", db);
+        try {
+            openDB(ioDirectives);
+            createTables();
+            prepareStatements();
+            loadSymbolTable();
+            executeSQL("BEGIN TRANSACTION", db);
+        } catch (...) {
+            closeDB();
+            throw;
+        }
     }
 
     ~WriteStreamSQLite() override {
-        sqlite3_finalize(insertStatement);
-        sqlite3_finalize(symbolInsertStatement);
-        sqlite3_finalize(symbolSelectStatement);
-        sqlite3_close(db);
+        closeDB();
     }
 
 protected:
@@ -59,28 +70,57 @@ protected:
         }
 
         for (size_t i = 0; i < arity; i++) {
-            RamDomain value;
             if (symbolMask.isSymbol(i)) {
-                value = getSymbolTableID(tuple[i]);
+                pending.push_back(getSymbolTableID(tuple[i]));
             } else {
-                value = tuple[i];
+                pending.push_back(tuple[i]);
             }
+        }
+        if (pending.size() < rowsPerInsert * arity) {
+            return;
+        }
+        insertRows(batchInsertStatement, pending.data(), rowsPerInsert);
+        pending.clear();
+
+        // start a new transaction once the batch is full
+        numUncommitted += rowsPerInsert;
+        if (batchSize > 0 && numUncommitted >= batchSize) {
+            insertPendingSymbols();
+            executeSQL("COMMIT", db);
+            executeSQL("BEGIN TRANSACTION", db);
+            numUncommitted = 0;
+        }
+    }
+
+    void writeEnd() override {
+        // insert the tuples that did not fill a multi-row insert
+        for (size_t i = 0; arity > 0 && i < pending.size(); i += arity) {
+            insertRows(insertStatement, pending.data() + i, 1);
+        }
+        pending.clear();
+        insertPendingSymbols();
+        executeSQL("COMMIT", db);
+    }
+
+private:
+    /** Insert consecutive rows of values using an insert statement for that many rows */
+    void insertRows(sqlite3_stmt* statement, const RamDomain* values, size_t rows) {
+        for (size_t i = 0; i < rows * arity; i++) {
 #if RAM_DOMAIN_SIZE == 64
-            if (sqlite3_bind_int64(insertStatement, i + 1, value) != SQLITE_OK) {
+            if (sqlite3_bind_int64(statement, i + 1, values[i]) != SQLITE_OK) {
 #else
-            if (sqlite3_bind_int(insertStatement, i + 1, value) != SQLITE_OK) {
+            if (sqlite3_bind_int(statement, i + 1, values[i]) != SQLITE_OK) {
 #endif
                 throwError("SQLite error in sqlite3_bind_text: ");
             }
         }
-        if (sqlite3_step(insertStatement) != SQLITE_DONE) {
+        if (sqlite3_step(statement) != SQLITE_DONE) {
             throwError("SQLite error in sqlite3_step: ");
         }
-        sqlite3_clear_bindings(insertStatement);
-        sqlite3_reset(insertStatement);
+        sqlite3_clear_bindings(statement);
+        sqlite3_reset(statement);
     }
 
-private:
     void executeSQL(const std::string& sql, sqlite3* db) {
         assert(db && "Database connection is closed");
 
@@ -103,89 +143,167 @@ private:
         throw std::invalid_argument(error.str());
     }
 
-    uint64_t getSymbolTableIDFromDB(int index) {
-        if (sqlite3_bind_text(symbolSelectStatement, 1, symbolTable.unsafeResolve(index).c_str(), -1,
-                    SQLITE_TRANSIENT) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_bind_text: ");
+    uint64_t getSymbolTableID(int index) {
+        auto cached = dbSymbolTable.find(index);
+        if (cached != dbSymbolTable.end()) {
+            return cached->second;
+        }
+
+        // symbols stored by earlier writers were loaded up front
+        const std::string& symbol = symbolTable.unsafeResolve(index);
+        auto existing = dbSymbols.find(symbol);
+        if (existing != dbSymbols.end()) {
+            dbSymbolTable[index] = existing->second;
+            return existing->second;
+        }
+
+        // new symbols are numbered here and inserted in batches
+        uint64_t id = nextSymbolID++;
+        pendingSymbols.push_back(symbol);
+        if (pendingSymbols.size() == symbolsPerInsert) {
+            insertSymbols(batchSymbolInsertStatement, id + 1 - symbolsPerInsert, 0, symbolsPerInsert);
+            pendingSymbols.clear();
+        }
+
+        dbSymbolTable[index] = id;
+        return id;
+    }
+
+    /** Insert consecutive pending symbols, numbered from the given identifier, using an insert statement */
+    void insertSymbols(sqlite3_stmt* statement, uint64_t firstID, size_t first, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            const std::string& symbol = pendingSymbols[first + i];
+            if (sqlite3_bind_int64(statement, 2 * i + 1, firstID + i) != SQLITE_OK) {
+                throwError("SQLite error in sqlite3_bind_int64: ");
+            }
+            if (sqlite3_bind_text(statement, 2 * i + 2, symbol.c_str(), -1, SQLITE_STATIC) != SQLITE_OK) {
+                throwError("SQLite error in sqlite3_bind_text: ");
+            }
         }
-        if (sqlite3_step(symbolSelectStatement) != SQLITE_ROW) {
+        if (sqlite3_step(statement) != SQLITE_DONE) {
             throwError("SQLite error in sqlite3_step: ");
         }
-        uint64_t rowid = sqlite3_column_int64(symbolSelectStatement, 0);
-        sqlite3_clear_bindings(symbolSelectStatement);
-        sqlite3_reset(symbolSelectStatement);
-        return rowid;
+        sqlite3_clear_bindings(statement);
+        sqlite3_reset(statement);
     }
-    uint64_t getSymbolTableID(int index) {
-        if (dbSymbolTable.count(index) != 0) {
-            return dbSymbolTable[index];
+
+    /** Insert the new symbols that did not fill a multi-row insert */
+    void insertPendingSymbols() {
+        uint64_t firstID = nextSymbolID - pendingSymbols.size();
+        for (size_t i = 0; i < pendingSymbols.size(); i++) {
+            insertSymbols(symbolInsertStatement, firstID + i, i, 1);
         }
+        pendingSymbols.clear();
+    }
 
-        if (sqlite3_bind_text(symbolInsertStatement, 1, symbolTable.unsafeResolve(index).c_str(), -1,
-                    SQLITE_TRANSIENT) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_bind_text: ");
+    /** Load the symbols already stored in the database in a single pass */
+    void loadSymbolTable() {
+        bool hasSymbols = false;
+        for (size_t i = 0; i < arity; i++) {
+            hasSymbols = hasSymbols || symbolMask.isSymbol(i);
         }
-        // Either the insert succeeds and we have a new row id or it already exists and a select is needed.
-        uint64_t rowid;
-        if (sqlite3_step(symbolInsertStatement) != SQLITE_DONE) {
-            // The symbol already exists so select it.
-            rowid = getSymbolTableIDFromDB(index);
-        } else {
-            rowid = sqlite3_last_insert_rowid(db);
+        if (!hasSymbols) {
+            return;
         }
-        sqlite3_clear_bindings(symbolInsertStatement);
-        sqlite3_reset(symbolInsertStatement);
 
-        dbSymbolTable[index] = rowid;
-        return rowid;
+        sqlite3_stmt* selectStatement = nullptr;
+        std::string selectSQL = "SELECT id, symbol FROM '" + symbolTableName + "';";
+        if (sqlite3_prepare_v2(db, selectSQL.c_str(), -1, &selectStatement, nullptr) != SQLITE_OK) {
+            throwError("SQLite error in sqlite3_prepare_v2: ");
+        }
+        int rc;
+        while ((rc = sqlite3_step(selectStatement)) == SQLITE_ROW) {
+            const char* symbol = reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 1));
+            uint64_t id = sqlite3_column_int64(selectStatement, 0);
+            dbSymbols[symbol == nullptr ? "" : symbol] = id;
+            nextSymbolID = std::max(nextSymbolID, id + 1);
+        }
+        sqlite3_finalize(selectStatement);
+        if (rc != SQLITE_DONE) {
+            throwError("SQLite error in sqlite3_step: ");
+        }
     }
 
-    void openDB() {
+    void openDB(const IODirectives& ioDirectives) {
+        const std::string synchronous = getPragma(ioDirectives, "synchronous", "OFF", SYNCHRONOUS_MODES);
+        const std::string journal = getPragma(ioDirectives, "journal", "MEMORY", JOURNAL_MODES);
         if (sqlite3_open(dbFilename.c_str(), &db) != SQLITE_OK) {
             throwError("SQLite error in sqlite3_open");
         }
         sqlite3_extended_result_codes(db, 1);
-        executeSQL("PRAGMA synchronous = OFF", db);
-        executeSQL("PRAGMA journal_mode = MEMORY", db);
+        executeSQL("PRAGMA synchronous = " + synchronous, db);
+        executeSQL("PRAGMA journal_mode = " + journal, db);
     }
 
-    void prepareStatements() {
-        prepareInsertStatement();
-        prepareSymbolInsertStatement();
-        prepareSymbolSelectStatement();
+    /** Release the statements and the connection, which rolls back an uncommitted transaction */
+    void closeDB() {
+        sqlite3_finalize(insertStatement);
+        sqlite3_finalize(batchInsertStatement);
+        sqlite3_finalize(symbolInsertStatement);
+        sqlite3_finalize(batchSymbolInsertStatement);
+        sqlite3_close(db);
+        db = nullptr;
     }
-    void prepareSymbolInsertStatement() {
-        std::stringstream insertSQL;
-        insertSQL << "INSERT INTO " << symbolTableName;
-        insertSQL << " VALUES(null,@V0);";
-        const char* tail = nullptr;
-        if (sqlite3_prepare_v2(db, insertSQL.str().c_str(), -1, &symbolInsertStatement, &tail) != SQLITE_OK) {
-            throwError("SQLite error in sqlite3_prepare_v2: ");
+
+    /** Return the value of a pragma given as IO directive, checking it against the admissible values */
+    static std::string getPragma(const IODirectives& ioDirectives, const std::string& key,
+            const std::string& defaultValue, const std::vector<std::string>& values) {
+        if (!ioDirectives.has(key)) {
+            return defaultValue;
         }
+        std::string value = ioDirectives.get(key);
+        std::transform(value.begin(), value.end(), value.begin(), ::toupper);
+        if (std::find(values.begin(), values.end(), value) == values.end()) {
+            throw std::invalid_argument(
+                    "Invalid value <" + ioDirectives.get(key) + "> of IO directive " + key + "\n");
+        }
+        return value;
+    }
+
+    void prepareStatements() {
+        if (arity > 0) {
+            rowsPerInsert = MAX_VARIABLES / arity;
+            rowsPerInsert = (rowsPerInsert > MAX_ROWS_PER_INSERT) ? MAX_ROWS_PER_INSERT : rowsPerInsert;
+            rowsPerInsert = (rowsPerInsert == 0) ? 1 : rowsPerInsert;
+        }
+        insertStatement = prepareInsertStatement(1);
+        batchInsertStatement = prepareInsertStatement(rowsPerInsert);
+        symbolInsertStatement = prepareSymbolInsertStatement(1);
+        batchSymbolInsertStatement = prepareSymbolInsertStatement(symbolsPerInsert);
     }
 
-    void prepareSymbolSelectStatement() {
-        std::stringstream selectSQL;
-        selectSQL << "SELECT id FROM " << symbolTableName;
-        selectSQL << " WHERE symbol = @V0;";
+    sqlite3_stmt* prepareSymbolInsertStatement(size_t rows) {
+        std::stringstream insertSQL;
+        insertSQL << "INSERT INTO " << symbolTableName << " VALUES ";
+        for (size_t row = 0; row < rows; row++) {
+            insertSQL << (row == 0 ? "(?,?)" : ",(?,?)");
+        }
+        insertSQL << ";";
         const char* tail = nullptr;
-        if (sqlite3_prepare_v2(db, selectSQL.str().c_str(), -1, &symbolSelectStatement, &tail) != SQLITE_OK) {
+        sqlite3_stmt* statement = nullptr;
+        if (sqlite3_prepare_v2(db, insertSQL.str().c_str(), -1, &statement, &tail) != SQLITE_OK) {
             throwError("SQLite error in sqlite3_prepare_v2: ");
         }
+        return statement;
     }
 
-    void prepareInsertStatement() {
+    sqlite3_stmt* prepareInsertStatement(size_t rows) {
         std::stringstream insertSQL;
         insertSQL << "INSERT INTO _" << relationName << " VALUES ";
-        insertSQL << "(@V0";
-        for (unsigned int i = 1; i < arity; i++) {
-            insertSQL << ",@V" << i;
+        for (size_t row = 0; row < rows; row++) {
+            insertSQL << (row == 0 ? "(?" : ",(?");
+            for (unsigned int i = 1; i < arity; i++) {
+                insertSQL << ",?";
+            }
+            insertSQL << ")";
         }
-        insertSQL << ");";
+        insertSQL << ";";
         const char* tail = nullptr;
-        if (sqlite3_prepare_v2(db, insertSQL.str().c_str(), -1, &insertStatement, &tail) != SQLITE_OK) {
+        sqlite3_stmt* statement = nullptr;
+        if (sqlite3_prepare_v2(db, insertSQL.str().c_str(), -1, &statement, &tail) != SQLITE_OK) {
             throwError("SQLite error in sqlite3_prepare_v2: ");
         }
+        return statement;
     }
 
     void createTables() {
@@ -251,15 +369,39 @@ private:
         executeSQL(createTableText.str(), db);
     }
 
-    const std::string& dbFilename;
-    const std::string& relationName;
+    const std::vector<std::string> SYNCHRONOUS_MODES = {"OFF", "NORMAL", "FULL", "EXTRA"};
+    const std::vector<std::string> JOURNAL_MODES = {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+
+    const std::string dbFilename;
+    const std::string relationName;
     const std::string symbolTableName = "__SymbolTable";
     size_t arity;
 
+    /** Limits of the number of rows and of host parameters of a single insert statement */
+    static const size_t MAX_ROWS_PER_INSERT = 64;
+    static const size_t MAX_VARIABLES = 999;
+
+    /** Number of tuples inserted per transaction, or 0 to insert all tuples in a single transaction */
+    size_t batchSize = 0;
+    size_t numUncommitted = 0;
+
+    /** Number of tuples inserted by a single statement, and values of tuples waiting to be inserted */
+    size_t rowsPerInsert = 1;
+    std::vector<RamDomain> pending;
+
+    /** Number of symbols inserted by a single statement, the new symbols waiting to be inserted and the
+     * identifier of the next new symbol */
+    const size_t symbolsPerInsert =
+            (MAX_VARIABLES / 2 < MAX_ROWS_PER_INSERT) ? MAX_VARIABLES / 2 : MAX_ROWS_PER_INSERT;
+    std::vector<std::string> pendingSymbols;
+    uint64_t nextSymbolID = 1;
+
     std::unordered_map<uint64_t, uint64_t> dbSymbolTable;
+    std::unordered_map<std::string, uint64_t> dbSymbols;
     sqlite3_stmt* insertStatement = nullptr;
+    sqlite3_stmt* batchInsertStatement = nullptr;
     sqlite3_stmt* symbolInsertStatement = nullptr;
-    sqlite3_stmt* symbolSelectStatement = nullptr;
+    sqlite3_stmt* batchSymbolInsertStatement = nullptr;
     sqlite3* db = nullptr;
 };
 
@@ -269,7 +411,8 @@ public:
             const IODirectives& ioDirectives, const bool provenance) override {
         std::string dbName = ioDirectives.get("dbname");
         std::string relationName = ioDirectives.getRelationName();
-        return std::make_unique<WriteStreamSQLite>(dbName, relationName, symbolMask, symbolTable, provenance);
+        return std::make_unique<WriteStreamSQLite>(
+                dbName, relationName, symbolMask, symbolTable, ioDirectives, provenance);
     }
     const std::string& getName() const override {
         static const std::string name = "sqlite";
@@ -32,6 +32,7 @@
 #include "RamSemanticChecker.h"
 #include "RamTransformer.h"
 #include "RamTranslationUnit.h"
+#include "ResourceLimits.h"
 #include "SymbolTable.h"
 #include "Synthesiser.h"
 #include "Util.h"
@@ -194,9 +195,29 @@ int main(int argc, char** argv) {
                             {"dl-program", 'o', "FILE", "", false,
                                     "Generate C++ source code, written to <FILE>, and compile this to a "
                                     "binary executable (without executing it)."},
+                            {"incremental", '\0', "", "", false,
+                                    "Generate incremental evaluation of tuples inserted between runs of "
+                                    "monotone programs; requires -c, -o or -g."},
+                            {"adaptive-joins", '\0', "", "", false,
+                                    "Reorder the loop nests of recursive rules of the interpreter by the "
+                                    "sizes of relations at each iteration."},
                             {"live-profile", 'l', "", "", false, "Enable live profiling."},
                             {"profile", 'p', "FILE", "", false,
                                     "Enable profiling, and write profile data to <FILE>."},
+                            {"profile-selectivity", '\0', "", "", false,
+                                    "Also profile the tuples visited and passed on by each atom, and the "
+                                    "searches finding tuples (requires --profile)."},
+                            {"profile-use", 'u', "FILE", "", false,
+                                    "Use the profile data in <FILE> of a previous run for profile-guided "
+                                    "optimisation."},
+                            {"tuple-limit", '\0', "LIMITS", "", false,
+                                    "Abort the evaluation if a relation exceeds a number of tuples, given "
+                                    "for all relations as <N> or for single relations as <relation>=<N>,..."},
+                            {"stratum-timeout", '\0', "SECONDS", "", false,
+                                    "Abort the evaluation if a stratum runs longer than <SECONDS>."},
+                            {"partial-output", '\0', "", "", false,
+                                    "Store the output relations computed so far if the evaluation is "
+                                    "aborted by a limit."},
                             {"debug-report", 'r', "FILE", "", false, "Write HTML debug report to <FILE>."},
 #ifdef USE_PROVENANCE
                             {"provenance", 't', "EXPLAIN", "", false,
@@ -296,6 +317,34 @@ int main(int argc, char** argv) {
             }
         }
 
+        /* incremental evaluation keeps all relations of a single process and is not profiled */
+        if (Global::config().has("incremental")) {
+            if (!(Global::config().has("compile") || Global::config().has("generate"))) {
+                throw std::invalid_argument(
+                        "Error: Use of incremental option not yet available for interpreter.");
+            }
+            if (Global::config().has("engine") || Global::config().has("provenance") ||
+                    Global::config().has("profile")) {
+                throw std::runtime_error(
+                        "incremental evaluation cannot be enabled with distributed execution, provenance or "
+                        "profiling.");
+            }
+        }
+
+        /* check the resource limits, which are checked between strata of a single process */
+        if (Global::config().has("tuple-limit") || Global::config().has("stratum-timeout")) {
+            if (Global::config().has("engine")) {
+                throw std::runtime_error("resource limits cannot be enabled with distributed execution.");
+            }
+            ResourceLimits limits;
+            if (Global::config().has("tuple-limit")) {
+                limits.setTupleLimits(Global::config().get("tuple-limit"));
+            }
+            if (Global::config().has("stratum-timeout")) {
+                limits.setStratumTimeout(Global::config().get("stratum-timeout"));
+            }
+        }
+
         /* ensure that souffle has been compiled with support for the execution engine, if specified */
         if (Global::config().has("engine")) {
             if (!(Global::config().has("compile") || Global::config().has("dl-program") ||
@@ -511,13 +560,21 @@ int main(int argc, char** argv) {
         if (Global::config().has("live-profile") && !Global::config().has("compile")) {
             profiler = std::thread([]() { profile::Tui().runProf(); });
         }
-        // execute translation unit
-        interpreter->executeMain();
+        // execute translation unit; an exceeded resource limit is reported by the interpreter
+        bool aborted = false;
+        try {
+            interpreter->executeMain();
+        } catch (const ResourceLimitExceeded&) {
+            aborted = true;
+        }
 
         // If the profiler was started, join back here once it exits.
         if (profiler.joinable()) {
             profiler.join();
         }
+        if (aborted) {
+            return 1;
+        }
 
 #ifdef USE_PROVENANCE
         // only run explain interface if interpreted
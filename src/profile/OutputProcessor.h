@@ -218,6 +218,10 @@ Table inline OutputProcessor::getRulTable() {
  * ROW[1] = atom
  * ROW[2] = level
  * ROW[3] = frequency
+ * ROW[4] = searches
+ * ROW[5] = hits
+ * ROW[6] = visited
+ * ROW[7] = passed
  */
 Table inline OutputProcessor::getAtomTable(std::string strRel, std::string strRul) {
     std::unordered_map<std::string, std::shared_ptr<Relation>>& relation_map = programRun->getRelation_map();
@@ -236,11 +240,15 @@ Table inline OutputProcessor::getAtomTable(std::string strRel, std::string strRu
                 continue;
             }
             for (auto& atom : rul->getAtoms()) {
-                Row row(4);
+                Row row(8);
                 row[0] = std::shared_ptr<CellInterface>(new Cell<std::string>(atom.rule));
                 row[1] = std::shared_ptr<CellInterface>(new Cell<std::string>(atom.identifier));
                 row[2] = std::shared_ptr<CellInterface>(new Cell<long>(atom.level));
                 row[3] = std::shared_ptr<CellInterface>(new Cell<long>(atom.frequency));
+                row[4] = std::shared_ptr<CellInterface>(new Cell<long>(atom.searches));
+                row[5] = std::shared_ptr<CellInterface>(new Cell<long>(atom.hits));
+                row[6] = std::shared_ptr<CellInterface>(new Cell<long>(atom.visited));
+                row[7] = std::shared_ptr<CellInterface>(new Cell<long>(atom.passed));
 
                 table.addRow(std::make_shared<Row>(row));
             }
@@ -362,6 +370,10 @@ Table inline OutputProcessor::getVersions(std::string strRel, std::string strRul
  * ROW[1] = atom
  * ROW[2] = level
  * ROW[3] = frequency
+ * ROW[4] = searches
+ * ROW[5] = hits
+ * ROW[6] = visited
+ * ROW[7] = passed
  */
 Table inline OutputProcessor::getVersionAtoms(std::string strRel, std::string srcLocator, int version) {
     std::unordered_map<std::string, std::shared_ptr<Relation>>& relation_map = programRun->getRelation_map();
@@ -375,11 +387,15 @@ Table inline OutputProcessor::getVersionAtoms(std::string strRel, std::string sr
                     std::shared_ptr<Rule> rul = _rul.second;
                     if (rul->getLocator().compare(srcLocator) == 0 && rul->getVersion() == version) {
                         for (auto& atom : rul->getAtoms()) {
-                            Row row(4);
+                            Row row(8);
                             row[0] = std::shared_ptr<CellInterface>(new Cell<std::string>(atom.rule));
                             row[1] = std::shared_ptr<CellInterface>(new Cell<std::string>(atom.identifier));
                             row[2] = std::shared_ptr<CellInterface>(new Cell<long>(atom.level));
                             row[3] = std::shared_ptr<CellInterface>(new Cell<long>(atom.frequency));
+                            row[4] = std::shared_ptr<CellInterface>(new Cell<long>(atom.searches));
+                            row[5] = std::shared_ptr<CellInterface>(new Cell<long>(atom.hits));
+                            row[6] = std::shared_ptr<CellInterface>(new Cell<long>(atom.visited));
+                            row[7] = std::shared_ptr<CellInterface>(new Cell<long>(atom.passed));
                             table.addRow(std::make_shared<Row>(row));
                         }
                     }
@@ -71,13 +71,14 @@ public:
         const std::string& clause = directory.getKey();
 
         for (auto& key : directory.getKeys()) {
-            auto* level = dynamic_cast<SizeEntry*>(directory.readDirectoryEntry(key)->readEntry("level"));
-            auto* frequency =
-                    dynamic_cast<SizeEntry*>(directory.readDirectoryEntry(key)->readEntry("num-tuples"));
-            // Handle older logs
-            size_t intFreq = frequency == nullptr ? 0 : frequency->getSize();
-            size_t intLevel = level == nullptr ? 0 : level->getSize();
-            rule.addAtomFrequency(clause, key, intLevel, intFreq);
+            DirectoryEntry* atom = directory.readDirectoryEntry(key);
+            // Handle older logs and logs without selectivity counters
+            auto readSize = [&](const std::string& name) -> size_t {
+                auto* entry = dynamic_cast<SizeEntry*>(atom->readEntry(name));
+                return entry == nullptr ? 0 : entry->getSize();
+            };
+            rule.addAtomFrequency(clause, key, readSize("level"), readSize("num-tuples"),
+                    readSize("searches"), readSize("hits"), readSize("visited"), readSize("passed"));
         }
     }
 
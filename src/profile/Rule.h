@@ -26,9 +26,16 @@ public:
     const std::string rule;
     const size_t level;
     const size_t frequency;
+    /** selectivity counters, which are only recorded with the profile-selectivity option */
+    const size_t searches;
+    const size_t hits;
+    const size_t visited;
+    const size_t passed;
 
-    Atom(std::string identifier, std::string rule, size_t level, size_t frequency)
-            : identifier(std::move(identifier)), rule(std::move(rule)), level(level), frequency(frequency) {}
+    Atom(std::string identifier, std::string rule, size_t level, size_t frequency, size_t searches = 0,
+            size_t hits = 0, size_t visited = 0, size_t passed = 0)
+            : identifier(std::move(identifier)), rule(std::move(rule)), level(level), frequency(frequency),
+              searches(searches), hits(hits), visited(visited), passed(passed) {}
 
     bool operator<(const Atom& other) const {
         if (rule != other.rule) {
@@ -95,9 +102,9 @@ public:
         this->num_tuples = num_tuples;
     }
 
-    inline void addAtomFrequency(
-            const std::string& subruleName, std::string atom, size_t level, size_t frequency) {
-        atoms.emplace(atom, subruleName, level, frequency);
+    inline void addAtomFrequency(const std::string& subruleName, std::string atom, size_t level,
+            size_t frequency, size_t searches = 0, size_t hits = 0, size_t visited = 0, size_t passed = 0) {
+        atoms.emplace(atom, subruleName, level, frequency, searches, hits, visited, passed);
     }
 
     const std::set<Atom>& getAtoms() {
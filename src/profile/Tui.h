@@ -1284,6 +1284,11 @@ protected:
         if (atomTable.rows.empty()) {
             return;
         }
+        // show the selectivity of atoms if it was profiled
+        bool selectivity = false;
+        for (auto& _row : atomTable.rows) {
+            selectivity = selectivity || (*_row)[4]->getLongVal() > 0;
+        }
         bool firstRun = true;
         std::string lastRule = ruleName;
         for (auto& _row : atomTable.rows) {
@@ -1295,7 +1300,12 @@ protected:
                 firstRun = true;
             }
             if (firstRun) {
-                std::printf("      %-16s%-16s%s\n", "FREQ", "RELSIZE", "ATOM");
+                if (selectivity) {
+                    std::printf("      %-16s%-16s%-12s%-8s%-12s%-8s%s\n", "FREQ", "RELSIZE", "VISITED",
+                            "SEL%", "AVG-RANGE", "HIT%", "ATOM");
+                } else {
+                    std::printf("      %-16s%-16s%s\n", "FREQ", "RELSIZE", "ATOM");
+                }
                 firstRun = false;
             }
             std::string relationName = row[1]->getStringVal();
@@ -1303,8 +1313,23 @@ protected:
             auto* relation = out.getProgramRun()->getRelation(relationName);
             std::string relationSize =
                     relation == nullptr ? "--" : std::to_string(relation->getNum_tuplesRel());
-            std::printf("      %-16s%-16s%s\n", row[3]->toString(precision).c_str(), relationSize.c_str(),
-                    row[1]->getStringVal().c_str());
+            if (!selectivity) {
+                std::printf("      %-16s%-16s%s\n", row[3]->toString(precision).c_str(),
+                        relationSize.c_str(), row[1]->getStringVal().c_str());
+                continue;
+            }
+
+            // the share of visited tuples passed on, the tuples visited per search,
+            // and the share of searches finding any tuple
+            long searches = row[4]->getLongVal();
+            long visited = row[6]->getLongVal();
+            auto ratio = [](long a, long b, double scale) {
+                return b == 0 ? std::string("--") : Tools::formatNum(0, scale * a / b);
+            };
+            std::printf("      %-16s%-16s%-12s%-8s%-12s%-8s%s\n", row[3]->toString(precision).c_str(),
+                    relationSize.c_str(), Tools::formatNum(precision, visited).c_str(),
+                    ratio(row[7]->getLongVal(), visited, 100).c_str(), ratio(visited, searches, 1).c_str(),
+                    ratio(row[5]->getLongVal(), searches, 100).c_str(), row[1]->getStringVal().c_str());
         }
         std::cout << '\n';
     }
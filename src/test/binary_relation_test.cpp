@@ -446,15 +446,18 @@ TEST(BinRelTest, IterPartition) {
 
     auto chunks = br.partition(400);
     // we can't make too many assumptions..
-    EXPECT_TRUE(chunks.size() > 0);
+    EXPECT_TRUE(chunks.size() > 1);
 
+    size_t count = 0;
     for (auto chunk : chunks) {
         for (auto x = chunk.begin(); x != chunk.end(); ++x) {
             values.insert(std::make_pair((*x)[0], (*x)[1]));
+            ++count;
         }
     }
 
     EXPECT_EQ(br.size(), values.size());
+    EXPECT_EQ(br.size(), count);
 
     br.clear();
     values.clear();
@@ -467,12 +470,63 @@ TEST(BinRelTest, IterPartition) {
     EXPECT_EQ((size_t)4 * 1000 / 2, br.size());
 
     chunks = br.partition(400);
+    // small disjoint sets are gathered into the same partitions
+    EXPECT_TRUE(chunks.size() <= 400);
+
+    count = 0;
     for (auto chunk : chunks) {
         for (auto x = chunk.begin(); x != chunk.end(); ++x) {
             values.insert(std::make_pair((*x)[0], (*x)[1]));
+            ++count;
         }
     }
     EXPECT_EQ(br.size(), values.size());
+    EXPECT_EQ(br.size(), count);
+}
+
+TEST(BinRelTest, Extend) {
+    BinRel br1;
+    br1.insert(1, 2);
+    br1.insert(5, 6);
+    br1.insert(10, 11);
+
+    BinRel br2;
+    br2.insert(2, 3);
+    br2.insert(6, 7);
+    br2.insert(6, 8);
+    br2.insert(20, 21);
+
+    // iterate once, s.t. the orderings of the disjoint sets have been built
+    size_t count = 0;
+    for (auto x : br1) {
+        ++count;
+        binreltest::ignore(x);
+    }
+    EXPECT_EQ(12, count);
+
+    // {1,2,3}, {5,6,7,8}, {10,11}
+    br1.extend(br2);
+    EXPECT_EQ(9 + 16 + 4, br1.size());
+    EXPECT_TRUE(br1.contains(1, 3));
+    EXPECT_TRUE(br1.contains(8, 5));
+    EXPECT_FALSE(br1.contains(1, 5));
+    EXPECT_FALSE(br1.contains(20, 21));
+
+    std::set<std::pair<RamDomain, RamDomain>> values;
+    for (auto x : br1) {
+        values.insert(std::make_pair(x[0], x[1]));
+    }
+    EXPECT_EQ(br1.size(), values.size());
+
+    // {1,2,3}, {5,6,7,8}, {10,11}, {20,21}
+    br1.insertAll(br2);
+    EXPECT_EQ(9 + 16 + 4 + 4, br1.size());
+
+    values.clear();
+    for (auto x : br1) {
+        values.insert(std::make_pair(x[0], x[1]));
+    }
+    EXPECT_EQ(br1.size(), values.size());
 }
 
 TEST(BinRelTest, ParallelTest) {
@@ -514,6 +568,37 @@ TEST(BinRelTest, ParallelTest) {
 }
 
 #ifdef _OPENMP
+TEST(BinRelTest, ParallelPartition) {
+    // a single large disjoint set and many small ones
+    BinRel br;
+    const RamDomain N = 2000;
+    for (RamDomain i = 0; i < N; ++i) {
+        br.insert(0, i);
+    }
+    for (RamDomain i = N; i < 2 * N; i += 2) {
+        br.insert(i, i + 1);
+    }
+    EXPECT_EQ((size_t)N * N + 2 * N, br.size());
+
+    auto chunks = br.partition(400);
+    EXPECT_TRUE(chunks.size() > 100);
+
+    // enumerate the partitions in parallel
+    size_t count = 0;
+    size_t sameSet = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : count, sameSet)
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        for (const auto& x : chunks[i]) {
+            ++count;
+            if ((x[0] < N) == (x[1] < N) && (x[0] < N || x[0] / 2 == x[1] / 2)) {
+                ++sameSet;
+            }
+        }
+    }
+    EXPECT_EQ(br.size(), count);
+    EXPECT_EQ(br.size(), sameSet);
+}
+
 TEST(BinRelTest, ParallelScaling) {
     // use OpenMP this time
 
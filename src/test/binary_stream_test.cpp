@@ -0,0 +1,153 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file binary_stream_test.cpp
+ *
+ * Test cases for reading and writing relations in the binary fact format.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "IODirectives.h"
+#include "ReadStreamBinary.h"
+#include "SymbolMask.h"
+#include "SymbolTable.h"
+#include "WriteStreamBinary.h"
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace souffle {
+
+namespace test {
+
+/** A relation collecting the tuples read, in the order of reading */
+struct TupleList {
+    size_t arity;
+    std::vector<std::vector<RamDomain>> tuples;
+
+    TupleList(size_t arity) : arity(arity) {}
+
+    void insert(const RamDomain* tuple) {
+        tuples.push_back(std::vector<RamDomain>(tuple, tuple + arity));
+    }
+};
+
+/** Get the IO directives of a binary file */
+IODirectives getDirectives(const std::string& fileName) {
+    return IODirectives({{"IO", "binary"}, {"filename", fileName}});
+}
+
+/** Write tuples to a binary file */
+void writeTuples(const std::string& fileName, const SymbolMask& mask, const SymbolTable& symbolTable,
+        const std::vector<std::vector<RamDomain>>& tuples) {
+    std::vector<const RamDomain*> relation;
+    for (const auto& tuple : tuples) {
+        relation.push_back(tuple.data());
+    }
+    WriteFileBinaryFactory().getWriter(mask, symbolTable, getDirectives(fileName), false)->writeAll(relation);
+}
+
+TEST(BinaryStream, RoundTrip) {
+    char fileName[] = "/tmp/souffle_bin_XXXXXX";
+    close(mkstemp(fileName));
+
+    SymbolMask mask({false, true, false});
+    SymbolTable symbols;
+    std::vector<std::vector<RamDomain>> tuples;
+    for (RamDomain i = 0; i < 10000; i++) {
+        tuples.push_back({i - 5000, symbols.lookup("sym" + std::to_string(i % 100)), MAX_RAM_DOMAIN - i});
+    }
+    tuples.push_back({MIN_RAM_DOMAIN, symbols.lookup(""), 0});
+    writeTuples(fileName, mask, symbols, tuples);
+
+    // symbols are mapped to the indices of the symbol table read into
+    SymbolTable readSymbols;
+    readSymbols.lookup("other");
+    TupleList read(3);
+    ReadFileBinaryFactory().getReader(mask, readSymbols, getDirectives(fileName), false)->readAll(read);
+    std::remove(fileName);
+
+    EXPECT_EQ(tuples.size(), read.tuples.size());
+    bool same = true;
+    for (size_t i = 0; i < tuples.size() && i < read.tuples.size(); i++) {
+        same = same && tuples[i][0] == read.tuples[i][0] && tuples[i][2] == read.tuples[i][2] &&
+               symbols.resolve(tuples[i][1]) == readSymbols.resolve(read.tuples[i][1]);
+    }
+    EXPECT_TRUE(same);
+    EXPECT_EQ(symbols.size() + 1, readSymbols.size());
+}
+
+TEST(BinaryStream, EmptyRelation) {
+    char fileName[] = "/tmp/souffle_bin_XXXXXX";
+    close(mkstemp(fileName));
+
+    SymbolMask mask({true, false});
+    SymbolTable symbols;
+    writeTuples(fileName, mask, symbols, {});
+
+    TupleList read(2);
+    ReadFileBinaryFactory().getReader(mask, symbols, getDirectives(fileName), false)->readAll(read);
+    std::remove(fileName);
+    EXPECT_EQ(0, read.tuples.size());
+}
+
+TEST(BinaryStream, InvalidSymbolOffset) {
+    char fileName[] = "/tmp/souffle_bin_XXXXXX";
+    close(mkstemp(fileName));
+
+    SymbolMask mask({true});
+    SymbolTable symbols;
+    writeTuples(fileName, mask, symbols, {{symbols.lookup("ab")}, {symbols.lookup("cd")}});
+
+    // let the first symbol end far beyond the symbol data, keeping the final offset intact;
+    // the dictionary is rejected before the symbol is read
+    const long offsetPos = 32 + 2 * sizeof(RamDomain);
+    const char end[8] = {0, 0, 0, 0, 0, 1, 0, 0};
+    FILE* file = std::fopen(fileName, "r+b");
+    std::fseek(file, offsetPos + 8, SEEK_SET);
+    std::fwrite(end, 1, sizeof(end), file);
+    std::fclose(file);
+
+    SymbolTable readSymbols;
+    TupleList read(1);
+    bool failed = false;
+    try {
+        ReadFileBinaryFactory().getReader(mask, readSymbols, getDirectives(fileName), false)->readAll(read);
+    } catch (std::exception& e) {
+        failed = std::string(e.what()).find("Invalid symbol dictionary") != std::string::npos;
+    }
+    std::remove(fileName);
+    EXPECT_TRUE(failed);
+}
+
+TEST(BinaryStream, WriteError) {
+    // writing to a full device fails once the file is written
+    if (access("/dev/full", W_OK) != 0) {
+        return;
+    }
+    SymbolMask mask({false});
+    SymbolTable symbols;
+    bool failed = false;
+    try {
+        writeTuples("/dev/full", mask, symbols, {{1}, {2}});
+    } catch (std::exception&) {
+        failed = true;
+    }
+    EXPECT_TRUE(failed);
+}
+
+}  // end namespace test
+}  // end namespace souffle
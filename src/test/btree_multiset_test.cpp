@@ -355,6 +355,32 @@ TEST(BTreeMultiSet, Load) {
     }
 }
 
+TEST(BTreeMultiSet, InsertAll) {
+    using test_set = btree_multiset<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    for (int N : {0, 10, 1000}) {
+        for (int M : {0, 10, 1000}) {
+            test_set t;
+            test_set other;
+            std::multiset<int> should;
+            for (int i = 0; i < N; i++) {
+                t.insert(i % 100);
+                should.insert(i % 100);
+            }
+            for (int i = 0; i < M; i++) {
+                other.insert(i % 50);
+                should.insert(i % 50);
+            }
+
+            // all duplicates are retained
+            t.insertAll(other);
+            EXPECT_TRUE(t.check()) << "N=" << N << ", M=" << M;
+            EXPECT_EQ(should.size(), t.size()) << "N=" << N << ", M=" << M;
+            EXPECT_TRUE(std::equal(should.begin(), should.end(), t.begin())) << "N=" << N << ", M=" << M;
+        }
+    }
+}
+
 TEST(BTreeMultiSet, Clear) {
     using test_set = btree_multiset<int, detail::comparator<int>, std::allocator<int>, 16>;
 
@@ -372,6 +398,45 @@ TEST(BTreeMultiSet, Clear) {
     EXPECT_TRUE(t.empty());
 }
 
+TEST(BTreeMultiSet, Erase) {
+    using test_set = btree_multiset<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+
+    int N = 1000;
+
+    // insert every element three times
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < N; i++) {
+            t.insert(i);
+        }
+    }
+
+    // each erase removes a single instance
+    for (int i = 0; i < N; i += 2) {
+        EXPECT_TRUE(t.erase(i));
+    }
+    EXPECT_TRUE(t.check());
+    EXPECT_EQ((size_t)(3 * N - N / 2), t.size());
+
+    EXPECT_EQ((size_t)(2 * (N / 2) + 3 * (N / 2)), t.eraseRange(0, N));
+    EXPECT_TRUE(t.empty());
+
+    // remove a sorted sequence of duplicates
+    std::vector<int> data;
+    for (int i = 0; i < N; i++) {
+        t.insert(i);
+        t.insert(i);
+        data.push_back(i);
+    }
+    EXPECT_EQ((size_t)N, t.eraseSorted(data.begin(), data.end()));
+    EXPECT_TRUE(t.check());
+    EXPECT_EQ((size_t)N, t.size());
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(t.contains(i)) << "i=" << i;
+    }
+}
+
 using Entry = std::tuple<int, int>;
 
 std::vector<Entry> getData(unsigned numEntries) {
@@ -330,6 +330,37 @@ TEST(BTreeSet, Merge) {
     EXPECT_EQ(c, d);
 }
 
+TEST(BTreeSet, MergeAll) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    // merge a large tree into a small one and a small tree into a large one
+    test_set even;
+    test_set odd;
+    test_set few;
+    for (int i = 0; i < 10000; i++) {
+        (i % 2 == 0 ? even : odd).insert(i);
+    }
+    few.insert(3);
+    few.insert(20000);
+
+    test_set all;
+    all.mergeAll(even);
+    all.mergeAll(odd);
+    all.mergeAll(all);
+    EXPECT_EQ(10000, all.size());
+    EXPECT_TRUE(all.check());
+
+    all.mergeAll(few);
+    EXPECT_EQ(10001, all.size());
+    EXPECT_TRUE(all.check());
+
+    int expected = 0;
+    for (int cur : all) {
+        EXPECT_EQ(expected, cur);
+        expected = (expected == 9999) ? 20000 : expected + 1;
+    }
+}
+
 TEST(BTreeSet, IteratorEmpty) {
     using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
     test_set t;
@@ -476,6 +507,64 @@ TEST(BTreeSet, Load) {
     }
 }
 
+TEST(BTreeSet, LoadFactor) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 64>;
+
+    std::vector<int> data;
+    for (int i = 0; i < 10000; i++) {
+        data.push_back(i);
+    }
+
+    for (double loadFactor : {0.0, 0.5, 0.7, 1.0}) {
+        auto t = test_set::load(data.begin(), data.end(), loadFactor);
+        EXPECT_TRUE(t.check());
+        EXPECT_EQ(data.size(), t.size());
+        EXPECT_TRUE(std::equal(data.begin(), data.end(), t.begin()));
+
+        // lower load factors leave space for subsequent insertions
+        auto full = test_set::load(data.begin(), data.end());
+        EXPECT_TRUE(full.getNumNodes() <= t.getNumNodes());
+    }
+
+    // forward iterators are supported
+    std::set<int> ordered(data.begin(), data.end());
+    auto t = test_set::load(ordered.begin(), ordered.end());
+    EXPECT_TRUE(t.check());
+    EXPECT_EQ(ordered.size(), t.size());
+}
+
+TEST(BTreeSet, InsertSorted) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    for (int N : {0, 1, 10, 1000}) {
+        for (int M : {0, 1, 10, 1000}) {
+            test_set t;
+            std::set<int> should;
+            for (int i = 0; i < N; i++) {
+                t.insert(2 * i);
+                should.insert(2 * i);
+            }
+
+            // overlapping and containing duplicates
+            std::vector<int> run;
+            for (int i = 0; i < M; i++) {
+                run.push_back(3 * i);
+                run.push_back(3 * i);
+                should.insert(3 * i);
+            }
+
+            t.insertSorted(run.begin(), run.end());
+            EXPECT_TRUE(t.check()) << "N=" << N << ", M=" << M;
+            EXPECT_EQ(should.size(), t.size()) << "N=" << N << ", M=" << M;
+            EXPECT_TRUE(std::equal(should.begin(), should.end(), t.begin())) << "N=" << N << ", M=" << M;
+
+            // the tree remains usable
+            t.insert(-1);
+            EXPECT_TRUE(t.contains(-1));
+        }
+    }
+}
+
 TEST(BTreeSet, Clear) {
     using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
 
@@ -493,6 +582,140 @@ TEST(BTreeSet, Clear) {
     EXPECT_TRUE(t.empty());
 }
 
+TEST(BTreeSet, Erase) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+
+    EXPECT_FALSE(t.erase(5));
+
+    int N = 1000;
+
+    for (int i = 0; i < N; i++) {
+        t.insert(i);
+    }
+
+    // remove every second element
+    for (int i = 0; i < N; i += 2) {
+        EXPECT_TRUE(t.erase(i)) << "i=" << i;
+        EXPECT_FALSE(t.erase(i)) << "i=" << i;
+    }
+    EXPECT_TRUE(t.check());
+    EXPECT_EQ((size_t)N / 2, t.size());
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_EQ(i % 2 == 1, t.contains(i)) << "i=" << i;
+    }
+
+    // remove the rest in reverse order
+    for (int i = N - 1; i >= 0; i -= 2) {
+        EXPECT_TRUE(t.erase(i)) << "i=" << i;
+    }
+    EXPECT_TRUE(t.empty());
+    EXPECT_TRUE(t.begin() == t.end());
+
+    // the tree is still usable
+    t.insert(12);
+    EXPECT_TRUE(t.contains(12));
+    EXPECT_EQ(1, t.size());
+}
+
+TEST(BTreeSet, EraseShuffled) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+    std::set<int> should;
+
+    int N = 10000;
+
+    std::vector<int> data;
+    for (int i = 0; i < N; i++) {
+        data.push_back(i);
+    }
+    random_shuffle(data.begin(), data.end());
+
+    for (int i = 0; i < N; i++) {
+        t.insert(data[i]);
+        should.insert(data[i]);
+    }
+
+    random_shuffle(data.begin(), data.end());
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_TRUE(t.erase(data[i]));
+        should.erase(data[i]);
+
+        if (i % 1000 == 0) {
+            EXPECT_TRUE(t.check());
+            EXPECT_EQ(should.size(), t.size());
+            EXPECT_TRUE(std::equal(should.begin(), should.end(), t.begin()));
+        }
+    }
+
+    EXPECT_TRUE(t.empty());
+    t.reclaim();
+}
+
+TEST(BTreeSet, EraseRange) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+
+    int N = 5000;
+
+    for (int i = 0; i < N; i++) {
+        t.insert(i);
+    }
+
+    EXPECT_EQ(0, t.eraseRange(10, 10));
+    EXPECT_EQ(2000, t.eraseRange(1000, 3000));
+    EXPECT_EQ(0, t.eraseRange(1000, 3000));
+    EXPECT_TRUE(t.check());
+    EXPECT_EQ((size_t)N - 2000, t.size());
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_EQ(i < 1000 || i >= 3000, t.contains(i)) << "i=" << i;
+    }
+
+    EXPECT_EQ((size_t)N - 2000, t.eraseRange(-1, N));
+    EXPECT_TRUE(t.empty());
+}
+
+TEST(BTreeSet, EraseSorted) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+
+    test_set t;
+    test_set other;
+
+    int N = 5000;
+
+    std::vector<int> data;
+    for (int i = 0; i < N; i++) {
+        t.insert(i);
+        if (i % 3 == 0) {
+            data.push_back(i);
+        }
+        if (i % 3 == 1) {
+            other.insert(i);
+        }
+    }
+
+    // includes elements not present in the tree
+    data.push_back(N + 5);
+
+    EXPECT_EQ(data.size() - 1, t.eraseSorted(data.begin(), data.end()));
+    EXPECT_TRUE(t.check());
+    EXPECT_EQ(other.size(), t.eraseAll(other));
+    EXPECT_TRUE(t.check());
+
+    for (int i = 0; i < N; i++) {
+        EXPECT_EQ(i % 3 == 2, t.contains(i)) << "i=" << i;
+    }
+
+    EXPECT_EQ(t.size(), t.eraseAll(t));
+    EXPECT_TRUE(t.empty());
+}
+
 TEST(BTreeSet, ChunkSplit) {
     using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
 
@@ -785,6 +1008,66 @@ TEST(BTreeSet, Parallel) {
     }
 }
 
+TEST(BTreeSet, ParallelErase) {
+    using test_set = btree_set<int, detail::comparator<int>, std::allocator<int>, 16>;
+    using op_context_type = test_set::operation_hints;
+
+    const int N = 100000;
+
+    std::vector<int> data;
+    for (int i = 0; i < N; i++) {
+        data.push_back(i);
+    }
+    random_shuffle(data.begin(), data.end());
+
+    test_set t;
+    for (int i = 0; i < N; i++) {
+        t.insert(i);
+    }
+
+    // concurrently remove all odd elements and insert new ones
+#pragma omp parallel
+    {
+        op_context_type ctxt;
+
+#pragma omp for
+        for (int i = 0; i < N; i++) {
+            if (data[i] % 2 == 1) {
+                t.erase(data[i], ctxt);
+            }
+            t.insert(N + data[i], ctxt);
+        }
+    }
+
+    EXPECT_TRUE(t.check());
+    EXPECT_EQ(N + N / 2, t.size());
+
+    int count = 0;
+    int last = -2;
+    for (int i : t) {
+        EXPECT_EQ((i < N) ? last + 2 : std::max(N, last + 1), i);
+        last = i;
+        count++;
+    }
+    EXPECT_EQ(N + N / 2, count);
+    EXPECT_EQ(2 * N - 1, last);
+
+    // concurrently remove everything again
+#pragma omp parallel
+    {
+        op_context_type ctxt;
+
+#pragma omp for
+        for (int i = 0; i < N; i++) {
+            t.erase(N + data[i], ctxt);
+            t.erase(data[i], ctxt);
+        }
+    }
+
+    EXPECT_TRUE(t.empty());
+    EXPECT_TRUE(t.begin() == t.end());
+}
+
 #ifdef _OPENMP
 
 TEST(BTreeSet, ParallelScaling) {
@@ -18,6 +18,9 @@
 
 #include "CompiledRelation.h"
 
+#include <limits>
+#include <vector>
+
 namespace souffle {
 namespace ram {
 
@@ -174,5 +177,96 @@ TEST(IndicesTools, GetPrefix) {
     EXPECT_EQ(typeid(index<0, 1, 3, 2>), typeid(index_utils::get_prefix<4, index<0, 1, 3, 2>>::type));
 }
 
+namespace {
+
+// compares the SIMD search within a node with a linear search for all keys of a small domain
+template <unsigned arity, unsigned... Columns>
+bool checkSimdSearch() {
+    using tuple = Tuple<int32_t, arity>;
+    using comp = index_utils::comparator<Columns...>;
+    comp c;
+
+    // a sorted array of tuples covering the domain {0,..,3}^arity with some duplicates
+    std::vector<tuple> data;
+    for (unsigned i = 0; i < (1u << (2 * arity)); i += 3) {
+        tuple t;
+        for (unsigned j = 0; j < arity; ++j) {
+            t[j] = (i >> (2 * j)) & 3;
+        }
+        data.push_back(t);
+        data.push_back(t);
+    }
+    std::sort(data.begin(), data.end(), [&](const tuple& a, const tuple& b) { return c.less(a, b); });
+
+    souffle::detail::simd_search search;
+    for (unsigned i = 0; i < (1u << (2 * arity)); ++i) {
+        tuple k;
+        for (unsigned j = 0; j < arity; ++j) {
+            k[j] = (i >> (2 * j)) & 3;
+        }
+        for (std::size_t len = 0; len <= data.size(); ++len) {
+            auto a = data.begin();
+            auto b = data.begin() + len;
+            auto lower = std::find_if(a, b, [&](const tuple& t) { return c(t, k) >= 0; });
+            auto upper = std::find_if(a, b, [&](const tuple& t) { return c(t, k) > 0; });
+            if (lower != search.lower_bound(k, a, b, c) || upper != search.upper_bound(k, a, b, c)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(SimdSearch, Selection) {
+    using namespace souffle::detail;
+    EXPECT_EQ(typeid(simd_search), typeid(default_strategy<Tuple<int32_t, 1>>::type));
+    EXPECT_EQ(typeid(simd_search), typeid(default_strategy<Tuple<int32_t, 4>>::type));
+    EXPECT_EQ(typeid(binary_search), typeid(default_strategy<Tuple<int32_t, 5>>::type));
+    EXPECT_EQ(typeid(binary_search), typeid(default_strategy<Tuple<int64_t, 2>>::type));
+
+    EXPECT_TRUE((is_simd_searchable<Tuple<int32_t, 2>, index_utils::comparator<1, 0>>::value));
+    EXPECT_FALSE((is_simd_searchable<Tuple<int32_t, 2>, index_utils::comparator<>>::value));
+    EXPECT_FALSE((is_simd_searchable<Tuple<int64_t, 2>, index_utils::comparator<0, 1>>::value));
+    EXPECT_FALSE((is_simd_searchable<int, index_utils::comparator<0>>::value));
+}
+
+TEST(SimdSearch, Search) {
+    EXPECT_TRUE((checkSimdSearch<1, 0>()));
+    EXPECT_TRUE((checkSimdSearch<2, 0, 1>()));
+    EXPECT_TRUE((checkSimdSearch<2, 1, 0>()));
+    EXPECT_TRUE((checkSimdSearch<3, 2, 0, 1>()));
+    EXPECT_TRUE((checkSimdSearch<3, 1>()));
+    EXPECT_TRUE((checkSimdSearch<4, 0, 1, 2, 3>()));
+    EXPECT_TRUE((checkSimdSearch<4, 3, 2>()));
+}
+
+TEST(SimdSearch, ExtremeValues) {
+    using tuple = Tuple<int32_t, 2>;
+    index_utils::comparator<0, 1> c;
+    const int32_t min = std::numeric_limits<int32_t>::min();
+    const int32_t max = std::numeric_limits<int32_t>::max();
+
+    // leading values at the limits of the domain, with runs of equal leading values
+    std::vector<tuple> data;
+    for (int32_t lead : {min, 0, max}) {
+        for (int32_t i = 0; i < 20; ++i) {
+            data.push_back(tuple({{lead, i}}));
+        }
+    }
+
+    souffle::detail::simd_search search;
+    for (int32_t lead : {min, 0, max}) {
+        for (int32_t i = -1; i <= 20; ++i) {
+            tuple k({{lead, i}});
+            auto lower = std::find_if(data.begin(), data.end(), [&](const tuple& t) { return c(t, k) >= 0; });
+            auto upper = std::find_if(data.begin(), data.end(), [&](const tuple& t) { return c(t, k) > 0; });
+            EXPECT_TRUE(lower == search.lower_bound(k, data.begin(), data.end(), c));
+            EXPECT_TRUE(upper == search.upper_bound(k, data.begin(), data.end(), c));
+        }
+    }
+}
+
 }  // namespace ram
 }  // end namespace souffle
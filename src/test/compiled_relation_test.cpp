@@ -871,5 +871,134 @@ TEST(Relation, PartitionBug_InsertAll) {
     EXPECT_EQ(all, is);
 }
 
+TEST(HashSet, Basic) {
+    using tuple_type = Tuple<RamDomain, 2>;
+    using set_type =
+            hash_set<tuple_type, detail::tuple_hasher<index<0, 1>>, detail::tuple_equal<index<0, 1>>>;
+
+    set_type set;
+    EXPECT_TRUE(set.empty());
+    EXPECT_TRUE(set.begin() == set.end());
+
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(set.insert(tuple_type({{i % 10, i}})));
+    }
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_FALSE(set.insert(tuple_type({{i % 10, i}})));
+    }
+    EXPECT_EQ(1000, set.size());
+
+    EXPECT_TRUE(set.contains(tuple_type({{3, 13}})));
+    EXPECT_FALSE(set.contains(tuple_type({{3, 14}})));
+    EXPECT_TRUE(set.find(tuple_type({{3, 14}})) == set.end());
+    EXPECT_EQ((tuple_type({{3, 13}})), *set.find(tuple_type({{3, 13}})));
+
+    std::set<tuple_type> all(set.begin(), set.end());
+    EXPECT_EQ(1000, all.size());
+
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.contains(tuple_type({{3, 13}})));
+}
+
+TEST(HashSet, EqualRange) {
+    using tuple_type = Tuple<RamDomain, 2>;
+    using set_type = hash_multiset<tuple_type, detail::tuple_hasher<index<1>>, detail::tuple_equal<index<1>>>;
+
+    set_type set;
+    for (int i = 0; i < 1000; i++) {
+        set.insert(tuple_type({{i, i % 7}}));
+    }
+    EXPECT_EQ(1000, set.size());
+
+    // only tuples matching the key on the indexed column are enumerated
+    for (int k = 0; k < 8; k++) {
+        std::set<tuple_type> matches;
+        for (const auto& cur : set.equal_range(tuple_type({{0, k}}))) {
+            EXPECT_EQ(k, cur[1]);
+            matches.insert(cur);
+        }
+        EXPECT_EQ((size_t)((k < 7) ? (1000 - k + 6) / 7 : 0), matches.size());
+    }
+    EXPECT_TRUE(set.equal_range(tuple_type({{0, 7}})).empty());
+}
+
+TEST(HashSet, Partition) {
+    using tuple_type = Tuple<RamDomain, 2>;
+    using set_type = hash_multiset<tuple_type, detail::tuple_hasher<index<0>>, detail::tuple_equal<index<0>>>;
+
+    set_type set;
+    EXPECT_TRUE(set.partition(100).empty());
+
+    for (int i = 0; i < 10000; i++) {
+        set.insert(tuple_type({{i % 100, i}}));
+    }
+
+    std::set<tuple_type> all;
+    auto part = set.partition(400);
+    EXPECT_TRUE(part.size() <= 400);
+    for (const auto& p : part) {
+        EXPECT_FALSE(p.empty());
+        for (const auto& cur : p) {
+            EXPECT_TRUE(all.insert(cur).second) << "Duplicate: " << cur;
+        }
+    }
+    EXPECT_EQ(10000, all.size());
+}
+
+TEST(HashSet, ParallelInsert) {
+    using tuple_type = Tuple<RamDomain, 2>;
+    using set_type =
+            hash_set<tuple_type, detail::tuple_hasher<index<0, 1>>, detail::tuple_equal<index<0, 1>>>;
+    using multiset_type =
+            hash_multiset<tuple_type, detail::tuple_hasher<index<1>>, detail::tuple_equal<index<1>>>;
+
+    const int N = 100000;
+
+    set_type set;
+    multiset_type multiset;
+    std::atomic<int> inserted(0);
+
+    // every tuple is inserted twice, only one of the insertions succeeds
+#pragma omp parallel for
+    for (int i = 0; i < 2 * N; i++) {
+        tuple_type cur({{i % N, (i % N) % 100}});
+        if (set.insert(cur)) {
+            multiset.insert(cur);
+            inserted++;
+        }
+    }
+
+    EXPECT_EQ(N, inserted);
+    EXPECT_EQ(N, set.size());
+    EXPECT_EQ(N, multiset.size());
+
+    int count = 0;
+    for (const auto& cur : multiset.equal_range(tuple_type({{0, 42}}))) {
+        EXPECT_EQ(42, cur[1]);
+        count++;
+    }
+    EXPECT_EQ(N / 100, count);
+}
+
+TEST(HashSet, ParallelGrowth) {
+    using tuple_type = Tuple<RamDomain, 1>;
+    using set_type = hash_set<tuple_type, detail::tuple_hasher<index<0>>, detail::tuple_equal<index<0>>>;
+
+    // tables filled concurrently from their initial capacity retain all keys
+    set_type set;
+    for (int round = 0; round < 100; round++) {
+        set.clear();
+#pragma omp parallel for
+        for (int i = 0; i < 1000; i++) {
+            set.insert(tuple_type({{i}}));
+        }
+        EXPECT_EQ(1000, set.size());
+        for (int i = 0; i < 1000; i++) {
+            EXPECT_TRUE(set.contains(tuple_type({{i}})));
+        }
+    }
+}
+
 }  // namespace ram
 }  // end namespace souffle
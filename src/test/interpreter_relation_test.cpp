@@ -0,0 +1,218 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file interpreter_relation_test.cpp
+ *
+ * Test cases for the relations and indexes of the interpreter.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "InterpreterRelation.h"
+
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+TEST(InterpreterHashIndex, Basic) {
+    std::vector<RamDomain> tuples = {1, 2, 3, 1, 2, 4, 3, 2, 1};
+    InterpreterTupleArena arena(3);
+    for (size_t i = 0; i < tuples.size() / 3; i++) {
+        arena.store(i, tuples.data() + i * 3);
+    }
+    InterpreterHashIndex index(arena);
+
+    RamDomain a[] = {1, 2, 3};
+    RamDomain b[] = {1, 2, 4};
+    EXPECT_FALSE(index.exists(a));
+
+    index.insert(0);
+    EXPECT_TRUE(index.exists(a));
+    EXPECT_FALSE(index.exists(b));
+
+    // the table grows while retaining all tuples
+    for (size_t i = 1; i < tuples.size() / 3; i++) {
+        index.insert(i);
+    }
+    EXPECT_TRUE(index.exists(a));
+    EXPECT_TRUE(index.exists(b));
+
+    index.purge();
+    EXPECT_FALSE(index.exists(a));
+    EXPECT_FALSE(index.exists(b));
+}
+
+TEST(InterpreterIndex, Erase) {
+    // tuples sharing their first column are equal for an index on it
+    InterpreterTupleArena arena(2);
+    for (RamDomain i = 0; i < 1000; i++) {
+        RamDomain tuple[] = {i % 10, i};
+        arena.store(i, tuple);
+    }
+    InterpreterIndex index(InterpreterIndexOrder({0}), arena);
+    index.insert(0, 1000);
+
+    for (size_t i = 0; i < 1000; i += 2) {
+        EXPECT_TRUE(index.erase(i));
+    }
+    EXPECT_FALSE(index.erase(0));
+    index.reclaim();
+
+    // exactly the tuples of odd ordinals remain
+    for (RamDomain key = 0; key < 10; key++) {
+        RamDomain value[] = {key, 0};
+        auto range = index.equalRange(value);
+        size_t count = 0;
+        for (auto it = range.first; it != range.second; ++it) {
+            EXPECT_EQ(key, (*it)[0]);
+            EXPECT_EQ(1, (*it)[1] % 2);
+            count++;
+        }
+        EXPECT_EQ(key % 2 == 1 ? 100 : 0, count);
+    }
+}
+
+TEST(InterpreterTupleArena, Stable) {
+    InterpreterTupleArena arena(3);
+    std::vector<const RamDomain*> stored;
+
+    // tuples keep their address while the arena allocates further blocks
+    for (RamDomain i = 0; i < 100000; i++) {
+        RamDomain tuple[] = {i, i + 1, i + 2};
+        arena.store(i, tuple);
+        stored.push_back(arena.get(i));
+    }
+    for (RamDomain i = 0; i < 100000; i++) {
+        EXPECT_EQ(stored[i], arena.get(i));
+        EXPECT_EQ(i + 2, stored[i][2]);
+    }
+}
+
+TEST(InterpreterRelation, HashedDuplicates) {
+    InterpreterRelation hashed(2, true);
+    InterpreterRelation plain(2);
+
+    // insert each tuple twice
+    for (RamDomain i = 0; i < 2000; i++) {
+        RamDomain tuple[] = {i % 1000, (i % 1000) * 7};
+        hashed.insert(tuple);
+        plain.insert(tuple);
+    }
+    EXPECT_EQ(1000, hashed.size());
+    EXPECT_EQ(plain.size(), hashed.size());
+
+    for (RamDomain i = 0; i < 1000; i++) {
+        RamDomain tuple[] = {i, i * 7};
+        RamDomain missing[] = {i, i * 7 + 1};
+        EXPECT_TRUE(hashed.exists(tuple));
+        EXPECT_FALSE(hashed.exists(missing));
+    }
+}
+
+TEST(InterpreterRelation, HashedRangeQuery) {
+    InterpreterRelation rel(2, true);
+    for (RamDomain i = 0; i < 100; i++) {
+        for (RamDomain j = 0; j < 10; j++) {
+            rel.insert(i, j);
+        }
+    }
+
+    // range queries create an ordered index on demand
+    RamDomain low[] = {42, MIN_RAM_DOMAIN};
+    RamDomain high[] = {42, MAX_RAM_DOMAIN};
+    auto range = rel.getIndex(1)->lowerUpperBound(low, high);
+    size_t count = 0;
+    for (auto it = range.first; it != range.second; ++it) {
+        EXPECT_EQ(42, (*it)[0]);
+        count++;
+    }
+    EXPECT_EQ(10, count);
+
+    // the index covers tuples inserted later
+    rel.insert(42, 100);
+    range = rel.getIndex(1)->lowerUpperBound(low, high);
+    count = 0;
+    for (auto it = range.first; it != range.second; ++it) {
+        count++;
+    }
+    EXPECT_EQ(11, count);
+}
+
+TEST(InterpreterRelation, HashedMerge) {
+    InterpreterRelation rel(2, true);
+    InterpreterRelation other(2, true);
+    for (RamDomain i = 0; i < 100; i++) {
+        rel.insert(i, i);
+        other.insert(i + 50, i + 50);
+    }
+
+    rel.insert(other);
+    EXPECT_EQ(150, rel.size());
+    for (RamDomain i = 0; i < 150; i++) {
+        RamDomain tuple[] = {i, i};
+        EXPECT_TRUE(rel.exists(tuple));
+    }
+
+    // purged relations can be filled again
+    rel.purge();
+    EXPECT_TRUE(rel.empty());
+    RamDomain tuple[] = {7, 7};
+    EXPECT_FALSE(rel.exists(tuple));
+    rel.insert(tuple);
+    rel.insert(tuple);
+    EXPECT_EQ(1, rel.size());
+    EXPECT_TRUE(rel.exists(tuple));
+}
+
+TEST(InterpreterRelation, InsertRows) {
+    // rows with duplicates among them and with tuples stored already
+    std::vector<RamDomain> rows;
+    for (RamDomain i = 0; i < 3000; i++) {
+        rows.push_back((i * 7) % 1000);
+        rows.push_back(i % 3);
+    }
+    std::vector<RamDomain> again(rows.begin(), rows.begin() + 2000);
+    rows.insert(rows.end(), again.begin(), again.end());
+
+    for (bool hashed : {false, true}) {
+        InterpreterRelation rel(2, hashed);
+        rel.insertRows(rows.data(), 1500);
+        EXPECT_EQ(1500, rel.size());
+
+        // the index created once the relation is searched holds all tuples
+        RamDomain low[] = {7, MIN_RAM_DOMAIN};
+        RamDomain high[] = {7, MAX_RAM_DOMAIN};
+        auto range = rel.getIndex(1)->lowerUpperBound(low, high);
+        size_t count = 0;
+        for (auto it = range.first; it != range.second; ++it) {
+            count++;
+        }
+        EXPECT_EQ(2, count);
+
+        rel.insertRows(rows.data(), 4000);
+        EXPECT_EQ(3000, rel.size());
+        range = rel.getIndex(1)->lowerUpperBound(low, high);
+        count = 0;
+        for (auto it = range.first; it != range.second; ++it) {
+            count++;
+        }
+        EXPECT_EQ(3, count);
+        for (RamDomain i = 0; i < 3000; i++) {
+            RamDomain tuple[] = {(i * 7) % 1000, i % 3};
+            EXPECT_TRUE(rel.exists(tuple));
+        }
+    }
+}
+
+}  // end namespace test
+}  // end namespace souffle
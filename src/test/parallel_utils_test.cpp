@@ -17,6 +17,8 @@
 #include "ParallelUtils.h"
 #include "test.h"
 
+#include <vector>
+
 namespace souffle {
 
 namespace test {
@@ -91,5 +93,57 @@ TEST(ParallelUtils, OptimisticReadWriteLock) {
 
     EXPECT_EQ(2 * (N / K), c);
 }
+
+TEST(ParallelUtils, TaskGraph) {
+    const int N = 10000;
+
+    std::vector<int> a(N, 1);
+    std::vector<int> b(N, 0);
+    std::vector<int> c(N, 0);
+    long sum = 0;
+
+    // tasks are ordered by their dependencies only
+    char dependencies[2];
+    (void)dependencies;
+    TASKS_START;
+    TASK_START(depend(inout : dependencies[0]));
+    {
+        PARALLEL_START;
+        pfor(int i = 0; i < N; i++) {
+            b[i] = 2 * a[i];
+        }
+        PARALLEL_END;
+    }
+    TASK_END
+    TASK_START(depend(in : dependencies[0]) depend(inout : dependencies[1]));
+    {
+        // sections share the threads of the task graph
+        SECTIONS_START;
+        SECTION_START;
+        for (int i = 0; i < N / 2; i++) {
+            c[i] = b[i] + 1;
+        }
+        SECTION_END
+        SECTION_START;
+        PARALLEL_START;
+        pfor(int i = N / 2; i < N; i++) {
+            c[i] = b[i] + 1;
+        }
+        PARALLEL_END;
+        SECTION_END
+        SECTIONS_END;
+    }
+    TASK_END
+    TASK_START(depend(in : dependencies[1]));
+    {
+        for (int i = 0; i < N; i++) {
+            sum += c[i];
+        }
+    }
+    TASK_END
+    TASKS_END
+
+    EXPECT_EQ(3 * N, sum);
+}
 }  // namespace test
 }  // end namespace souffle
@@ -0,0 +1,80 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file profile_event_test.cpp
+ *
+ * Test cases for the counters of profile events.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "ProfileEvent.h"
+
+namespace souffle {
+
+namespace test {
+
+TEST(SelectivityCounters, Parallel) {
+    const int N = 1000000;
+    SelectivityCounters counters(3);
+
+    // every thread counts into counters of its own
+#pragma omp parallel for num_threads(4)
+    for (int i = 0; i < N; i++) {
+        counters.count(i % 3, SelectivityCounters::SEARCHES);
+        counters.count(i % 3, SelectivityCounters::VISITED, 2);
+        if (i % 2 == 0) {
+            counters.count(i % 3, SelectivityCounters::HITS);
+        }
+    }
+
+    size_t searches = 0;
+    size_t hits = 0;
+    for (size_t search = 0; search < 3; search++) {
+        searches += counters.get(search, SelectivityCounters::SEARCHES);
+        hits += counters.get(search, SelectivityCounters::HITS);
+        EXPECT_EQ(2 * counters.get(search, SelectivityCounters::SEARCHES),
+                counters.get(search, SelectivityCounters::VISITED));
+        EXPECT_EQ((size_t)0, counters.get(search, SelectivityCounters::PASSED));
+    }
+    EXPECT_EQ((size_t)(N + 2) / 3, counters.get(0, SelectivityCounters::SEARCHES));
+    EXPECT_EQ((size_t)N, searches);
+    EXPECT_EQ((size_t)N / 2, hits);
+}
+
+TEST(SelectivityCounters, SeveralSets) {
+    const int N = 100000;
+    SelectivityCounters first(1);
+    SelectivityCounters second(2);
+
+    // threads switch between the counters of both sets
+#pragma omp parallel for num_threads(4)
+    for (int i = 0; i < N; i++) {
+        first.count(0, SelectivityCounters::PASSED);
+        second.count(i % 2, SelectivityCounters::PASSED);
+        first.count(0, SelectivityCounters::SEARCHES);
+    }
+    EXPECT_EQ((size_t)N, first.get(0, SelectivityCounters::PASSED));
+    EXPECT_EQ((size_t)N, first.get(0, SelectivityCounters::SEARCHES));
+    EXPECT_EQ((size_t)N / 2, second.get(0, SelectivityCounters::PASSED));
+    EXPECT_EQ((size_t)N / 2, second.get(1, SelectivityCounters::PASSED));
+
+    // a new set of counters starts from zero, even if it reuses the memory of an earlier one
+    for (int i = 0; i < 10; i++) {
+        SelectivityCounters counters(1);
+        EXPECT_EQ((size_t)0, counters.get(0, SelectivityCounters::SEARCHES));
+        counters.count(0, SelectivityCounters::SEARCHES);
+        EXPECT_EQ((size_t)1, counters.get(0, SelectivityCounters::SEARCHES));
+    }
+}
+
+}  // end namespace test
+}  // end namespace souffle
@@ -0,0 +1,151 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file profile_use_test.cpp
+ *
+ * Test cases for the optimisations guided by the profile of a previous run.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "AstTranslationUnit.h"
+#include "AstTranslator.h"
+#include "Global.h"
+#include "ParserDriver.h"
+#include "ProfileUse.h"
+#include "RamOperation.h"
+#include "RamRelation.h"
+#include "RamTranslationUnit.h"
+#include "RamVisitor.h"
+#include "SymbolTable.h"
+
+// defines macros clashing with the tokens of the parser
+#include "IndexSetAnalysis.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace souffle {
+
+namespace test {
+
+/** Use the profile of a previous run, recording the sizes of the relations of all tests */
+const ProfileUse* useProfile() {
+    static bool read = false;
+    if (read) {
+        return ProfileUse::getInstance();
+    }
+    read = true;
+
+    char fileName[] = "/tmp/souffle_profile_XXXXXX";
+    close(mkstemp(fileName));
+    std::ofstream(fileName) << R"({"root": {"program": {"relation": {
+            "tiny": {"num-tuples": 10},
+            "edge": {"num-tuples": 5000},
+            "pair": {"num-tuples": 5000},
+            "triple": {"num-tuples": 5000},
+            "big": {"num-tuples": 100000},
+            "mid": {"num-tuples": 1000},
+            "small": {"num-tuples": 10}
+    }}}})";
+    Global::config().set("profile-use", fileName);
+
+    // the profile is read once, on first use
+    const ProfileUse* profile = ProfileUse::getInstance();
+    std::remove(fileName);
+    return profile;
+}
+
+TEST(ProfileUse, Representations) {
+    EXPECT_TRUE(useProfile() != nullptr);
+
+    SymbolTable sym;
+    ErrorReport e;
+    DebugReport d;
+    std::unique_ptr<AstTranslationUnit> tu = ParserDriver::parseTranslationUnit(
+            R"(
+                .decl tiny(a:number)
+                .decl edge(a:number, b:number)
+                .decl pair(a:number, b:number)
+                .decl triple(a:number, b:number, c:number)
+                .decl r1(a:number, b:number)
+                .decl r2(a:number, b:number)
+                .decl r3(a:number, b:number)
+                r1(x, y) :- tiny(x), edge(x, y).
+                r2(x, y) :- tiny(x), pair(x, y), pair(y, x).
+                r3(z, w) :- tiny(x), triple(x, y, z), triple(x, y, w).
+            )",
+            sym, e, d);
+    std::unique_ptr<RamTranslationUnit> ramTu = AstTranslator().translateUnit(*tu);
+    auto* analysis = ramTu->getAnalysis<IndexSetAnalysis>();
+    auto getRepresentation = [&](const std::string& name, unsigned arity) {
+        return analysis->getIndexes(RamRelation(name, arity, false)).getRepresentation();
+    };
+
+    // a single search is answered by a hash set
+    EXPECT_EQ("hashset", getRepresentation("edge", 2));
+
+    // searches sharing a prefix need an ordered data structure
+    EXPECT_EQ("brie", getRepresentation("pair", 2));
+    EXPECT_EQ("btree", getRepresentation("triple", 3));
+
+    // small relations and relations missing from the profile keep their default data structure
+    EXPECT_EQ("", getRepresentation("tiny", 1));
+    EXPECT_EQ("", getRepresentation("r1", 2));
+}
+
+TEST(ProfileUse, AtomOrder) {
+    EXPECT_TRUE(useProfile() != nullptr);
+
+    SymbolTable sym;
+    ErrorReport e;
+    DebugReport d;
+    std::unique_ptr<AstTranslationUnit> tu = ParserDriver::parseTranslationUnit(
+            R"(
+                .decl big(a:number, b:number)
+                .decl mid(a:number, b:number)
+                .decl small(a:number)
+                .decl other(a:number, b:number)
+                .decl r1(a:number, b:number)
+                .decl r2(a:number, b:number)
+                .decl r3(a:number, b:number)
+                r1(x, z) :- big(x, y), mid(y, z), small(x).
+                r2(x, z) :- big(x, y), mid(y, z), small(x). .strict
+                r3(x, z) :- big(x, y), other(y, z), small(x).
+            )",
+            sym, e, d);
+    AstProgram& program = *tu->getProgram();
+
+    // get the relations scanned by the translation of a clause, from the outermost loop inwards
+    auto getScans = [&](const std::string& name) {
+        const AstClause& clause = *program.getRelation(name)->getClause(0);
+        std::unique_ptr<RamStatement> stmt =
+                AstTranslator().translateClause(clause, nullptr, nullptr, clause);
+        std::vector<std::string> scans;
+        visitDepthFirst(*stmt, [&](const RamScan& scan) { scans.push_back(scan.getRelation().getName()); });
+        return scans;
+    };
+
+    // the smallest relation is scanned first, then the one with the fewest matches per bound value
+    EXPECT_EQ(toString(std::vector<std::string>({"small", "big", "mid"})), toString(getScans("r1")));
+
+    // clauses with a strict order and clauses of relations missing from the profile keep their order
+    EXPECT_EQ(toString(std::vector<std::string>({"big", "mid", "small"})), toString(getScans("r2")));
+    EXPECT_EQ(toString(std::vector<std::string>({"big", "other", "small"})), toString(getScans("r3")));
+}
+
+}  // end namespace test
+}  // end namespace souffle
@@ -0,0 +1,144 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file read_stream_csv_test.cpp
+ *
+ * Test cases comparing the memory-mapped CSV reader with the stream reader.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "IODirectives.h"
+#include "ReadStreamCSV.h"
+#include "SymbolMask.h"
+#include "SymbolTable.h"
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace souffle {
+
+namespace test {
+
+/** A relation collecting the tuples read, in the order of reading */
+struct TupleList {
+    size_t arity;
+    std::vector<std::vector<RamDomain>> tuples;
+
+    TupleList(size_t arity) : arity(arity) {}
+
+    void insert(const RamDomain* tuple) {
+        tuples.push_back(std::vector<RamDomain>(tuple, tuple + arity));
+    }
+};
+
+/** A fact file with the given content, removed at the end of the test */
+class TempFactFile {
+    std::string name;
+
+public:
+    TempFactFile(const std::string& content) {
+        char pattern[] = "/tmp/souffle_csv_XXXXXX";
+        int fd = mkstemp(pattern);
+        close(fd);
+        name = pattern;
+        std::ofstream(name) << content;
+    }
+
+    ~TempFactFile() {
+        std::remove(name.c_str());
+    }
+
+    const std::string& getName() const {
+        return name;
+    }
+};
+
+/** Read a fact file of three columns, the second of them symbols, with or without mapping it */
+void readFacts(const std::string& fileName, bool mapped, SymbolTable& symbolTable, TupleList& res) {
+    SymbolMask mask({false, true, false});
+    std::map<std::string, std::string> directives = {{"IO", "file"}, {"filename", fileName}};
+    if (mapped) {
+        directives["mmap"] = "true";
+    }
+    ReadFileCSVFactory().getReader(mask, symbolTable, IODirectives(directives), false)->readAll(res);
+}
+
+TEST(ReadMappedFileCSV, SameAsStream) {
+    // large enough to be split up into several chunks
+    std::string content;
+    for (int i = 0; i < 200000; i++) {
+        content += std::to_string(i - 100) + "\tsym" + std::to_string(i % 997) + "\t" +
+                   std::to_string(i * 3) + (i % 10 == 0 ? "\r\n" : "\n");
+    }
+    TempFactFile file(content);
+
+    SymbolTable streamSymbols;
+    SymbolTable mappedSymbols;
+    TupleList streamTuples(3);
+    TupleList mappedTuples(3);
+    readFacts(file.getName(), false, streamSymbols, streamTuples);
+    readFacts(file.getName(), true, mappedSymbols, mappedTuples);
+
+    EXPECT_EQ(200000, streamTuples.tuples.size());
+    EXPECT_EQ(streamTuples.tuples.size(), mappedTuples.tuples.size());
+    EXPECT_EQ(streamSymbols.size(), mappedSymbols.size());
+
+    // symbols are interned in the order of the file
+    EXPECT_TRUE(streamTuples.tuples == mappedTuples.tuples);
+    EXPECT_EQ(-100, mappedTuples.tuples[0][0]);
+    EXPECT_EQ("sym5", mappedSymbols.resolve(mappedTuples.tuples[5][1]));
+    EXPECT_EQ(3 * 199999, mappedTuples.tuples[199999][2]);
+}
+
+TEST(ReadMappedFileCSV, EmptyFile) {
+    TempFactFile file("");
+    SymbolTable symbols;
+    TupleList tuples(3);
+    readFacts(file.getName(), true, symbols, tuples);
+    EXPECT_EQ(0, tuples.tuples.size());
+}
+
+TEST(ReadMappedFileCSV, Errors) {
+    TempFactFile file("1\ta\t2\n3\tb\tx\n");
+
+    std::string streamError;
+    std::string mappedError;
+    SymbolTable streamSymbols;
+    SymbolTable mappedSymbols;
+    TupleList streamTuples(3);
+    TupleList mappedTuples(3);
+    try {
+        readFacts(file.getName(), false, streamSymbols, streamTuples);
+    } catch (std::exception& e) {
+        streamError = e.what();
+    }
+    try {
+        readFacts(file.getName(), true, mappedSymbols, mappedTuples);
+    } catch (std::exception& e) {
+        mappedError = e.what();
+    }
+
+    EXPECT_NE("", mappedError);
+    EXPECT_EQ(streamError, mappedError);
+
+    // tuples before the invalid line are read
+    EXPECT_EQ(1, streamTuples.tuples.size());
+    EXPECT_TRUE(streamTuples.tuples == mappedTuples.tuples);
+}
+
+}  // end namespace test
+}  // end namespace souffle
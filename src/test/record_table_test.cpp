@@ -0,0 +1,88 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file record_table_test.cpp
+ *
+ * Test cases for the storage of records.
+ *
+ ***********************************************************************/
+
+#include "CompiledRecord.h"
+#include "RecordTable.h"
+#include "test.h"
+
+#include <vector>
+
+namespace souffle {
+
+namespace test {
+
+TEST(RecordMap, Basic) {
+    RecordMap map(3);
+
+    RamDomain a[] = {1, 2, 3};
+    RamDomain b[] = {1, 2, 4};
+
+    RamDomain refA = map.pack(a);
+    RamDomain refB = map.pack(b);
+
+    // references are unique and never the Nil element
+    EXPECT_NE(0, refA);
+    EXPECT_NE(refA, refB);
+    EXPECT_EQ(refA, map.pack(a));
+    EXPECT_EQ(2, map.size());
+
+    const RamDomain* tuple = map.unpack(refB);
+    EXPECT_EQ(1, tuple[0]);
+    EXPECT_EQ(2, tuple[1]);
+    EXPECT_EQ(4, tuple[2]);
+}
+
+TEST(RecordMap, Compiled) {
+    using tuple_type = ram::Tuple<RamDomain, 2>;
+    tuple_type t = {{7, 8}};
+
+    RamDomain ref = pack(t);
+    EXPECT_EQ(ref, pack(t));
+    EXPECT_EQ(t, unpack<tuple_type>(ref));
+
+    // compiled and interpreted records of the same arity share their storage
+    RamDomain data[] = {7, 8};
+    EXPECT_EQ(ref, getRecordMap(2).pack(data));
+}
+
+TEST(RecordMap, Parallel) {
+    const int N = 100000;
+    RecordMap map(2);
+    std::vector<RamDomain> refs(N);
+
+    // pack overlapping sets of records from several threads
+#pragma omp parallel for
+    for (int i = 0; i < 4 * N; ++i) {
+        RamDomain tuple[] = {i % N, -(i % N)};
+        RamDomain ref = map.pack(tuple);
+        if (i < N) {
+            refs[i] = ref;
+        }
+    }
+    EXPECT_EQ(N, map.size());
+
+    // references remain valid and unique
+    int numValid = 0;
+    for (int i = 0; i < N; ++i) {
+        const RamDomain* tuple = map.unpack(refs[i]);
+        numValid += (tuple[0] == i && tuple[1] == -i) ? 1 : 0;
+    }
+    EXPECT_EQ(N, numValid);
+}
+
+}  // namespace test
+
+}  // end of namespace souffle
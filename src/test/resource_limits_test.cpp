@@ -0,0 +1,159 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file resource_limits_test.cpp
+ *
+ * Test cases for the limits on the tuples of relations and on the time of strata.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include "AstTranslationUnit.h"
+#include "AstTranslator.h"
+#include "Global.h"
+#include "Interpreter.h"
+#include "ParserDriver.h"
+#include "RamTranslationUnit.h"
+#include "ResourceLimits.h"
+#include "SymbolTable.h"
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace souffle {
+
+namespace test {
+
+/** Evaluate a program with the interpreter, returning the message of an exceeded limit, if any */
+std::string interpret(const std::string& program, const std::string& tupleLimit, const std::string& timeout) {
+    Global::config().set("jobs", "1");
+    Global::config().unset("tuple-limit");
+    Global::config().unset("stratum-timeout");
+    if (!tupleLimit.empty()) {
+        Global::config().set("tuple-limit", tupleLimit);
+    }
+    if (!timeout.empty()) {
+        Global::config().set("stratum-timeout", timeout);
+    }
+
+    SymbolTable sym;
+    ErrorReport e;
+    DebugReport d;
+    std::unique_ptr<AstTranslationUnit> tu = ParserDriver::parseTranslationUnit(program, sym, e, d);
+    std::unique_ptr<RamTranslationUnit> ramTu = AstTranslator().translateUnit(*tu);
+    try {
+        Interpreter(*ramTu).executeMain();
+    } catch (const ResourceLimitExceeded& exceeded) {
+        return exceeded.what();
+    }
+    return "";
+}
+
+TEST(ResourceLimits, Parse) {
+    ResourceLimits limits;
+    EXPECT_FALSE(limits.isEnabled());
+
+    // relations of components are named by '-' in RAM
+    limits.setTupleLimits("100,a.b=5,c=7");
+    EXPECT_TRUE(limits.isEnabled());
+    EXPECT_EQ((size_t)100, limits.getTupleLimit("d"));
+    EXPECT_EQ((size_t)5, limits.getTupleLimit("a-b"));
+    EXPECT_EQ((size_t)7, limits.getTupleLimit("c"));
+
+    // temporary relations are checked once merged into their relation
+    EXPECT_EQ((size_t)0, limits.getTupleLimit("@new_c"));
+
+    // limits are positive numbers
+    for (const char* spec : {"0", "-1", "a=", "a=x", "1e3", "a=1,b"}) {
+        bool failed = false;
+        try {
+            ResourceLimits().setTupleLimits(spec);
+        } catch (std::invalid_argument&) {
+            failed = true;
+        }
+        EXPECT_TRUE(failed);
+    }
+    for (const char* spec : {"", "0", "1.5"}) {
+        bool failed = false;
+        try {
+            ResourceLimits().setStratumTimeout(spec);
+        } catch (std::invalid_argument&) {
+            failed = true;
+        }
+        EXPECT_TRUE(failed);
+    }
+}
+
+TEST(ResourceLimits, Check) {
+    ResourceLimits limits;
+    limits.setTupleLimits("r=10");
+    limits.setStratumTimeout("1");
+    limits.startStratum(3, {{"r", "r(x) :- a(x)."}, {"@new_r", "r(x) :- r(y), b(x, y)."}, {"s", "s(1)."}});
+    limits.checkSize("r", 10);
+    limits.checkSize("s", 1000);
+    limits.checkTime();
+
+    // only the rules computing the relation are named
+    std::string msg;
+    try {
+        limits.checkSize("r", 11);
+    } catch (const ResourceLimitExceeded& e) {
+        msg = e.what();
+    }
+    EXPECT_EQ("Relation r exceeded its limit of 10 tuples with 11 tuples in rules:\n"
+              "r(x) :- a(x).\nr(x) :- r(y), b(x, y).\n",
+            msg);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    msg.clear();
+    try {
+        limits.checkTime();
+    } catch (const ResourceLimitExceeded& e) {
+        msg = e.what();
+    }
+    EXPECT_EQ("Stratum 3 exceeded its limit of 1 seconds in rules:\nr(x) :- a(x).\n"
+              "r(x) :- r(y), b(x, y).\ns(1).\n",
+            msg);
+}
+
+TEST(ResourceLimits, Interpreter) {
+    std::string facts;
+    for (int i = 0; i < 600; i++) {
+        facts += "n(" + std::to_string(i) + ").\n";
+    }
+
+    // exceeded limits are passed on to the caller, rather than exiting
+    const std::string recursive = ".decl n(x:number)\n" + facts + R"(
+            .decl chain(x:number, y:number)
+            chain(x, x + 1) :- n(x).
+            .decl path(x:number, y:number)
+            path(x, y) :- chain(x, y).
+            path(x, z) :- path(x, y), chain(y, z).
+        )";
+    EXPECT_EQ("", interpret(recursive, "path=1000000", ""));
+    std::string msg = interpret(recursive, "path=1000", "");
+    EXPECT_EQ((size_t)0, msg.find("Relation path exceeded its limit of 1000 tuples"));
+
+    // the time of strata without fixpoint loops is limited as well
+    const std::string slow = ".decl n(x:number)\n" + facts + R"(
+            .decl none(x:number)
+            none(x) :- n(x), n(y), n(z), x + y + z < 0.
+        )";
+    msg = interpret(slow, "", "1");
+    EXPECT_EQ((size_t)0, msg.find("Stratum"));
+    EXPECT_NE(std::string::npos, msg.find("none(x) :-"));
+}
+
+}  // end namespace test
+}  // end namespace souffle
@@ -0,0 +1,180 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file sqlite_stream_test.cpp
+ *
+ * Test cases for reading and writing relations in SQLite databases.
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#ifdef USE_SQLITE
+
+#include "IODirectives.h"
+#include "ReadStreamSQLite.h"
+#include "SymbolMask.h"
+#include "SymbolTable.h"
+#include "WriteStreamSQLite.h"
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace souffle {
+
+namespace test {
+
+/** A relation collecting the tuples read, in the order of reading */
+struct TupleList {
+    size_t arity;
+    std::vector<std::vector<RamDomain>> tuples;
+
+    TupleList(size_t arity) : arity(arity) {}
+
+    void insert(const RamDomain* tuple) {
+        tuples.push_back(std::vector<RamDomain>(tuple, tuple + arity));
+    }
+};
+
+/** A database file, removed at the end of the test */
+class TempDatabase {
+    std::string name;
+
+public:
+    TempDatabase() {
+        char pattern[] = "/tmp/souffle_db_XXXXXX";
+        close(mkstemp(pattern));
+        name = pattern;
+    }
+
+    ~TempDatabase() {
+        std::remove(name.c_str());
+    }
+
+    /** Get the IO directives of a relation stored in the database */
+    IODirectives getDirectives(const std::string& relation, const std::string& batchSize = "") const {
+        std::map<std::string, std::string> directives = {
+                {"IO", "sqlite"}, {"dbname", name}, {"name", relation}};
+        if (!batchSize.empty()) {
+            directives["batchsize"] = batchSize;
+        }
+        return IODirectives(directives);
+    }
+};
+
+/** Write tuples to a relation of a database */
+void writeTuples(const IODirectives& directives, const SymbolMask& mask, const SymbolTable& symbolTable,
+        const std::vector<std::vector<RamDomain>>& tuples) {
+    std::vector<const RamDomain*> relation;
+    for (const auto& tuple : tuples) {
+        relation.push_back(tuple.data());
+    }
+    WriteSQLiteFactory().getWriter(mask, symbolTable, directives, false)->writeAll(relation);
+}
+
+/** Check whether tuples read from a database match the tuples written, comparing symbols by their text */
+bool sameTuples(const SymbolMask& mask, const std::vector<std::vector<RamDomain>>& written,
+        const SymbolTable& writtenSymbols, const TupleList& read, const SymbolTable& readSymbols) {
+    if (written.size() != read.tuples.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < written.size(); i++) {
+        for (size_t j = 0; j < mask.getArity(); j++) {
+            if (mask.isSymbol(j) ? writtenSymbols.resolve(written[i][j]) !=
+                                           readSymbols.resolve(read.tuples[i][j])
+                                 : written[i][j] != read.tuples[i][j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST(SQLiteStream, RoundTrip) {
+    TempDatabase db;
+    SymbolMask mask({false, true, true});
+    SymbolTable symbols;
+
+    // more tuples and symbols than fit into a single multi-row insert and transaction
+    std::vector<std::vector<RamDomain>> tuples;
+    for (RamDomain i = 0; i < 1000; i++) {
+        tuples.push_back({i - 500, symbols.lookup("a" + std::to_string(i % 300)),
+                symbols.lookup("b" + std::to_string(i % 7))});
+    }
+    writeTuples(db.getDirectives("rel", "100"), mask, symbols, tuples);
+
+    SymbolTable readSymbols;
+    TupleList read(3);
+    ReadSQLiteFactory().getReader(mask, readSymbols, db.getDirectives("rel"), false)->readAll(read);
+    EXPECT_TRUE(sameTuples(mask, tuples, symbols, read, readSymbols));
+    EXPECT_EQ(307, readSymbols.size());
+}
+
+TEST(SQLiteStream, SharedSymbols) {
+    TempDatabase db;
+    SymbolMask mask({true});
+    SymbolTable symbols;
+
+    // the second relation reuses some symbols stored by the first one
+    std::vector<std::vector<RamDomain>> first;
+    std::vector<std::vector<RamDomain>> second;
+    for (RamDomain i = 0; i < 100; i++) {
+        first.push_back({symbols.lookup("s" + std::to_string(i))});
+        second.push_back({symbols.lookup("s" + std::to_string(i + 50))});
+    }
+    writeTuples(db.getDirectives("first"), mask, symbols, first);
+    writeTuples(db.getDirectives("second"), mask, symbols, second);
+
+    SymbolTable readSymbols;
+    TupleList readFirst(1);
+    TupleList readSecond(1);
+    ReadSQLiteFactory().getReader(mask, readSymbols, db.getDirectives("first"), false)->readAll(readFirst);
+    ReadSQLiteFactory().getReader(mask, readSymbols, db.getDirectives("second"), false)->readAll(readSecond);
+    EXPECT_TRUE(sameTuples(mask, first, symbols, readFirst, readSymbols));
+    EXPECT_TRUE(sameTuples(mask, second, symbols, readSecond, readSymbols));
+    EXPECT_EQ(150, readSymbols.size());
+}
+
+TEST(SQLiteStream, Errors) {
+    TempDatabase db;
+    SymbolMask mask({false});
+    SymbolTable symbols;
+
+    // invalid pragmas are reported without opening the database
+    std::map<std::string, std::string> directives = {
+            {"IO", "sqlite"}, {"dbname", "/tmp/souffle_db_unused"}, {"name", "rel"}, {"journal", "bogus"}};
+    bool failed = false;
+    try {
+        WriteSQLiteFactory().getWriter(mask, symbols, IODirectives(directives), false);
+    } catch (std::invalid_argument&) {
+        failed = true;
+    }
+    EXPECT_TRUE(failed);
+    EXPECT_FALSE(access("/tmp/souffle_db_unused", F_OK) == 0);
+
+    // reading a relation missing from the database fails
+    failed = false;
+    try {
+        TupleList read(1);
+        ReadSQLiteFactory().getReader(mask, symbols, db.getDirectives("missing"), false)->readAll(read);
+    } catch (std::invalid_argument&) {
+        failed = true;
+    }
+    EXPECT_TRUE(failed);
+}
+
+}  // end namespace test
+}  // end namespace souffle
+
+#endif  // USE_SQLITE
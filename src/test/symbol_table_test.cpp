@@ -17,6 +17,8 @@
 #include "AstProgram.h"
 #include "test.h"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 
 using namespace souffle;
@@ -140,4 +142,70 @@ TEST(SymbolTable, Inserts) {
     if (ECHO_TIME) std::cout << "Time to insert " << N << " new elements: " << n << " ns" << std::endl;
 }
 
+TEST(SymbolTable, Batch) {
+    SymbolTable table;
+    table.insert("b");
+
+    // new symbols obtain indices in the order of the batch, known symbols keep theirs
+    std::vector<std::string> symbols = {"x", "a", "b", "x", "c"};
+    std::vector<RamDomain> indices(symbols.size());
+    table.lookup(symbols.data(), symbols.size(), indices.data());
+    EXPECT_EQ(1, indices[0]);
+    EXPECT_EQ(2, indices[1]);
+    EXPECT_EQ(0, indices[2]);
+    EXPECT_EQ(1, indices[3]);
+    EXPECT_EQ(3, indices[4]);
+    EXPECT_EQ(4, table.size());
+}
+
+TEST(SymbolTable, Parallel) {
+    const size_t N = 100000;
+    SymbolTable table;
+    std::vector<RamDomain> index(N);
+
+    // insert overlapping sets of symbols from several threads
+#pragma omp parallel for
+    for (size_t i = 0; i < 4 * N; ++i) {
+        RamDomain cur = table.lookup(std::to_string(i % N) + "string");
+        if (i < N) {
+            index[i] = cur;
+        }
+    }
+    EXPECT_EQ(N, table.size());
+
+    // resolve while other threads keep inserting new symbols
+    std::vector<char> resolved(N, 0);
+#pragma omp parallel for
+    for (size_t i = 0; i < 2 * N; ++i) {
+        if (i % 2 == 0) {
+            resolved[i / 2] = (table.resolve(index[i / 2]) == std::to_string(i / 2) + "string");
+        } else {
+            table.insert(std::to_string(i) + "other");
+        }
+    }
+    EXPECT_EQ(2 * N, table.size());
+    EXPECT_EQ(N, static_cast<size_t>(std::count(resolved.begin(), resolved.end(), 1)));
+
+    for (size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(index[i], table.lookup(std::to_string(i) + "string"));
+    }
+
+    // copies taken while other threads keep inserting hold all symbols stored before at their indices
+    std::atomic<size_t> mismatches(0);
+#pragma omp parallel for
+    for (size_t i = 0; i < N; ++i) {
+        if (i % 10000 == 0) {
+            SymbolTable copy(table);
+            for (size_t j = 0; j < N; ++j) {
+                if (copy.resolve(index[j]) != std::to_string(j) + "string") {
+                    ++mismatches;
+                }
+            }
+        } else {
+            table.insert(std::to_string(i) + "copied");
+        }
+    }
+    EXPECT_EQ(0, mismatches.load());
+}
+
 }  // end namespace test
@@ -328,14 +328,21 @@ TEST(SparseArray, MemoryUsage) {
         a.update(12, 15);
         EXPECT_FALSE(a.empty());
         // EXPECT_EQ(56, a.getMemoryUsage());
-        EXPECT_EQ(560, a.getMemoryUsage());
+        EXPECT_EQ(96, a.getMemoryUsage());
 
         // more than one => there are nodes
         a.update(14, 18);
         EXPECT_FALSE(a.empty());
 
         // EXPECT_EQ(576, a.getMemoryUsage());
-        EXPECT_EQ(560, a.getMemoryUsage());
+        EXPECT_EQ(96, a.getMemoryUsage());
+
+        // the compact cells of a node are exhausted => all cells are allocated
+        a.update(16, 1);
+        a.update(18, 1);
+        EXPECT_EQ(96, a.getMemoryUsage());
+        a.update(20, 1);
+        EXPECT_EQ(608, a.getMemoryUsage());
     } else {
         SparseArray<int> a;
 
@@ -346,15 +353,36 @@ TEST(SparseArray, MemoryUsage) {
         // a single element should have the same size as an empty one
         a.update(12, 15);
         EXPECT_FALSE(a.empty());
-        EXPECT_EQ(288, a.getMemoryUsage());
+        EXPECT_EQ(56, a.getMemoryUsage());
 
         // more than one => there are nodes
         a.update(14, 18);
         EXPECT_FALSE(a.empty());
-        EXPECT_EQ(288, a.getMemoryUsage());
+        EXPECT_EQ(56, a.getMemoryUsage());
     }
 }
 
+TEST(SparseArray, Parallel) {
+    const int N = 10000;
+    const int R = 4;
+
+    // concurrently claim cells of nodes, such that compact cells are exhausted concurrently
+    SparseArray<int> a;
+#pragma omp parallel for
+    for (int i = 0; i < N * R; i++) {
+        a.getAtomic((i % N) * 3).fetch_add(1);
+    }
+
+    // each value has been incremented once per round
+    size_t count = 0;
+    for (const auto& cur : a) {
+        EXPECT_EQ(count * 3, cur.first);
+        EXPECT_EQ(R, cur.second);
+        count++;
+    }
+    EXPECT_EQ((size_t)N, count);
+}
+
 TEST(SparseBitMap, Basic) {
     SparseBitMap<> map;
 
@@ -0,0 +1,192 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file union_find_test.cpp
+ *
+ * A test case testing the disjoint sets of the union-find data structure
+ *
+ ***********************************************************************/
+
+#include "test.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "UnionFind.h"
+
+namespace souffle {
+namespace test {
+
+TEST(DjTest, Basic) {
+    DisjointSet ds;
+    for (parent_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(i, DisjointSet::b2p(ds.makeNode()));
+    }
+    EXPECT_EQ(10, ds.size());
+
+    ds.unionNodes(0, 1);
+    ds.unionNodes(2, 3);
+    ds.unionNodes(1, 3);
+    EXPECT_TRUE(ds.sameSet(0, 2));
+    EXPECT_FALSE(ds.sameSet(0, 4));
+    EXPECT_EQ(ds.findNode(0), ds.findNode(3));
+    EXPECT_EQ(ds.readOnlyFindNode(1), ds.findNode(2));
+    EXPECT_EQ(4, ds.numInSet(ds.findNode(0)));
+    EXPECT_EQ(1, ds.numInSet(ds.findNode(4)));
+
+    ds.clear();
+    EXPECT_EQ(0, ds.size());
+}
+
+TEST(DjTest, LongPaths) {
+    // more nodes than fit into the first block
+    const parent_t N = 100000;
+    DisjointSet ds;
+    for (parent_t i = 0; i < N; ++i) {
+        ds.makeNode();
+    }
+
+    // union trees of increasing rank
+    for (parent_t step = 1; step < N; step *= 2) {
+        for (parent_t i = 0; i + step < N; i += 2 * step) {
+            ds.unionNodes(i, i + step);
+        }
+    }
+
+    const parent_t rep = ds.readOnlyFindNode(0);
+    for (parent_t i = 0; i < N; ++i) {
+        EXPECT_EQ(rep, ds.findNode(i));
+    }
+    EXPECT_EQ(N, ds.numInSet(rep));
+
+    // copies contain the same sets
+    DisjointSet copy;
+    copy = ds;
+    EXPECT_EQ(N, copy.size());
+    EXPECT_EQ(N, copy.numInSet(copy.findNode(N - 1)));
+}
+
+TEST(SparseDjTest, Basic) {
+    SparseDisjointSet<RamDomain> sds;
+    EXPECT_FALSE(sds.nodeExists(-5));
+
+    sds.unionNodes(-5, 1000000);
+    sds.unionNodes(7, 1000000);
+    sds.makeNode(42);
+    EXPECT_EQ(4, sds.size());
+    EXPECT_TRUE(sds.nodeExists(-5));
+    EXPECT_TRUE(sds.contains(7, -5));
+    EXPECT_FALSE(sds.contains(7, 42));
+    EXPECT_FALSE(sds.contains(7, 43));
+    EXPECT_EQ(3, sds.sizeOfRepresentativeSet(1000000));
+
+    std::vector<RamDomain> members;
+    RamDomain rep = sds.findNode(7);
+    for (auto it = sds.begin(rep); it != sds.end(rep); ++it) {
+        members.push_back(*it);
+    }
+    std::sort(members.begin(), members.end());
+    EXPECT_EQ(std::vector<RamDomain>({-5, 7, 1000000}), members);
+
+    SparseDisjointSet<RamDomain> copy;
+    copy = sds;
+    sds.clear();
+    EXPECT_EQ(0, sds.size());
+    EXPECT_FALSE(sds.nodeExists(7));
+    EXPECT_TRUE(copy.contains(7, -5));
+    EXPECT_EQ(42, copy.findNode(42));
+}
+
+TEST(SparseDjTest, UnionAll) {
+    const RamDomain N = 10000;
+    std::vector<std::pair<RamDomain, RamDomain>> pairs;
+    for (RamDomain i = 0; i < N; ++i) {
+        // two sets, one of the even and one of the odd values
+        pairs.push_back(std::make_pair(i * 7, (i + 2) * 7));
+    }
+    std::random_shuffle(pairs.begin(), pairs.end());
+
+    SparseDisjointSet<RamDomain> sds;
+    sds.unionAll(pairs);
+    EXPECT_EQ((size_t)N + 2, sds.size());
+    EXPECT_EQ((size_t)N / 2 + 1, sds.sizeOfRepresentativeSet(0));
+    EXPECT_EQ((size_t)N / 2 + 1, sds.sizeOfRepresentativeSet(7));
+    EXPECT_TRUE(sds.contains(0, N * 7));
+    EXPECT_FALSE(sds.contains(0, 7));
+}
+
+TEST(SparseDjTest, ParallelInsert) {
+    // create and union values from several threads
+    const RamDomain N = 10000;
+    SparseDisjointSet<RamDomain> sds;
+    std::vector<std::thread> threads;
+    for (RamDomain t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            for (RamDomain i = t; i < N; i += 4) {
+                sds.unionNodes(i, i + 4);
+            }
+        }));
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ((size_t)N + 4, sds.size());
+    for (RamDomain i = 0; i < N + 4; ++i) {
+        EXPECT_TRUE(sds.contains(i % 4, i));
+    }
+    EXPECT_FALSE(sds.contains(0, 1));
+}
+
+#ifdef _OPENMP
+TEST(SparseDjTest, UnionScaling) {
+    // a benchmark comparing sequential unions against batched unions
+    // const RamDomain N = 1 << 24;     // real benchmark
+    const RamDomain N = 1 << 17;  // to not run to long for unit testing
+
+    std::vector<std::pair<RamDomain, RamDomain>> pairs;
+    for (RamDomain i = 0; i < N; ++i) {
+        // sparse values, forming a few large sets
+        pairs.push_back(std::make_pair(i * 1009, (i + 64) * 1009));
+    }
+    std::random_shuffle(pairs.begin(), pairs.end());
+
+    {
+        SparseDisjointSet<RamDomain> sds;
+        double start = omp_get_wtime();
+        for (const auto& pair : pairs) {
+            sds.unionNodes(pair.first, pair.second);
+        }
+        double end = omp_get_wtime();
+        std::cout << "Sequential unions: [" << (end - start) << "s]\n";
+        EXPECT_EQ((size_t)N / 64 + 1, sds.sizeOfRepresentativeSet(0));
+    }
+
+    {
+        // batches are unioned by as many threads as parallel regions of the program get
+        SparseDisjointSet<RamDomain> sds;
+        double start = omp_get_wtime();
+        sds.unionAll(pairs);
+        double end = omp_get_wtime();
+        std::cout << "Batched unions with " << getTaskThreads() << " threads: [" << (end - start) << "s]\n";
+
+        EXPECT_EQ((size_t)N + 64, sds.size());
+        EXPECT_EQ((size_t)N / 64 + 1, sds.sizeOfRepresentativeSet(0));
+        EXPECT_TRUE(sds.contains(0, (N - 64) * 1009));
+    }
+}
+#endif
+}  // namespace test
+}  // namespace souffle
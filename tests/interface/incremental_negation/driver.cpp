@@ -0,0 +1,83 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for re-evaluating a Souffle program with negation, which
+ * cannot be evaluated incrementally, after loading its inputs from files
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <string>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Print the nodes of a relation in a single line
+ */
+void printNodes(SouffleProgram* prog, const std::string& name) {
+    if (Relation* rel = prog->getRelation(name)) {
+        std::cout << name << ":";
+        for (auto& output : *rel) {
+            std::string node;
+            output >> node;
+            std::cout << " " << node;
+        }
+        std::cout << "\n";
+    } else {
+        error("cannot find relation " + name);
+    }
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        error("no fact directory specified");
+    }
+
+    // create an instance of program "incremental_negation"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("incremental_negation")) {
+        Relation* edge = prog->getRelation("edge");
+        if (edge == nullptr) {
+            error("cannot find relation edge");
+        }
+
+        // evaluate the program from the fact files
+        prog->runAll(argv[1]);
+        printNodes(prog, "reach");
+        printNodes(prog, "unreached");
+
+        // re-evaluate the program with a further edge, keeping the loaded input tuples
+        tuple t(edge);
+        t << "B"
+          << "C";
+        edge->insert(t);
+        prog->runIncremental();
+        std::cout << "--\n";
+        printNodes(prog, "reach");
+        printNodes(prog, "unreached");
+
+        // free program analysis
+        delete prog;
+    } else {
+        error("cannot find program incremental_negation");
+    }
+}
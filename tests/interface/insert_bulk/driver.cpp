@@ -0,0 +1,100 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for inserting and reading tuples of a Souffle program
+ * in batches using the OO-interface
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char** argv) {
+    // create an instance of program "insert_bulk"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("insert_bulk")) {
+        // get input relation "edge"
+        if (Relation* edge = prog->getRelation("edge")) {
+            // encode the nodes of the edges at once
+            std::vector<std::string> nodes = {"A", "B", "C", "D", "E", "F"};
+            std::vector<RamDomain> ids(nodes.size());
+            edge->encodeSymbols(nodes, ids.data());
+
+            // insert the first edges row by row
+            std::vector<RamDomain> rows = {ids[0], ids[1], ids[1], ids[2], ids[2], ids[3]};
+            edge->insertRows(rows.data(), 3);
+
+            // insert the remaining edges column by column
+            std::vector<RamDomain> sources = {ids[3], ids[4], ids[5]};
+            std::vector<RamDomain> targets = {ids[4], ids[5], ids[0]};
+            const RamDomain* columns[] = {sources.data(), targets.data()};
+            edge->insertColumns(columns, 3);
+
+            // run program
+            prog->run();
+
+            // get output relation "path"
+            if (Relation* path = prog->getRelation("path")) {
+                // export all tuples of the relation
+                std::vector<RamDomain> result(path->size() * 2);
+                size_t count = path->exportRows(result.data());
+                std::vector<std::string> output;
+                for (size_t i = 0; i < count; i++) {
+                    output.push_back(path->getSymbolTable().resolve(result[2 * i]) + "-" +
+                                     path->getSymbolTable().resolve(result[2 * i + 1]));
+                }
+
+                // read the same tuples through the partitions of the relation
+                size_t numRead = 0;
+                for (auto& part : path->getPartitions(4)) {
+                    RamDomain buffer[2 * 5];
+                    while (size_t num = part->readRows(buffer, 5)) {
+                        numRead += num;
+                    }
+                }
+                if (numRead != count) {
+                    error("partitions of relation path are incomplete");
+                }
+
+                // print source and destination node
+                std::sort(output.begin(), output.end());
+                for (const auto& cur : output) {
+                    std::cout << cur << "\n";
+                }
+            } else {
+                error("cannot find relation path");
+            }
+
+            // free program analysis
+            delete prog;
+
+        } else {
+            error("cannot find relation edge");
+        }
+    } else {
+        error("cannot find program insert_bulk");
+    }
+}
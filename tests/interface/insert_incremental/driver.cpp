@@ -0,0 +1,99 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for evaluating a Souffle program incrementally using
+ * the OO-interface
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Insert edges into relation "edge"
+ */
+void insertEdges(Relation* edge, const std::vector<std::array<std::string, 2>>& edges) {
+    for (auto input : edges) {
+        tuple t(edge);
+        t << input[0] << input[1];
+        edge->insert(t);
+    }
+}
+
+/**
+ * Print the output relations "path" and "reach"
+ */
+void printOutputs(SouffleProgram* prog) {
+    if (Relation* path = prog->getRelation("path")) {
+        for (auto& output : *path) {
+            std::string src, dest;
+            output >> src >> dest;
+            std::cout << src << "-" << dest << "\n";
+        }
+    } else {
+        error("cannot find relation path");
+    }
+    if (Relation* reach = prog->getRelation("reach")) {
+        for (auto& output : *reach) {
+            std::string node;
+            output >> node;
+            std::cout << node << "\n";
+        }
+    } else {
+        error("cannot find relation reach");
+    }
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char** argv) {
+    // create an instance of program "insert_incremental"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("insert_incremental")) {
+        Relation* edge = prog->getRelation("edge");
+        Relation* start = prog->getRelation("start");
+        if (edge == nullptr || start == nullptr) {
+            error("cannot find input relations");
+        }
+
+        // evaluate the program from scratch
+        insertEdges(edge, {{"A", "B"}, {"B", "C"}});
+        tuple t(start);
+        t << "A";
+        start->insert(t);
+        prog->run();
+        printOutputs(prog);
+
+        // propagate further edges through the existing relations
+        insertEdges(edge, {{"C", "D"}, {"D", "A"}, {"E", "F"}});
+        prog->runIncremental();
+        std::cout << "--\n";
+        printOutputs(prog);
+
+        // free program analysis
+        delete prog;
+    } else {
+        error("cannot find program insert_incremental");
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for restoring relations of numbers and records, which
+ * span several blocks of a snapshot, into another instance of the program
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Export the tuples of a relation in sorted order
+ */
+std::vector<RamDomain> exportSorted(Relation* rel) {
+    const size_t arity = rel->getArity();
+    std::vector<RamDomain> rows(rel->size() * arity);
+    const size_t count = rel->exportRows(rows.data());
+    std::vector<std::vector<RamDomain>> tuples;
+    for (size_t i = 0; i < count; i++) {
+        tuples.emplace_back(rows.begin() + i * arity, rows.begin() + (i + 1) * arity);
+    }
+    std::sort(tuples.begin(), tuples.end());
+    std::vector<RamDomain> res;
+    for (const auto& cur : tuples) {
+        res.insert(res.end(), cur.begin(), cur.end());
+    }
+    return res;
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char** argv) {
+    // create an instance of program "snapshot_numbers"
+    SouffleProgram* prog = ProgramFactory::newInstance("snapshot_numbers");
+    if (prog == nullptr) {
+        error("cannot find program snapshot_numbers");
+    }
+
+    // load more tuples into relation "value" than fit into a single block of a snapshot
+    Relation* value = prog->getRelation("value");
+    if (value == nullptr) {
+        error("cannot find relation value");
+    }
+    std::vector<RamDomain> rows;
+    for (RamDomain i = 0; i < 10000; i++) {
+        rows.push_back(i);
+        rows.push_back(i % 7 - 3);
+    }
+    value->insertRows(rows.data(), 10000);
+
+    // run program and save its state
+    prog->run();
+    prog->snapshot("snapshot_numbers.img");
+
+    // restore the state into a new instance without running it
+    SouffleProgram* restored = ProgramFactory::newInstance("snapshot_numbers");
+    if (restored == nullptr) {
+        error("cannot find program snapshot_numbers");
+    }
+    restored->restore("snapshot_numbers.img");
+
+    // the restored relations hold the same tuples, including the references of records
+    for (const char* name : {"value", "square", "pair", "total"}) {
+        Relation* rel = prog->getRelation(name);
+        Relation* restoredRel = restored->getRelation(name);
+        if (rel == nullptr || restoredRel == nullptr) {
+            error(std::string("cannot find relation ") + name);
+        }
+        if (exportSorted(rel) != exportSorted(restoredRel)) {
+            error(std::string("relation ") + name + " differs after restoring it");
+        }
+        std::cout << name << " " << restoredRel->size() << "\n";
+    }
+
+    // print the total of the restored instance
+    for (auto& output : *restored->getRelation("total")) {
+        RamDomain n;
+        output >> n;
+        std::cout << "total = " << n << "\n";
+    }
+
+    // free program analysis
+    delete restored;
+    delete prog;
+}
@@ -0,0 +1,86 @@
+/*
+ * Souffle - A Datalog Compiler
+ * Copyright (c) 2018, The Souffle Developers. All rights reserved
+ * Licensed under the Universal Permissive License v 1.0 as shown at:
+ * - https://opensource.org/licenses/UPL
+ * - <souffle root>/licenses/SOUFFLE-UPL.txt
+ */
+
+/************************************************************************
+ *
+ * @file driver.cpp
+ *
+ * Driver program for saving the state of a Souffle program into a
+ * snapshot and restoring it into another instance of the program
+ *
+ ***********************************************************************/
+
+#include "souffle/SouffleInterface.h"
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace souffle;
+
+/**
+ * Error handler
+ */
+void error(std::string txt) {
+    std::cerr << "error: " << txt << "\n";
+    exit(1);
+}
+
+/**
+ * Main program
+ */
+int main(int argc, char** argv) {
+    // create an instance of program "snapshot_restore"
+    if (SouffleProgram* prog = ProgramFactory::newInstance("snapshot_restore")) {
+        // get input relation "edge"
+        if (Relation* edge = prog->getRelation("edge")) {
+            // load data into relation "edge"
+            std::vector<std::array<std::string, 2>> myData = {
+                    {"A", "B"}, {"B", "C"}, {"C", "D"}, {"D", "E"}, {"E", "F"}, {"F", "A"}};
+            for (auto input : myData) {
+                tuple t(edge);
+                t << input[0] << input[1];
+                edge->insert(t);
+            }
+
+            // run program and save its state
+            prog->run();
+            prog->snapshot("snapshot_restore.img");
+            delete prog;
+        } else {
+            error("cannot find relation edge");
+        }
+    } else {
+        error("cannot find program snapshot_restore");
+    }
+
+    // restore the state into a new instance without running it
+    if (SouffleProgram* prog = ProgramFactory::newInstance("snapshot_restore")) {
+        prog->restore("snapshot_restore.img");
+
+        // get output relation "path"
+        if (Relation* path = prog->getRelation("path")) {
+            // iterate over output relation
+            for (auto& output : *path) {
+                std::string src, dest;
+
+                // retrieve elements from tuple
+                output >> src >> dest;
+
+                // print source and destination node
+                std::cout << src << "-" << dest << "\n";
+            }
+        } else {
+            error("cannot find relation path");
+        }
+
+        // free program analysis
+        delete prog;
+    } else {
+        error("cannot find program snapshot_restore");
+    }
+}